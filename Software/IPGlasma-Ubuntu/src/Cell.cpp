@@ -18,6 +18,27 @@ Cell::Cell(int N)
   Uy2 = new Matrix(Nc,1.);
  }
 
+void Cell::reset(const Matrix& one)
+{
+  *g2mu2A = 0.;
+  *g2mu2B = 0.;
+  *TpA = 0.;
+  *TpB = 0.;
+  *U = one;
+  *U2 = one;
+  *Ux = one;
+  *Uy = one;
+  *Ux1 = one;
+  *Uy1 = one;
+  *Ux2 = one;
+  *Uy2 = one;
+  epsilon = 0.;
+  Ttautau = Txx = Tyy = Txy = Tetaeta = Ttaux = Ttauy = Ttaueta = Txeta = Tyeta = 0.;
+  pitautau = pixx = piyy = pixy = pietaeta = pitaux = pitauy = pitaueta = pixeta = piyeta = 0.;
+  utau = 1.;
+  ux = uy = ueta = 0.;
+}
+
 Cell::~Cell()
 {
   delete g2mu2A;
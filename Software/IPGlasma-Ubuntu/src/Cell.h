@@ -71,6 +71,9 @@ public:
   Cell(int N);
   ~Cell();
 
+  // all link matrices to one, all densities, T^{mu nu}, pi^{mu nu} and u^mu to zero
+  void reset(const Matrix& one);
+
   //  void setParity(bool in) { parity = in; };
   //  bool getParity() { return parity; };
 
@@ -0,0 +1,92 @@
+// EventScheduler.cpp is part of the IP-Glasma solver.
+#include "EventScheduler.h"
+
+//**************************************************************************
+// EventScheduler class.
+
+EventScheduler::EventScheduler(int numberOfEvents, int myRank)
+{
+  nEvents = numberOfEvents;
+  rank = myRank;
+  eventsDone = 0;
+  busyTime = 0.;
+  onDemand = (nEvents > 0);
+  ownEventTaken = false;
+
+  if (onDemand)
+    {
+      MPI_Aint windowSize = (rank==0) ? sizeof(int) : 0;
+      MPI_Win_allocate(windowSize, sizeof(int), MPI_INFO_NULL, MPI_COMM_WORLD, &counter, &window);
+      if (rank==0)
+        *counter = 0;
+      MPI_Barrier(MPI_COMM_WORLD);
+    }
+  
+  stringstream strtime_name;
+  strtime_name << "eventTiming" << rank << ".dat";
+  timingName = strtime_name.str();
+  ofstream fout(timingName.c_str(),ios::out);
+  fout << "# event seed attempts initTime[s] evolutionTime[s]" << endl;
+  fout.close();
+
+  startTime = MPI_Wtime();
+}
+
+EventScheduler::~EventScheduler()
+{
+  if (onDemand)
+    MPI_Win_free(&window);
+}
+
+int EventScheduler::next()
+{
+  // one event per rank: this rank's event, then nothing
+  if (!onDemand)
+    {
+      if (ownEventTaken)
+        return -1;
+      ownEventTaken = true;
+      return rank;
+    }
+
+  const int one = 1;
+  int event;
+  MPI_Win_lock(MPI_LOCK_SHARED, 0, 0, window);
+  MPI_Fetch_and_op(&one, &event, MPI_INT, 0, 0, MPI_SUM, window);
+  MPI_Win_unlock(0, window);
+
+  if (event >= nEvents)
+    return -1;
+  return event;
+}
+
+void EventScheduler::record(int event, unsigned long long int seed, int attempts, double initTime, double evolutionTime)
+{
+  eventsDone++;
+  busyTime += initTime + evolutionTime;
+
+  ofstream fout(timingName.c_str(),ios::app);
+  fout << event << " " << seed << " " << attempts << " " << initTime << " " << evolutionTime << endl;
+  fout.close();
+}
+
+void EventScheduler::summary()
+{
+  double wallTime = MPI_Wtime()-startTime;
+  double maxBusy, minBusy, sumBusy, maxWall;
+  int sumEvents;
+  MPI_Reduce(&busyTime, &maxBusy, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+  MPI_Reduce(&busyTime, &minBusy, 1, MPI_DOUBLE, MPI_MIN, 0, MPI_COMM_WORLD);
+  MPI_Reduce(&busyTime, &sumBusy, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+  MPI_Reduce(&wallTime, &maxWall, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+  MPI_Reduce(&eventsDone, &sumEvents, 1, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+
+  if (rank==0)
+    {
+      int size;
+      MPI_Comm_size(MPI_COMM_WORLD, &size);
+      cout << "Ran " << sumEvents << " events on " << size << " ranks in " << maxWall << " s." << endl;
+      cout << "Busy time per rank: min " << minBusy << " s, max " << maxBusy << " s, utilization " 
+           << sumBusy/(size*maxWall) << endl;
+    }
+}
@@ -0,0 +1,52 @@
+// EventScheduler.h is part of the IP-Glasma solver.
+// Hands out event numbers to MPI ranks on demand.
+
+#ifndef EventScheduler_H
+#define EventScheduler_H
+
+#include "mpi.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <string>
+
+using namespace std;
+
+// A shared counter on rank 0 (MPI-3 one-sided atomics). Every rank asks for the next
+// event when it is done with the previous one, so ranks with slow events (large nuclei,
+// failed initializations) do not hold up the others. No rank is reserved as a master.
+// With numberOfEvents<=0 there is no counter and every rank runs exactly the event
+// equal to its rank.
+class EventScheduler {
+
+ private:
+  MPI_Win window;
+  int *counter;
+  int nEvents;
+  int rank;
+  bool onDemand; // false: one event per rank, no shared counter
+  bool ownEventTaken;
+
+  // bookkeeping for the summary
+  int eventsDone;
+  double busyTime;
+  double startTime;
+  string timingName;
+
+ public:
+  EventScheduler(int numberOfEvents, int myRank);
+  ~EventScheduler();
+
+  // next event number, -1 if all events have been handed out
+  int next();
+
+  // per-event timing, written to eventTiming<rank>.dat
+  void record(int event, unsigned long long int seed, int attempts, double initTime, double evolutionTime);
+
+  // collective: prints the load balance on rank 0
+  void summary();
+};
+
+#endif // EventScheduler_H
@@ -165,12 +165,15 @@ void Evolution::evolvePi(Lattice* lat, BufferLattice * bufferlat, Group* group,
   }
 }
 
-void Evolution::evolveE(Lattice* lat, BufferLattice *bufferlat, Group* group, Parameters *param, double dtau, double tau)
+void Evolution::evolveE(Lattice* lat, BufferLattice *bufferlat, Group* group, Parameters *param, double dtau, double tau, double *cellEnergy)
 {
   const int Nc = param->getNc();
   const int N = param->getSize();
   const double g = param->getg();
 
+  // the energy density of each cell is stored here for the moments while all fields of the cell are loaded anyway
+  const bool doMoments = (cellEnergy!=NULL);
+
 #pragma omp parallel
   {
     Matrix Ux(Nc);
@@ -189,12 +192,19 @@ void Evolution::evolveE(Lattice* lat, BufferLattice *bufferlat, Group* group, Pa
     Matrix U2m1(Nc);
     complex<double> trace;
     Matrix one(Nc,1.);
+    double ETsquared = 0.; // Tr(E1^2+E2^2) averaged over tau-dtau/2 and tau+dtau/2
+    double BTsquared = 0.; // Tr((phi - U phi_{+1} U^dag)^2) summed over x and y links
     
 #pragma omp for
     for (int pos=0; pos<N*N; pos++)
       {
         // retrieve current E1 and E2 (that's the one defined at tau-dtau/2)
         En = lat->cells[pos]->getE1();
+        if (doMoments)
+          {
+            ETsquared = 0.5*(Observables::traceSquare(En,Nc)+Observables::traceSquare(lat->cells[pos]->getE2(),Nc));
+            BTsquared = 0.;
+          }
         // retrieve current phi (at time tau) at this x_T
         phi = lat->cells[pos]->getphi();
         // retrieve current phi (at time tau) at x_T+1
@@ -241,6 +251,12 @@ void Evolution::evolveE(Lattice* lat, BufferLattice *bufferlat, Group* group, Pa
         trace = En.trace();
         En -= (trace/static_cast<double>(Nc))*one;
         bufferlat->cells[pos]->setbuffer1(En); 
+        if (doMoments)
+          {
+            ETsquared += 0.5*Observables::traceSquare(En,Nc);
+            temp2 = phi - phiN;
+            BTsquared += Observables::traceSquare(temp2,Nc);
+          }
        
         
         // do E2 update:
@@ -266,6 +282,21 @@ void Evolution::evolveE(Lattice* lat, BufferLattice *bufferlat, Group* group, Pa
         trace = En.trace();
         En -= (trace/static_cast<double>(Nc))*one;
         bufferlat->cells[pos]->setbuffer2(En); 
+
+        if (doMoments)
+          {
+            ETsquared += 0.5*Observables::traceSquare(En,Nc);
+            temp2 = phi - phiN;
+            BTsquared += Observables::traceSquare(temp2,Nc);
+            
+            // T^tautau as in Tmunu (lattice units): E_T, E_L, B_L and B_T parts,
+            // with the running coupling factor as in eccentricity
+            double eps = g*g/tau/tau*ETsquared
+              + Observables::traceSquare(lat->cells[pos]->getpi(),Nc)
+              + 2./g/g*(static_cast<double>(Nc)-U12.trace().real())
+              + BTsquared/tau/tau;
+            cellEnergy[pos] = obs->getGfactor(pos)*eps;
+          }
       }
 
 #pragma omp for
@@ -448,6 +479,9 @@ void Evolution::run(Lattice* lat, BufferLattice* bufferlat, Group* group, Parame
   cout << "Starting evolution" << endl;
   cout << "itmax=" << itmax << endl;
 
+  obs->beginEvent(lat,param);
+  double *cellEnergy = obs->getCellEnergy(); // NULL without writeMoments
+
   // do evolution
   for (int it=1; it<=itmax; it++)
     {
@@ -456,6 +490,7 @@ void Evolution::run(Lattice* lat, BufferLattice* bufferlat, Group* group, Parame
 	{	  
 	  Tmunu(lat,group,param,it);
           u(lat,group,param,it); // computes flow velocity and correct energy density 
+          obs->recordSnapshot(lat,param,it,"snapshots"); // handed to the writer thread
 	}
 
       if(it%10==0)
@@ -464,7 +499,9 @@ void Evolution::run(Lattice* lat, BufferLattice* bufferlat, Group* group, Parame
       if (it<itmax)
 	{
 	  evolvePi(lat, bufferlat, group, param, dtau, (it)*dtau); // the last argument is the current time tau. 
-	  evolveE(lat, bufferlat, group, param, dtau, (it)*dtau);
+	  evolveE(lat, bufferlat, group, param, dtau, (it)*dtau, cellEnergy);
+	  if (cellEnergy)
+	    obs->recordMoments(param, (it)*dtau);
 	  
 	  // evolve from time tau to tau+dtau
 	  evolvePhi(lat, bufferlat, group, param, dtau, (it)*dtau);
@@ -473,7 +510,9 @@ void Evolution::run(Lattice* lat, BufferLattice* bufferlat, Group* group, Parame
       else if(it==itmax)
 	{
 	  evolvePi(lat, bufferlat, group, param, dtau/2., (it)*dtau); // the last argument is the current time tau. 
-	  evolveE(lat, bufferlat, group, param, dtau/2., (it)*dtau);
+	  evolveE(lat, bufferlat, group, param, dtau/2., (it)*dtau, cellEnergy);
+	  if (cellEnergy)
+	    obs->recordMoments(param, (it)*dtau);
   	}
 
       if(it==1 && param->getWriteOutputs() == 3)
@@ -2133,7 +2172,7 @@ int Evolution::multiplicity(Lattice *lat, Group *group, Parameters *param, int i
 
   int itmax = static_cast<int>(floor(maxtime/(a*dtau)+1e-10));
   
-  gaugefix->FFTChi(fft,lat,group,param,4000);
+  gaugefix->FFTChi(lat,group,param,4000);
   // gauge is fixed
   delete gaugefix;
 
@@ -2741,7 +2780,7 @@ int Evolution::multiplicity(Lattice *lat, Group *group, Parameters *param, int i
       gsl_interp_accel_free(ptacc);
     }
   
-  if(param->getUsePseudoRapidity()==0 && param->getMPIRank()==0)
+  if(param->getUsePseudoRapidity()==0 && param->getMPIWorldRank()==0)
     {
       cout << "dN/dy 1 = " << dNdeta << ", dE/dy 1 = " << dEdeta << endl; 
 	  cout << "dN/dy 2 = " << dNdeta2 << ", dE/dy 2 = " << dEdeta2 << endl; 
@@ -2754,7 +2793,7 @@ int Evolution::multiplicity(Lattice *lat, Group *group, Parameters *param, int i
       dNdeta*=cosh(param->getRapidity())/(sqrt(pow(cosh(param->getRapidity()),2.)+m*m/(P*P)));
       dEdeta*=cosh(param->getRapidity())/(sqrt(pow(cosh(param->getRapidity()),2.)+m*m/(P*P)));
       
-      if(param->getMPIRank()==0)
+      if(param->getMPIWorldRank()==0)
 	{
 	  cout << "dN/deta 1 = " << dNdeta << ", dE/deta 1 = " << dEdeta << endl; 
 	  cout << "dN/deta 2 = " << dNdeta2 << ", dE/deta 2 = " << dEdeta2 << endl; 
@@ -2877,7 +2916,7 @@ int Evolution::multiplicitynkxky(Lattice *lat, Group *group, Parameters *param,
 
   int itmax = static_cast<int>(floor(maxtime/(a*dtau)+1e-10));
   
-  gaugefix->FFTChi(fft,lat,group,param,4000);
+  gaugefix->FFTChi(lat,group,param,4000);
   // gauge is fixed
   delete gaugefix;
 
@@ -3520,7 +3559,7 @@ int Evolution::multiplicitynkxky(Lattice *lat, Group *group, Parameters *param,
       gsl_interp_accel_free(ptacc);
     }
   
-  if(param->getUsePseudoRapidity()==0 && param->getMPIRank()==0)
+  if(param->getUsePseudoRapidity()==0 && param->getMPIWorldRank()==0)
     {
       cout << "dN/dy 1 = " << dNdeta << ", dE/dy 1 = " << dEdeta << endl; 
 	  cout << "dN/dy 2 = " << dNdeta2 << ", dE/dy 2 = " << dEdeta2 << endl; 
@@ -3533,7 +3572,7 @@ int Evolution::multiplicitynkxky(Lattice *lat, Group *group, Parameters *param,
       dNdeta*=cosh(param->getRapidity())/(sqrt(pow(cosh(param->getRapidity()),2.)+m*m/(P*P)));
       dEdeta*=cosh(param->getRapidity())/(sqrt(pow(cosh(param->getRapidity()),2.)+m*m/(P*P)));
       
-      if(param->getMPIRank()==0)
+      if(param->getMPIWorldRank()==0)
 	{
 	  cout << "dN/deta 1 = " << dNdeta << ", dE/deta 1 = " << dEdeta << endl; 
 	  cout << "dN/deta 2 = " << dNdeta2 << ", dE/deta 2 = " << dEdeta2 << endl; 
@@ -3669,7 +3708,7 @@ int Evolution::correlations(Lattice *lat, Group *group, Parameters *param, int i
     }
 
   int itmax = static_cast<int>(floor(maxtime/(a*dtau)+1e-10));
-  gaugefix->FFTChi(fft,lat,group,param,4000);
+  gaugefix->FFTChi(lat,group,param,4000);
  
   // gauge is fixed
   Matrix U1(Nc,1.);
@@ -24,6 +24,7 @@
 #include "GaugeFix.h"
 #include "MyEigen.h"
 #include "Fragmentation.h"
+#include "Observables.h"
 #include <gsl/gsl_errno.h>
 #include <gsl/gsl_spline.h>
 #include <gsl/gsl_interp.h>
@@ -36,6 +37,7 @@ class Evolution {
  private:
   FFT *fft;
   Fragmentation  *frag;
+  Observables *obs;
   
   double nIn[100]; //k_T array
 
@@ -47,12 +49,14 @@ class Evolution {
     {
       fft = new FFT(nn);
       frag = new Fragmentation();
+      obs = new Observables();
     };
   
   ~Evolution() 
     { 
       delete fft;
       delete frag;
+      delete obs;
     };
   
   void run(Lattice* lat, BufferLattice* bufferlat, Group* group, Parameters *param);
@@ -60,7 +64,7 @@ class Evolution {
   void evolveUfast(Lattice* lat, Group* group, Parameters *param, double dtau, double tau);
   void evolvePhi(Lattice* lat, BufferLattice *bufferlat, Group* group, Parameters *param, double dtau, double tau);
   void evolvePi(Lattice* lat, BufferLattice * bufferlat, Group* group, Parameters *param, double dtau, double tau);
-  void evolveE(Lattice* lat, BufferLattice *bufferlat, Group* group, Parameters *param, double dtau, double tau);
+  void evolveE(Lattice* lat, BufferLattice *bufferlat, Group* group, Parameters *param, double dtau, double tau, double *cellEnergy=NULL);
   void checkGaussLaw(Lattice* lat, Group* group, Parameters *param, double dtau, double tau);
   void eccentricity(Lattice *lat, Group *group, Parameters *param, int it, double cutoff, int doAniso);
   void Tmunu(Lattice *lat, Group *group, Parameters *param, int it);
@@ -6,202 +6,194 @@
 //**************************************************************************
 // GaugeFix class.
 
-void GaugeFix::FFTChi(FFT* fft, Lattice* lat, Group* group, Parameters *param, int steps)
+// Fourier accelerated Coulomb gauge fixing (C. T. H. Davies et al., Phys. Rev. D 37, 1581 (1988)).
+// The Nc^2-1 color components of the divergence are stored one after the other (component a
+// at chi + a*N*N) so that they are transformed with one batched FFTW plan. The step alpha is
+// reduced whenever the residual grows and slowly restored while it decreases.
+void GaugeFix::FFTChi(Lattice* lat, Group* group, Parameters *param, int steps)
 {
   const int N = param->getSize();
+  const int Nc = param->getNc();
+  const int NcSq = Nc*Nc;
+  const int Nc2m1 = Nc*Nc-1;
+  const int ntot = N*N;
   int nn[2];
   nn[0] = N;
   nn[1] = N;
-  int pos, posX, posY, posmX, posmY;
-  int Nc = param->getNc();
-  int Nc2m1 = Nc*Nc-1;
-  int maxi=0;
-  int maxj=0;
-  
-  Matrix one(Nc,1.);
-  Matrix oldg(Nc), g(Nc), gdag(Nc), temp(Nc);
-  Matrix divA(Nc), divAdag(Nc);
-  Matrix divANew(Nc);
-  double energy=0.;
-  Matrix Uplaq(Nc), U(Nc), UDx(Nc), UDy(Nc), UDxMx(Nc), UDyMy(Nc) , Ux(Nc), Uy(Nc), UxMx(Nc), UyMy(Nc);
-  Matrix UmxDag(Nc), UmyDag(Nc);
-  double tr;
-
-  int max_gfiter = steps;
-  double maxres = 0.;
-  
-  Matrix zero(Nc,0.);
+
+  const double tolerance = param->getGaugeFixTolerance();
+  const double alphaMax = 1.5;   // the fixed step used previously
+  const double alphaMin = 0.05;
+  double alpha = alphaMax;
   double gresidual = 10000.;
-  
-  Matrix **chi;
-  chi = new Matrix*[N*N];
-  
-  for(int i=0; i<N*N; i++)
-    {
-      chi[i] = new Matrix(Nc,0.);
-    }
-  
-  
+  double lastResidual = 1e100;
+  Matrix one(Nc,1.);
+
+  // generators as plain arrays: tr(M t^a) = sum_ij M_ij (t^a)_ji
+  vector<complex<double> > t(Nc2m1*NcSq);
+  for (int ig=0; ig<Nc2m1; ig++)
+    for (int k=0; k<NcSq; k++)
+      t[ig*NcSq+k] = group->getT(ig).get(k);
+  // tr(t^a t^b) = norm delta^ab
+  const double norm = (group->getT(0)*group->getT(0)).trace().real();
+
+  fftw_complex *chi = (fftw_complex*) fftw_malloc(sizeof(fftw_complex)*Nc2m1*ntot);
+  fftw_plan forward = fftw_plan_many_dft(2, nn, Nc2m1, chi, NULL, 1, ntot, chi, NULL, 1, ntot, FFTW_FORWARD, FFTW_ESTIMATE);
+  fftw_plan backward = fftw_plan_many_dft(2, nn, Nc2m1, chi, NULL, 1, ntot, chi, NULL, 1, ntot, FFTW_BACKWARD, FFTW_ESTIMATE);
+
+  // 1/k^2 with the lattice momentum k^2 = 4 (sin^2(pi i/N) + sin^2(pi j/N)), including the FFT normalization
+  vector<double> invk2(ntot);
+  for (int i=0; i<N; i++)
+    for (int j=0; j<N; j++)
+      {
+	double kx = sin(param->getPi()*static_cast<double>(i)/static_cast<double>(N));
+	double ky = sin(param->getPi()*static_cast<double>(j)/static_cast<double>(N));
+	double kt2 = 4.*(kx*kx+ky*ky); //lattice momentum squared
+	// the zero mode of the divergence vanishes on the periodic lattice
+	invk2[i*N+j] = (i==0 && j==0) ? 0. : 1./kt2/static_cast<double>(ntot);
+      }
+
   cout << "gauge fixing" << endl;
   
-  for (int gfiter=0; gfiter<max_gfiter; gfiter++)
+  for (int gfiter=0; gfiter<steps; gfiter++)
     {
       gresidual = 0.;
-      maxres = 0.;
-      energy=0.;
-      for(int i=0; i<N; i++)
+
+      // color components of the divergence of the gauge field and the residual
+#pragma omp parallel for reduction(+:gresidual)
+      for(int pos=0; pos<ntot; pos++)
 	{
-	  for(int j=0; j<N; j++)
+	  int i = pos/N;
+	  int j = pos%N;
+	  int posmX = (i>0) ? pos-N : (N-1)*N+j;
+	  int posmY = (j>0) ? pos-1 : i*N+N-1;
+
+	  Matrix &Ux = lat->cells[pos]->getUx();
+	  Matrix &Uy = lat->cells[pos]->getUy();
+	  Matrix &UxMx = lat->cells[posmX]->getUx();
+	  Matrix &UyMy = lat->cells[posmY]->getUy();
+
+	  complex<double> divA[NcSq];
+	  for (int k=0; k<NcSq; k++)
+	    divA[k] = Ux.get(k)-UxMx.get(k)+Uy.get(k)-UyMy.get(k);
+
+	  for (int ig=0; ig<Nc2m1; ig++)
 	    {
-	      pos = i*N+j;
-	      if(i>0)
-		posmX = (i-1)*N+j;
-	      else
-		posmX = (N-1)*N+j;
-	      if(j>0)
-		posmY = i*N+(j-1);
-	      else
-		posmY = i*N+(N-1);
-	      
-	      if(i<N-1)
-		posX = (i+1)*N+j;
-	      else
-		posX = j;
-	      if(j<N-1)
-		posY = i*N+(j+1);
-	      else
-		posY = i*N;
-	      
-	      Ux = UDx = lat->cells[pos]->getUx();
-	      Uy = UDy = lat->cells[pos]->getUy();
-	      UxMx = UDxMx = lat->cells[posmX]->getUx();
-	      UyMy = UDyMy = lat->cells[posmY]->getUy();
-	      UDx.conjg();
-	      UDy.conjg();
-	      UDxMx.conjg();
-	      UDyMy.conjg();
-	   
-	      divA = (Ux-UxMx+Uy-UyMy);
-
-	      g=zero;
-	      for (int ig=0; ig<Nc2m1; ig++)
-		{
-		  g = g + ((divA)*group->getT(ig)).trace().imag()*group->getT(ig);
-		}
-
-	      *chi[pos]=gdag=g;
-	      gdag.conjg();
-	      
-	      gresidual += ((gdag*g).trace()).real()/static_cast<double>(Nc);
-	      
-	    } // i loop
-	} // j loop
+	      complex<double> tr = 0.;
+	      for (int a=0; a<Nc; a++)
+		for (int b=0; b<Nc; b++)
+		  tr += divA[a*Nc+b]*t[ig*NcSq+b*Nc+a];
+	      chi[ig*ntot+pos][0] = tr.imag();
+	      chi[ig*ntot+pos][1] = 0.;
+	      gresidual += norm*tr.imag()*tr.imag()/static_cast<double>(Nc);
+	    }
+	}
       
-      gresidual /= N*N;
+      gresidual /= ntot;
       
       if(gfiter%10==0)
 	{
-	  cout << gfiter << " " << gresidual << endl;
+	  cout << gfiter << " " << gresidual << " " << alpha << endl;
 	}
 	
-      if (gresidual<1e-9)
+      if (gresidual<tolerance)
 	{
 	  break;
 	}    
 
-      fft->fftn(chi,chi,nn,2,1);
+      if (gresidual>lastResidual)
+	alpha = max(alphaMin, 0.5*alpha);
+      else
+	alpha = min(alphaMax, 1.1*alpha);
+      lastResidual = gresidual;
+
+      fftw_execute(forward);
    
 #pragma omp parallel for
-        for (int i=0; i<N; i++)
-        {
-          for (int j=0; j<N; j++)
-            {
-              double kx, ky, kt2;
-              int localpos = i*N+j;
-              kx = sin(param->getPi()*(-0.5+static_cast<double>(i)/static_cast<double>(N)));
-              ky = sin(param->getPi()*(-0.5+static_cast<double>(j)/static_cast<double>(N)));
-              kt2 = 4.*(kx*kx+ky*ky); //lattice momentum squared
-              *chi[localpos] = -1.5 * (1./(kt2+1e-9))*(*chi[localpos]); 
-            }
-        }        
+      for (int pos=0; pos<ntot; pos++)
+	{
+	  for (int ig=0; ig<Nc2m1; ig++)
+	    {
+	      chi[ig*ntot+pos][0] *= -alpha*invk2[pos];
+	      chi[ig*ntot+pos][1] *= -alpha*invk2[pos];
+	    }
+	}        
         
-        fft->fftn(chi,chi,nn,2,-1);
+      fftw_execute(backward);
    
 #pragma omp parallel 
-        {
-          Matrix localg(Nc);
+      {
+	Matrix localg(Nc);
 #pragma omp for 
-          for (int i=0; i<N; i++)
-            {
-	  for (int j=0; j<N; j++)
-	    {
-          int localpos = i*N+j;
-          // exponentiate
-              localg = complex<double>(0,1.)*(*chi[localpos]);
-	      localg.expm();
-	      // reunitarize
-	      localg.reu();
-
-	      if(localg(2)!=localg(2))
-		{
-		  cout << "problem at " << i << " " << j << " with g=" << localg << endl; 
-		  localg = one;
-		}
-	      
-	      lat->cells[localpos]->setg(localg);
+	for (int pos=0; pos<ntot; pos++)
+	  {
+	    // g = exp(i chi^a t^a)
+	    for (int k=0; k<NcSq; k++)
+	      {
+		complex<double> element = 0.;
+		for (int ig=0; ig<Nc2m1; ig++)
+		  element += chi[ig*ntot+pos][0]*t[ig*NcSq+k];
+		localg.set(k, complex<double>(0,1.)*element);
+	      }
+	    localg.expm();
+	    // reunitarize
+	    localg.reu();
+
+	    if(localg(2)!=localg(2))
+	      {
+		cout << "problem at " << pos/N << " " << pos%N << " with g=" << localg << endl; 
+		localg = one;
+	      }
 	      
-	    }
-	}
-        }
-        
-      for (int i=0; i<N; i++)
+	    lat->cells[pos]->setg(localg);
+	  }
+      }
+
+      // every site only changes its own links and fields, using g of its neighbors
+#pragma omp parallel for
+      for (int pos=0; pos<ntot; pos++)
 	{
-	  for (int j=0; j<N; j++)
-	    {
-              gaugeTransform(lat, group, param, i, j);
-            }
-        }  
+	  gaugeTransform(lat, group, param, pos/N, pos%N);
+	}  
     } // gfiter loop
   
-  
-  for(int i=0; i<N*N; i++)
-    {
-      delete chi[i];
-    }
-  
-  delete [] chi;
+  fftw_destroy_plan(forward);
+  fftw_destroy_plan(backward);
+  fftw_free(chi);
 }
 
 	
 
 
+// U_i(x) -> g(x) U_i(x) g^dagger(x+i), E, phi, pi -> g(x) (...) g^dagger(x)
 void GaugeFix::gaugeTransform(Lattice* lat, Group* group, Parameters *param, int i, int j)
 {
   int N = param->getSize();
-  int pos, posmX, posmY;
+  int pos, posX, posY;
   int Nc = param->getNc();
-  Matrix g(Nc), gdag(Nc), temp(Nc);
+  Matrix g(Nc), gdag(Nc), gdagX(Nc), gdagY(Nc);
 
   pos = i*N+j;
-  if(i>0)
-    posmX = (i-1)*N+j;
+  if(i<N-1)
+    posX = (i+1)*N+j;
   else
-    posmX = (N-1)*N+j;
+    posX = j;
 
-  if(j>0)
-    posmY = i*N+(j-1);
+  if(j<N-1)
+    posY = i*N+(j+1);
   else 
-    posmY = i*N+N-1;
+    posY = i*N;
 
   g = gdag = lat->cells[pos]->getg();
   gdag.conjg();
+  gdagX = lat->cells[posX]->getg();
+  gdagX.conjg();
+  gdagY = lat->cells[posY]->getg();
+  gdagY.conjg();
 
   // gauge transform Ux and Uy
-  lat->cells[pos]->setUx( g * lat->cells[pos]->getUx() );
-  lat->cells[pos]->setUy( g * lat->cells[pos]->getUy() );
-  
-  lat->cells[posmX]->setUx( lat->cells[posmX]->getUx() * gdag );
-  lat->cells[posmY]->setUy( lat->cells[posmY]->getUy() * gdag );
+  lat->cells[pos]->setUx( g * lat->cells[pos]->getUx() * gdagX );
+  lat->cells[pos]->setUy( g * lat->cells[pos]->getUy() * gdagY );
   
   // gauge transform Ex and Ey
   lat->cells[pos]->setE1( g * lat->cells[pos]->getE1() * gdag );
@@ -48,7 +48,7 @@ class GaugeFix {
     };
   
   void gaugeTransform(Lattice* lat, Group* group, Parameters *param, int i, int j);
-  void FFTChi(FFT* fft, Lattice* lat, Group* group, Parameters *param, int steps);
+  void FFTChi(Lattice* lat, Group* group, Parameters *param, int steps);
 
 };
 
@@ -109,48 +109,33 @@ void Init::sampleTA(Parameters *param, Random* random, Glauber* glauber)
 	}   
       else if(A1==3) // He3
 	{
-	  //sample the position in the file
-	  ifstream fin;
-	  fin.open("he3_plaintext.dat"); 
+	  // the configurations are read from he3_plaintext.dat once and kept for later events
+	  readHe3Configurations();
+	  int nConfigurations = he3Configurations.size()/9;
 	     
-	  double dummy;
-	  double ran2 = random->genrand64_real3();   // sample the position in the file uniformly (13699 events in file)
-	  int nucleusNumber = static_cast<int>(ran2*13699);
+	  double ran2 = random->genrand64_real3();   // sample the configuration uniformly (13699 events in file)
+	  int nucleusNumber = static_cast<int>(ran2*nConfigurations);
 
 	  cout << "using nucleus Number = " << nucleusNumber << endl;
 	  
-	  // go to the correct line in the file
-	  fin.seekg(std::ios::beg);
-	  for(int i=0; i < nucleusNumber; ++i)
-	    {
-	      fin.ignore(std::numeric_limits<std::streamsize>::max(),'\n');
-	    }
-	  // am now at the correct line in the file
-	  
-	  // start reading one nucleus (3 positions)
+	  // take one nucleus (3 positions)
 	  int A=0;
 
 	  while(A<glauber->nucleusA1())
 	    {
-	      if(!fin.eof())
-		{  
-		  fin >> rv.x;
-		  fin >> rv.y;
-		  fin >> dummy; // don't care about z direction
-		  rv.collided=0;
-                  if (A==2) 
-                    rv.proton=0;
-                  else 
-                    rv.proton=1;
-                  nucleusA.push_back(rv);
-		  A++;
-		  cout << "A=" << A << ", x=" << rv.x << ", y=" << rv.y << endl;
-		}
+	      rv.x = he3Configurations[9*nucleusNumber+3*A];
+	      rv.y = he3Configurations[9*nucleusNumber+3*A+1];
+	      // don't care about z direction
+	      rv.collided=0;
+	      if (A==2) 
+		rv.proton=0;
+	      else 
+		rv.proton=1;
+	      nucleusA.push_back(rv);
+	      A++;
+	      cout << "A=" << A << ", x=" << rv.x << ", y=" << rv.y << endl;
 	    }
 	  
-	  	  
-	  fin.close();
-	  
 	  param->setA1FromFile(A);
 	
 	}   
@@ -194,48 +179,33 @@ void Init::sampleTA(Parameters *param, Random* random, Glauber* glauber)
 	}   
     else if(A2==3) // He3
 	{
-	  //sample the position in the file
-	  ifstream fin;
-	  fin.open("he3_plaintext.dat"); 
+	  // the configurations are read from he3_plaintext.dat once and kept for later events
+	  readHe3Configurations();
+	  int nConfigurations = he3Configurations.size()/9;
 	     
-	  double dummy;
-	  double ran2 = random->genrand64_real3();   // sample the position in the file uniformly (13699 events in file)
-	  int nucleusNumber = static_cast<int>(ran2*13699);
+	  double ran2 = random->genrand64_real3();   // sample the configuration uniformly (13699 events in file)
+	  int nucleusNumber = static_cast<int>(ran2*nConfigurations);
 
 	  cout << "using nucleus Number = " << nucleusNumber << endl;
 	  
-	  // go to the correct line in the file
-	  fin.seekg(std::ios::beg);
-	  for(int i=0; i < nucleusNumber; ++i)
-	    {
-	      fin.ignore(std::numeric_limits<std::streamsize>::max(),'\n');
-	    }
-	  // am now at the correct line in the file
-	  
-	  // start reading one nucleus (3 positions)
+	  // take one nucleus (3 positions)
 	  int A=0;
 
 	  while(A<glauber->nucleusA2())
 	    {
-	      if(!fin.eof())
-		{  
-		  fin >> rv.x;
-		  fin >> rv.y;
-		  fin >> dummy; // don't care about z direction
-		  rv.collided=0;
-                  if (A==2) 
-                    rv.proton=0;
-                  else 
-                    rv.proton=1;
-                  nucleusB.push_back(rv);
-		  A++;
-		  cout << "A=" << A << ", x=" << rv.x << ", y=" << rv.y << endl;
-		}
+	      rv.x = he3Configurations[9*nucleusNumber+3*A];
+	      rv.y = he3Configurations[9*nucleusNumber+3*A+1];
+	      // don't care about z direction
+	      rv.collided=0;
+	      if (A==2) 
+		rv.proton=0;
+	      else 
+		rv.proton=1;
+	      nucleusB.push_back(rv);
+	      A++;
+	      cout << "A=" << A << ", x=" << rv.x << ", y=" << rv.y << endl;
 	    }
 	  
-	  	  
-	  fin.close();
-	  
 	  param->setA2FromFile(A);
 	}   
       else
@@ -491,6 +461,11 @@ void Init::readNuclearQs(Parameters *param)
   // steps in qs0 and Y in the file
   string dummy;
   string T, Qs;
+
+  // the table does not change between events, only read it again if the file name did
+  if (nuclearQsFileName == param->getNucleusQsTableFileName())
+    return;
+
   // open file
   ifstream fin;
   fin.open((param->getNucleusQsTableFileName()).c_str()); 
@@ -520,6 +495,7 @@ void Init::readNuclearQs(Parameters *param)
                 }
             }
           fin.close();
+          nuclearQsFileName = param->getNucleusQsTableFileName();
           cout << " done." << endl;
         }
       else
@@ -529,6 +505,43 @@ void Init::readNuclearQs(Parameters *param)
         }
 }  
 
+void Init::readHe3Configurations()
+{
+  if (he3Configurations.size()>0)
+    return;
+
+  ifstream fin;
+  fin.open("he3_plaintext.dat"); 
+  if(!fin)
+    {
+      cerr << "[Init.cpp:readHe3Configurations]: File he3_plaintext.dat does not exist. Exiting." << endl;
+      exit(1);
+    }
+
+  // one configuration per line, the first 9 numbers are x,y,z of the 3 nucleons
+  string line;
+  while (getline(fin,line))
+    {
+      istringstream lineStream(line);
+      double value;
+      int n=0;
+      while (n<9 && lineStream >> value)
+	{
+	  he3Configurations.push_back(value);
+	  n++;
+	}
+      if (n<9) // incomplete or empty line
+	he3Configurations.resize(he3Configurations.size()-n);
+    }
+  fin.close();
+
+  if (he3Configurations.size()==0)
+    {
+      cerr << "[Init.cpp:readHe3Configurations]: No configurations found in he3_plaintext.dat. Exiting." << endl;
+      exit(1);
+    }
+}
+
 // Q_s as a function of \sum T_p and y (new in this version of the code - v1.2 and up)
 double Init::getNuclearQs2(Parameters *param, Random* random, double T, double y)
 {
@@ -584,6 +597,107 @@ double Init::getNuclearQs2(Parameters *param, Random* random, double T, double y
 
 // set g^2\mu^2 as the sum of the individual nucleons' g^2\mu^2, using Q_s(b,y) prop tp g^mu(b,y)
 // also compute N_part using Glauber
+// Sum of the proton thickness functions T_p of all nucleons in one nucleus, stored in TpA or TpB.
+// Each nucleon only contributes to the cells within TpCutoffWidths Gaussian widths of its
+// center (the rest is below exp(-TpCutoffWidths^2/2)), so the cost is O(N^2 + A x cells per nucleon)
+// instead of O(N^2 x A). Rows are distributed over the threads so that no two threads write to the same cell.
+// gauss, xq and yq are [A][max(nq,1)] arrays, nq the number of constituent quarks.
+void Init::addTp(Lattice *lat, Parameters *param, vector<ReturnValue> &nucleus, int A, int nq,
+                 double BG, double BGq, double xi, double *gauss, double *xq, double *yq, double weight, bool targetB)
+{
+  int N = param->getSize();
+  double L = param->getL();
+  double a = L/N; // lattice spacing in fm
+  int stride = max(nq,1);
+
+  // center and cutoff radius (in fm) of every nucleon
+  vector<double> xc(A), yc(A), rc(A);
+  for (int i = 0; i<A; i++)
+    {
+      xc[i] = nucleus.at(i).x;
+      yc[i] = nucleus.at(i).y;
+      if(nq>0)
+	{
+	  double dmax = 0.;
+	  for (int iq=0; iq<nq; iq++)
+	    dmax = max(dmax, sqrt(xq[i*stride+iq]*xq[i*stride+iq]+yq[i*stride+iq]*yq[i*stride+iq]));
+	  rc[i] = dmax + TpCutoffWidths*sqrt(BGq)*hbarc;
+	}
+      else
+	{
+	  // the anisotropic profile is wider than BG in one direction only for xi<0
+	  rc[i] = TpCutoffWidths*sqrt(BG/min(1.,1.+xi))*hbarc;
+	}
+    }
+
+#pragma omp parallel
+  {
+    double x, xm;
+    double y, ym;
+    int localpos;
+    double bp2,T, phi;
+
+#pragma omp for   
+  for(int ix=0; ix<N; ix++) // loop over all positions
+    {
+      x = -L/2.+a*ix;
+      for(int iy=0; iy<N; iy++)
+	{
+	  localpos = ix*N+iy;
+	  if (targetB)
+	    lat->cells[localpos]->setTpB(0.);
+	  else
+	    lat->cells[localpos]->setTpA(0.);
+	}
+
+      for (int i = 0; i<A; i++) 
+	{
+	  xm = xc[i];
+	  ym = yc[i];
+	  if (fabs(x-xm) > rc[i])
+	    continue;
+
+	  // cells of this row within the cutoff radius
+	  double dy = sqrt(rc[i]*rc[i]-(x-xm)*(x-xm));
+	  int iymin = max(0, static_cast<int>(ceil((ym-dy+L/2.)/a)));
+	  int iymax = min(N-1, static_cast<int>(floor((ym+dy+L/2.)/a)));
+	  
+	  for(int iy=iymin; iy<=iymax; iy++)
+	    {
+	      y = -L/2.+a*iy;
+	      localpos = ix*N+iy;
+
+	      if(nq>0)
+		{
+		  T = 0.;
+		  for (int iq=0; iq<nq; iq++)
+		    {
+		      bp2 = (xm+xq[i*stride+iq]-x)*(xm+xq[i*stride+iq]-x)+(ym+yq[i*stride+iq]-y)*(ym+yq[i*stride+iq]-y);
+		      bp2 /= hbarc*hbarc;
+
+		      T += exp(-bp2/(2.*BGq))/(2.*PI*BGq)/(double(nq))*gauss[i*stride+iq]; // I removed the 2/3 here to make it a bit bigger
+		    }
+		}
+	      else
+		{
+		  phi = nucleus.at(i).phi;
+
+		  bp2 = (xm-x)*(xm-x)+(ym-y)*(ym-y) + xi*pow((xm-x)*cos(phi) + (ym-y)*sin(phi),2.);
+		  bp2 /= hbarc*hbarc;     	  
+		  T = sqrt(1+xi)*exp(-bp2/(2.*BG))/(2.*PI*BG)*gauss[i*stride]; // T_p in this cell for the current nucleon
+		}
+
+	      // add up all T_p
+	      if (targetB)
+		lat->cells[localpos]->setTpB(lat->cells[localpos]->getTpB()+T*weight);
+	      else
+		lat->cells[localpos]->setTpA(lat->cells[localpos]->getTpA()+T*weight);
+	    }
+	}
+    }
+  }
+}
+
 void Init::setColorChargeDensity(Lattice *lat, Parameters *param, Random *random, Glauber *glauber)
 {
   int pos,posA,posB;
@@ -877,89 +991,10 @@ void Init::setColorChargeDensity(Lattice *lat, Parameters *param, Random *random
     }
 
 //add all T_p's (new in version 1.2)
-#pragma omp parallel
-  {
-    double x, xm;
-    double y, ym;
-    int localpos;
-    double bp2,T, phi;
-    double maxT=0;
-
-#pragma omp for   
-  for(int ix=0; ix<N; ix++) // loop over all positions
-    {
-      x = -L/2.+a*ix;
-      for(int iy=0; iy<N; iy++)
-	{
-	  y = -L/2.+a*iy;
-	   
-	  localpos = ix*N+iy;
-
-	
-	  // nucleus A 
-	  lat->cells[localpos]->setTpA(0.);
-	  for (int i = 0; i<A1; i++) 
-	    {
-	      xm = nucleusA.at(i).x;
-	      ym = nucleusA.at(i).y;
-	      
-	      if(param->getUseConstituentQuarkProton()>0)
-		{
-		  T = 0.;
-		  for (int iq=0; iq<param->getUseConstituentQuarkProton(); iq++)
-		    {
-		      bp2 = (xm+xq[i][iq]-x)*(xm+xq[i][iq]-x)+(ym+yq[i][iq]-y)*(ym+yq[i][iq]-y);
-		      bp2 /= hbarc*hbarc;
-
-		      T += exp(-bp2/(2.*BGq))/(2.*PI*BGq)/(double(param->getUseConstituentQuarkProton()))*gaussA[i][iq]; // I removed the 2/3 here to make it a bit bigger
-		    }
-		}
-	      else
-		{
-		  phi = nucleusA.at(i).phi;
-
-		  bp2 = (xm-x)*(xm-x)+(ym-y)*(ym-y) + xi*pow((xm-x)*cos(phi) + (ym-y)*sin(phi),2.);
-		  bp2 /= hbarc*hbarc;     	  
-		  T = sqrt(1+xi)*exp(-bp2/(2.*BG))/(2.*PI*BG)*gaussA[i][0]; // T_p in this cell for the current nucleon
-		}
-
-                lat->cells[localpos]->setTpA(lat->cells[localpos]->getTpA()+T/nucleiInAverage); // add up all T_p
-
-	    }
-	  
-	  // nucleus B 
-	  lat->cells[localpos]->setTpB(0.);
-	  for (int i = 0; i<A2; i++) 
-	    {
-	      xm = nucleusB.at(i).x;
-	      ym = nucleusB.at(i).y;
-
-	      if(param->getUseConstituentQuarkProton()>0)
-		{
-		  T = 0.;
-		  for (int iq=0; iq<param->getUseConstituentQuarkProton(); iq++)
-		    {
-		      bp2 = (xm+xq2[i][iq]-x)*(xm+xq2[i][iq]-x)+(ym+yq2[i][iq]-y)*(ym+yq2[i][iq]-y);
-		      bp2 /= hbarc*hbarc;
-
-		      T += exp(-bp2/(2.*BGq))/(2.*PI*BGq)/double(param->getUseConstituentQuarkProton())*gaussB[i][iq];
-		    }
-		}
-	      else
-		{
-		  phi = nucleusB.at(i).phi;
-	      
-		  bp2 = (xm-x)*(xm-x)+(ym-y)*(ym-y) + xi*pow((xm-x)*cos(phi) + (ym-y)*sin(phi),2.);
-		  bp2 /= hbarc*hbarc;
-		  
-		  T = sqrt(1+xi)*exp(-bp2/(2.*BG))/(2.*PI*BG)*gaussB[i][0]; // T_p in this cell for the current nucleon
-		}
-	      
-                lat->cells[localpos]->setTpB(lat->cells[localpos]->getTpB()+T/nucleiInAverage); // add up all T_p	      
-	    }
-	}
-    }
-  }
+  addTp(lat, param, nucleusA, A1, param->getUseConstituentQuarkProton(), BG, BGq, xi,
+        &gaussA[0][0], &xq[0][0], &yq[0][0], 1./nucleiInAverage, false);
+  addTp(lat, param, nucleusB, A2, param->getUseConstituentQuarkProton(), BG, BGq, xi,
+        &gaussB[0][0], &xq2[0][0], &yq2[0][0], 1./nucleiInAverage, true);
 
 
   stringstream strNcoll_name;
@@ -1631,7 +1666,11 @@ void Init::setV(Lattice *lat, Group* group, Parameters *param, Random* random, G
   {
    stringstream strVOne_name;
    //strVOne_name << "V1-" << param->getMPIRank() << ".txt";
-   strVOne_name << "V-" <<  param->getMPIRank() + 2*param->getSeed()*param->getMPISize() << ".txt";
+   // the MPI rank holds the event number; nEvents 0 means one event per rank
+   int nEvents = param->getNEvents();
+   if (nEvents<=0)
+     nEvents = param->getMPISize();
+   strVOne_name << "V-" <<  param->getMPIRank() + 2*param->getSeed()*nEvents << ".txt";
    string VOne_name;
    VOne_name = strVOne_name.str();
 
@@ -1653,7 +1692,7 @@ void Init::setV(Lattice *lat, Group* group, Parameters *param, Random* random, G
   
    stringstream strVTwo_name;
    // strVTwo_name << "V2-" << param->getMPIRank() << ".txt";
-   strVTwo_name << "V-" <<  param->getMPIRank() + (1+2*param->getSeed())*param->getMPISize() << ".txt";
+   strVTwo_name << "V-" <<  param->getMPIRank() + (1+2*param->getSeed())*nEvents << ".txt";
    string VTwo_name;
    VTwo_name = strVTwo_name.str();
 
@@ -2707,13 +2746,52 @@ void Init::generate_nucleus_configuration_with_woods_saxon(
 }
 
 
-double Init::sample_r_from_woods_saxon(Random *random, double a_WS, double R_WS) const {
-    double rmaxCut = R_WS + 10.*a_WS;
-    double r = 0.;
-    do {
-        r = rmaxCut*pow(random->genrand64_real3(), 1.0/3.0);
-    } while (random->genrand64_real3() > fermi_distribution(r, R_WS, a_WS));
-    return(r);
+// Inverse of the cumulative distribution of r^2 f(r) on [0, R_WS+10 a_WS].
+// It is tabulated as a function of w=u^(1/3), u the cumulative probability, in which
+// r(w) is close to linear also near r=0. Tables are kept for all (a_WS, R_WS) seen so far.
+const vector<double> &Init::woods_saxon_inverse_cdf(double a_WS, double R_WS) {
+    pair<double,double> key(a_WS, R_WS);
+    map<pair<double,double>, vector<double> >::iterator it = woodsSaxonTables.find(key);
+    if (it != woodsSaxonTables.end())
+        return it->second;
+
+    const double rmaxCut = R_WS + 10.*a_WS;
+    const int nr = 16*nWoodsSaxonTable;
+    const double dr = rmaxCut/nr;
+
+    // cumulative distribution on a fine grid in r (trapezoidal rule)
+    std::vector<double> cdf(nr+1, 0.);
+    double fPrev = 0.;
+    for (int i = 1; i <= nr; i++) {
+        double r = i*dr;
+        double f = r*r*fermi_distribution(r, R_WS, a_WS);
+        cdf[i] = cdf[i-1] + 0.5*(f + fPrev)*dr;
+        fPrev = f;
+    }
+    for (int i = 1; i <= nr; i++)
+        cdf[i] /= cdf[nr];
+
+    vector<double> &table = woodsSaxonTables[key];
+    table.resize(nWoodsSaxonTable+1);
+    table[0] = 0.;
+    int j = 0;
+    for (int k = 1; k < nWoodsSaxonTable; k++) {
+        double w = static_cast<double>(k)/nWoodsSaxonTable;
+        double u = w*w*w;
+        while (j < nr-1 && cdf[j+1] < u)
+            j++;
+        table[k] = (j + (u - cdf[j])/(cdf[j+1] - cdf[j]))*dr;
+    }
+    table[nWoodsSaxonTable] = rmaxCut;
+    return table;
+}
+
+
+double Init::sample_r_from_woods_saxon(Random *random, double a_WS, double R_WS) {
+    const vector<double> &table = woods_saxon_inverse_cdf(a_WS, R_WS);
+    double w = pow(random->genrand64_real3(), 1.0/3.0)*nWoodsSaxonTable;
+    int k = std::min(static_cast<int>(w), nWoodsSaxonTable-1);
+    return(table[k] + (w - k)*(table[k+1] - table[k]));
 }
 
 
@@ -2802,19 +2880,35 @@ void Init::generate_nucleus_configuration_with_deformed_woods_saxon(
 }
 
 
+// r is proposed from the spherical distribution with the largest radius R_WS(theta)
+// and accepted with f(r,R_WS(theta))/f(r,R_max) <= 1, which is close to one for
+// the deformations in known_nuclei.in.
 void Init::sample_r_and_costheta_from_deformed_woods_saxon(
         Random *random, double a_WS, double R_WS, double beta2, double beta4,
-        double &r, double &costheta) const {
-    double rmaxCut = R_WS + 10.*a_WS;
+        double &r, double &costheta) {
+    // beta2 Y20 + beta4 Y40 is a quadratic polynomial in cos^2(theta), its maximum
+    // is at cos^2(theta) = 0, 1 or at the vertex
+    double deformationMax = std::max(beta2*spherical_harmonics(2, 0.) + beta4*spherical_harmonics(4, 0.),
+                                     beta2*spherical_harmonics(2, 1.) + beta4*spherical_harmonics(4, 1.));
+    if (beta4 != 0.) {
+        // Y20 = c2 (3 ct^2 - 1), Y40 = c4 (35 ct^4 - 30 ct^2 + 3)
+        double c2 = spherical_harmonics(2, 1.)/2.;
+        double c4 = spherical_harmonics(4, 1.)/8.;
+        double ct2 = (30.*beta4*c4 - 3.*beta2*c2)/(70.*beta4*c4);
+        if (ct2 > 0. && ct2 < 1.)
+            deformationMax = std::max(deformationMax,
+                                      beta2*spherical_harmonics(2, sqrt(ct2)) + beta4*spherical_harmonics(4, sqrt(ct2)));
+    }
+    const double R_WS_max = R_WS*(1.0 + std::max(deformationMax, 0.));
     double R_WS_theta = R_WS;
     do {
-        r = rmaxCut*pow(random->genrand64_real3(), 1.0/3.0);
+        r = sample_r_from_woods_saxon(random, a_WS, R_WS_max);
         costheta = 1.0 - 2.0*random->genrand64_real3();
         auto y20 = spherical_harmonics(2, costheta);
         auto y40 = spherical_harmonics(4, costheta);
         R_WS_theta = R_WS*(1.0 + beta2*y20 + beta4*y40);
     } while (random->genrand64_real3()
-             > fermi_distribution(r, R_WS_theta, a_WS));
+             > fermi_distribution(r, R_WS_theta, a_WS)/fermi_distribution(r, R_WS_max, a_WS));
 }
 
 
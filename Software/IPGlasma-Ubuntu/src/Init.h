@@ -13,6 +13,9 @@
 #include <complex>
 #include <limits> 
 #include <ctime>
+#include <vector>
+#include <map>
+#include <string>
 
 #include "mpi.h"
 #include "Lattice.h"
@@ -43,6 +46,16 @@ class Init {
   double Tlist[iTpmax];
   
   double As[1];
+
+  // number of Gaussian widths beyond which a nucleon's T_p is not added to a cell
+  double const TpCutoffWidths = 8.;
+  // points in the tabulated inverse cumulative Woods-Saxon distributions
+  int const static nWoodsSaxonTable = 4096;
+
+  // caches that survive from one event to the next
+  string nuclearQsFileName;                                  // Qs table currently in Qs2Nuclear
+  vector<double> he3Configurations;                          // x,y,z of the 3 nucleons, 9 numbers per configuration
+  map<pair<double,double>, vector<double> > woodsSaxonTables; // r(w), w=u^(1/3), keyed by (a_WS, R_WS)
   
   vector<ReturnValue> nucleusA;  // list of x and y coordinates of nucleons in nucleus A      
   vector<ReturnValue> nucleusB;  // list of x and y coordinates of nucleons in nucleus B 
@@ -68,6 +81,9 @@ class Init {
   void init(Lattice *lat, Group *group, Parameters *param, Random *random, Glauber* glauber, int READFROMFILE);
   void sampleTA(Parameters *param, Random *random, Glauber* glauber);
   void readNuclearQs(Parameters *param);
+  void readHe3Configurations();
+  void addTp(Lattice *lat, Parameters *param, vector<ReturnValue> &nucleus, int A, int nq,
+             double BG, double BGq, double xi, double *gauss, double *xq, double *yq, double weight, bool targetB);
   vector <complex<double> > solveAxb(Parameters *param, complex<double>* A, complex<double>* b);
   double getNuclearQs2(Parameters *param, Random *random, double Qs2atZeroY, double y);
   void setColorChargeDensity(Lattice *lat, Parameters *param, Random *random, Glauber *glauber);
@@ -87,10 +103,11 @@ class Init {
                 Random *random,
                 int A, int Z, double a_WS, double R_WS, double beta2, double beta4,
                 std::vector<ReturnValue> *nucleus);
-    double sample_r_from_woods_saxon(Random *random, double a_WS, double R_WS) const;
+    const vector<double> &woods_saxon_inverse_cdf(double a_WS, double R_WS);
+    double sample_r_from_woods_saxon(Random *random, double a_WS, double R_WS);
     void sample_r_and_costheta_from_deformed_woods_saxon(
             Random *random, double a_WS, double R_WS, double beta2, double beta4,
-            double &r, double &costheta) const;
+            double &r, double &costheta);
     double fermi_distribution(double r, double R_WS, double a_WS) const;
     double spherical_harmonics(int l, double ct) const;
     void recenter_nucleus(std::vector<double> &x, std::vector<double> &y,
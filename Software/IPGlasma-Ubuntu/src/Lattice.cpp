@@ -49,6 +49,14 @@ Lattice::Lattice(Parameters *param, int N, int length)
   cout << " done on rank " << param->getMPIRank() << "." << endl;
 }
 
+void Lattice::reset()
+{
+  const Matrix one(Nc,1.);
+#pragma omp parallel for
+  for(int i=0; i<size; i++)
+    cells[i]->reset(one);
+}
+
 Lattice::~Lattice()
 {
   for(int i=0; i<size; i++)
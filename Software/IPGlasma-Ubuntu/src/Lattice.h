@@ -33,6 +33,9 @@ public:
   //functions to access values within individual cells
   int getSize() { return size; };
 
+  // set all cells back to the state after allocation, so the lattice can be reused for the next event
+  void reset();
+
   vector<Cell*> cells;         // the actual array of cells, the "lattice". cells is an array of pointers to cell objects
 
   vector<int> posmX;
@@ -5,252 +5,324 @@
 //**************************************************************************
 // MyEigen class.
 
+// 4x4 adjugate times vector, v = adj(A) u. Near an eigenvalue adj(A) is (up to a factor) the projector
+// onto the eigenvector, so this is one step of inverse iteration without any division or pivoting.
+static inline void adjugateTimes(const double *A, const double *u, double *v)
+{
+  const double s0 = A[0]*A[5] - A[4]*A[1];
+  const double s1 = A[0]*A[6] - A[4]*A[2];
+  const double s2 = A[0]*A[7] - A[4]*A[3];
+  const double s3 = A[1]*A[6] - A[5]*A[2];
+  const double s4 = A[1]*A[7] - A[5]*A[3];
+  const double s5 = A[2]*A[7] - A[6]*A[3];
+
+  const double c5 = A[10]*A[15] - A[14]*A[11];
+  const double c4 = A[9]*A[15] - A[13]*A[11];
+  const double c3 = A[9]*A[14] - A[13]*A[10];
+  const double c2 = A[8]*A[15] - A[12]*A[11];
+  const double c1 = A[8]*A[14] - A[12]*A[10];
+  const double c0 = A[8]*A[13] - A[12]*A[9];
+
+  v[0] = ( A[5]*c5 - A[6]*c4 + A[7]*c3)*u[0] + (-A[1]*c5 + A[2]*c4 - A[3]*c3)*u[1]
+    + ( A[13]*s5 - A[14]*s4 + A[15]*s3)*u[2] + (-A[9]*s5 + A[10]*s4 - A[11]*s3)*u[3];
+  v[1] = (-A[4]*c5 + A[6]*c2 - A[7]*c1)*u[0] + ( A[0]*c5 - A[2]*c2 + A[3]*c1)*u[1]
+    + (-A[12]*s5 + A[14]*s2 - A[15]*s1)*u[2] + ( A[8]*s5 - A[10]*s2 + A[11]*s1)*u[3];
+  v[2] = ( A[4]*c4 - A[5]*c2 + A[7]*c0)*u[0] + (-A[0]*c4 + A[1]*c2 - A[3]*c0)*u[1]
+    + ( A[12]*s4 - A[13]*s2 + A[15]*s0)*u[2] + (-A[8]*s4 + A[9]*s2 - A[11]*s0)*u[3];
+  v[3] = (-A[4]*c3 + A[5]*c1 - A[6]*c0)*u[0] + ( A[0]*c3 - A[1]*c1 + A[2]*c0)*u[1]
+    + (-A[12]*s3 + A[13]*s1 - A[14]*s0)*u[2] + ( A[8]*s3 - A[9]*s1 + A[10]*s0)*u[3];
+}
+
+// Landau matching T^mu_nu u^nu = eps u^mu for one cell (M is T^mu_nu, row major, metric diag(1,-1,-1,-tau^2)).
+// Rayleigh quotient iteration starting from the rest frame, fixed number of steps and no branches
+// so that it vectorizes across cells. The result has to be checked with landauMatchConverged.
+static inline void landauIterate(const double *M, const double tau2, double &eps, double *u)
+{
+  double A[16];
+  double v[4];
+  u[0] = 1.; u[1] = 0.; u[2] = 0.; u[3] = 0.;
+  eps = M[0];
+  for (int iter=0; iter<MyEigen::landauIterations; iter++)
+    {
+      for (int k=0; k<16; k++)
+        A[k] = M[k];
+      A[0] -= eps; A[5] -= eps; A[10] -= eps; A[15] -= eps;
+      
+      adjugateTimes(A, u, v);
+      
+      const double norm2 = v[0]*v[0] - v[1]*v[1] - v[2]*v[2] - tau2*v[3]*v[3];
+      const double anorm = sqrt(fabs(norm2));
+      // keep the previous vector if the adjugate vanished (e.g. empty cells), fix the sign of u^tau
+      const double scale = (anorm > 1e-300) ? ((v[0] < 0.) ? -1./anorm : 1./anorm) : 0.;
+      for (int k=0; k<4; k++)
+        u[k] = (anorm > 1e-300) ? v[k]*scale : u[k];
+
+      // Rayleigh quotient u_mu T^mu_nu u^nu / u_mu u^mu
+      const double Mu0 = M[0]*u[0] + M[1]*u[1] + M[2]*u[2] + M[3]*u[3];
+      const double Mu1 = M[4]*u[0] + M[5]*u[1] + M[6]*u[2] + M[7]*u[3];
+      const double Mu2 = M[8]*u[0] + M[9]*u[1] + M[10]*u[2] + M[11]*u[3];
+      const double Mu3 = M[12]*u[0] + M[13]*u[1] + M[14]*u[2] + M[15]*u[3];
+      const double uu = u[0]*u[0] - u[1]*u[1] - u[2]*u[2] - tau2*u[3]*u[3];
+      const double uMu = u[0]*Mu0 - u[1]*Mu1 - u[2]*Mu2 - tau2*u[3]*Mu3;
+      eps = (fabs(uu) > 1e-300) ? uMu/uu : eps;
+    }
+}
+
+// accept the iterated solution only if u is a normalized, future pointing time-like eigenvector.
+// Since T^mu_nu is self-adjoint with respect to the metric, there is at most one time-like eigenvector.
+static inline bool landauMatchConverged(const double *M, const double tau2, const double eps, const double *u)
+{
+  double scale = 0.;
+  for (int k=0; k<16; k++)
+    scale = max(scale, fabs(M[k]));
+  if (scale == 0.)
+    return true;
+
+  const double uu = u[0]*u[0] - u[1]*u[1] - u[2]*u[2] - tau2*u[3]*u[3];
+  if (!(u[0] > 0.) || !(fabs(uu-1.) < 1e-8) || !(fabs(eps) < 1e300))
+    return false;
+
+  for (int mu=0; mu<4; mu++)
+    {
+      double residual = M[4*mu]*u[0] + M[4*mu+1]*u[1] + M[4*mu+2]*u[2] + M[4*mu+3]*u[3] - eps*u[mu];
+      // the eta component carries a factor tau relative to the others
+      if (mu==3)
+        residual *= sqrt(tau2);
+      if (!(fabs(residual) <= MyEigen::landauTolerance*scale*u[0]))
+        return false;
+    }
+  return true;
+}
+
+// the general complex eigen-solver, only used for cells where the iteration did not converge.
+// returns the number of time-like eigenvectors found. eps and u are left untouched if none is found.
+// (si,sj) is the cell on the N x N lattice; away from the edges complex results are replaced by the rest frame.
+int MyEigen::landauMatchGSL(double *data, double tau2, double Ttautau, int si, int sj, int N, double &eps, double *u)
+{
+  gsl_complex square;
+  gsl_complex factor;
+  gsl_complex euklidiansquare;
+  gsl_complex z_aux;
+  gsl_complex tau2c;
+  int foundU=0;
+  int changeSign;
+
+  gsl_matrix_view m = gsl_matrix_view_array (data, 4, 4); //matrix
+  
+  gsl_vector_complex *eval = gsl_vector_complex_alloc (4); //eigenvalues are components of this vector
+  gsl_matrix_complex *evec = gsl_matrix_complex_alloc (4, 4); //eigenvectors are columns of this matrix
+  
+  gsl_eigen_nonsymmv_workspace * w = gsl_eigen_nonsymmv_alloc (4); //workspace
+  
+  gsl_eigen_nonsymmv (&m.matrix, eval, evec, w); // solve for eigenvalues and eigenvectors (without 'v' only compute eigenvalues)
+  
+  gsl_eigen_nonsymmv_free (w); // free memory associated with workspace
+
+  GSL_SET_COMPLEX(&tau2c, tau2, 0);
+  
+  for (int i = 0; i < 4; i++)
+    {
+      gsl_complex eval_i = gsl_vector_complex_get (eval, i);
+      gsl_vector_complex_view evec_i = gsl_matrix_complex_column (evec, i);
+      
+      GSL_SET_COMPLEX(&square, 0, 0);
+      GSL_SET_COMPLEX(&euklidiansquare, 0, 0);
+      
+      for (int j = 0; j < 4; ++j)
+        {	
+          gsl_complex z = gsl_vector_complex_get(&evec_i.vector, j);
+          z_aux = gsl_complex_mul(tau2c,z);	
+          euklidiansquare = gsl_complex_add(euklidiansquare, gsl_complex_mul(z,z));
+          
+          if (j==0)
+            square = gsl_complex_add(square, gsl_complex_mul(z,z));
+          else if (j<3)
+            square = gsl_complex_sub(square, gsl_complex_mul(z,z));
+          else
+            square = gsl_complex_sub(square, gsl_complex_mul(z_aux,z));
+        }
+      
+      GSL_SET_COMPLEX(&factor, sqrt(abs(GSL_REAL(euklidiansquare)/GSL_REAL(square))), 0);
+      if(GSL_REAL(square)<=0)
+        continue;
+
+      // for the time-like eigenvector do the following (this is the flow velocity)
+      foundU+=1;
+      eps = GSL_REAL(eval_i);
+      if(abs(GSL_IMAG(eval_i))>0.001 && si>0 && sj>0 && si<N-5 && sj<N-5)
+        eps = Ttautau;
+      
+      changeSign=0;
+      for (int j = 0; j < 4; ++j)
+        {	
+          gsl_complex z = gsl_vector_complex_get(&evec_i.vector, j);
+          z = gsl_complex_mul(z,factor);
+          
+          if(j==0 && GSL_REAL(z)<0)
+            changeSign=1;
+          
+          if(changeSign==1)
+            GSL_SET_COMPLEX(&z, -1.*GSL_REAL(z), -1.*GSL_IMAG(z));
+          
+          u[j] = GSL_REAL(z);
+          
+          // a complex component resets u to the rest frame, the components after it are still taken from z
+          if(abs(GSL_IMAG(z))>0.001 && eps>0.001 && si>10 && sj>10 && si<N-10 && sj<N-10)
+            {
+              u[0] = 1.; u[1] = 0.; u[2] = 0.; u[3] = 0.;
+              eps = Ttautau;
+            }
+        }
+    }
+  
+  gsl_vector_complex_free (eval);
+  gsl_matrix_complex_free (evec);
+
+  return foundU;
+}
+
 void MyEigen::flowVelocity4D(Lattice *lat, Group *group, Parameters *param, int it)
 {
   int N = param->getSize();
-  int pos;
-  int changeSign;
-  int count;
   double L = param->getL();
   double a = L/N; // lattice spacing in fm
-  double x, y, ux=0., uy=0., ueta=0., utau=0.;
+  double x, y;
   double dtau = param->getdtau();
-  gsl_complex square;
-  gsl_complex factor;
-  gsl_complex euklidiansquare;
-  double eps;
-  gsl_complex z_aux;
-  gsl_complex tau2;
-  int foundU;
   double averageux=0.;
   double averageuy=0.;
   double averageueta=0.;
   double averageeps=0.;
-  count = 0;
-  double uxd, uyd, uetad;
+  int count = 0;
+  const double tau2 = (it*dtau*a)*(it*dtau*a);
   
-  for (int si=0; si<N; si++)
-    {
-      for (int sj=0; sj<N; sj++)
-	{
-
-	  x = -L/2.+a*si;
-	  y = -L/2.+a*sj;
-	
-	  pos = si*N+sj;
-	  GSL_SET_COMPLEX(&square, 0, 0);
-
-	  double data[] = { lat->cells[pos]->getTtautau(), -lat->cells[pos]->getTtaux(), -lat->cells[pos]->getTtauy(), -(it*dtau*a)*(it*dtau*a)*lat->cells[pos]->getTtaueta(),
-	  		    lat->cells[pos]->getTtaux()  , -lat->cells[pos]->getTxx()  , -lat->cells[pos]->getTxy()  , -(it*dtau*a)*(it*dtau*a)*lat->cells[pos]->getTxeta(), 
-	  		    lat->cells[pos]->getTtauy()  , -lat->cells[pos]->getTxy()  , -lat->cells[pos]->getTyy()  , -(it*dtau*a)*(it*dtau*a)*lat->cells[pos]->getTyeta(),
-	  		    lat->cells[pos]->getTtaueta(), -lat->cells[pos]->getTxeta(), -lat->cells[pos]->getTyeta(), -(it*dtau*a)*(it*dtau*a)*lat->cells[pos]->getTetaeta()
-	  };
-
-
-	  
-	  gsl_matrix_view m = gsl_matrix_view_array (data, 4, 4); //matrix
-	  
-	  gsl_vector_complex *eval = gsl_vector_complex_alloc (4); //eigenvalues are components of this vector
-	  gsl_matrix_complex *evec = gsl_matrix_complex_alloc (4, 4); //eigenvectors are columns of this matrix
-	  
-	  gsl_eigen_nonsymmv_workspace * w = gsl_eigen_nonsymmv_alloc (4); //workspace
-	  
-	  gsl_eigen_nonsymmv (&m.matrix, eval, evec, w); // solve for eigenvalues and eigenvectors (without 'v' only compute eigenvalues)
-	  
-	  gsl_eigen_nonsymmv_free (w); // free memory associated with workspace
-	  
+#pragma omp parallel
+  {
+    // one row of T^mu_nu at a time, stored as 16 contiguous arrays so the iteration vectorizes across cells
+    vector<double> Mrow(16*N);
+    vector<double> epsrow(N);
+    vector<double> urow(4*N);
+
+#pragma omp for reduction(+:averageux,averageuy,averageueta,averageeps,count)
+    for (int si=0; si<N; si++)
+      {
+        for (int sj=0; sj<N; sj++)
+          {
+            Cell *cell = lat->cells[si*N+sj];
+            const double row[16] = { cell->getTtautau(), -cell->getTtaux(), -cell->getTtauy(), -tau2*cell->getTtaueta(),
+                                     cell->getTtaux()  , -cell->getTxx()  , -cell->getTxy()  , -tau2*cell->getTxeta(), 
+                                     cell->getTtauy()  , -cell->getTxy()  , -cell->getTyy()  , -tau2*cell->getTyeta(),
+                                     cell->getTtaueta(), -cell->getTxeta(), -cell->getTyeta(), -tau2*cell->getTetaeta() };
+            for (int k=0; k<16; k++)
+              Mrow[k*N+sj] = row[k];
+          }
+
+#pragma omp simd
+        for (int sj=0; sj<N; sj++)
+          {
+            double M[16];
+            double u[4];
+            double eps;
+            for (int k=0; k<16; k++)
+              M[k] = Mrow[k*N+sj];
+            landauIterate(M, tau2, eps, u);
+            epsrow[sj] = eps;
+            for (int k=0; k<4; k++)
+              urow[4*sj+k] = u[k];
+          }
+
+        for (int sj=0; sj<N; sj++)
+          {
+            const int pos = si*N+sj;
+            Cell *cell = lat->cells[pos];
+            double M[16];
+            for (int k=0; k<16; k++)
+              M[k] = Mrow[k*N+sj];
+
+            double eps = epsrow[sj];
+            double u[4] = { urow[4*sj], urow[4*sj+1], urow[4*sj+2], urow[4*sj+3] };
+            int foundU = 1;
+
+            if (!landauMatchConverged(M, tau2, eps, u))
+              {
+                // pathological cell: use the general solver
+                eps = cell->getTtautau();
+                u[0] = 1.; u[1] = 0.; u[2] = 0.; u[3] = 0.;
+                foundU = landauMatchGSL(M, tau2, cell->getTtautau(), si, sj, N, eps, u);
+              }
 
-	  //set to 'zero' 
-	  lat->cells[pos]->setEpsilon( lat->cells[pos]->getTtautau() );
-	  lat->cells[pos]->setutau(1.);
-	  lat->cells[pos]->setux(0.);
-	  lat->cells[pos]->setuy(0.);
-	  lat->cells[pos]->setueta(0.);
-	  
-	  { // output:
-	    int i;
-	    foundU=0;
-	    for (i = 0; i < 4; i++)
-	      {
-		gsl_complex eval_i = gsl_vector_complex_get (eval, i);
-		gsl_vector_complex_view evec_i = gsl_matrix_complex_column (evec, i);
-		
-		GSL_SET_COMPLEX(&square, 0, 0);
-		GSL_SET_COMPLEX(&tau2, a*it*dtau*a*it*dtau, 0);
-		GSL_SET_COMPLEX(&euklidiansquare, 0, 0);
-		
-		for (int j = 0; j < 4; ++j)
-		  {	
-		    gsl_complex z = gsl_vector_complex_get(&evec_i.vector, j);
-		    z_aux = gsl_complex_mul(tau2,z);	
-		    euklidiansquare = gsl_complex_add(euklidiansquare, gsl_complex_mul(z,z));
-		    
-		    if (j==0)
-		      square = gsl_complex_add(square, gsl_complex_mul(z,z));
-		    else if (j<3)
-		      square = gsl_complex_sub(square, gsl_complex_mul(z,z));
-		    else
-		      square = gsl_complex_sub(square, gsl_complex_mul(z_aux,z));
-		  }
-		
-		GSL_SET_COMPLEX(&factor, sqrt(abs(GSL_REAL(euklidiansquare)/GSL_REAL(square))), 0);
-		if(GSL_REAL(square)>0 )
-		  {
-		    eps = GSL_REAL(eval_i);
-		    if(abs(GSL_IMAG(eval_i))>0.001 && si>0 && sj>0 && si<N-5 && sj<N-5)
-		      {
-			eps = lat->cells[pos]->getTtautau();
-		      }
-		  }
-				
-		GSL_SET_COMPLEX(&square, 0, 0);
-	
-		for (int j = 0; j < 4; ++j)
-		  {	
-		    gsl_complex z = gsl_vector_complex_get(&evec_i.vector, j);
-		    z = gsl_complex_mul(z,factor);
-		    z_aux = gsl_complex_mul(tau2,z);	
-		   
-		    if (j==0)
-		      square = gsl_complex_add(square, gsl_complex_mul(z,z));
-		    else if (j<3)
-		      square = gsl_complex_sub(square, gsl_complex_mul(z,z));
-		    else
-		      square = gsl_complex_sub(square, gsl_complex_mul(z_aux,z));
-		  }
-		changeSign=0;
-		// for the time-like eigenvector do the following (this is the flow velocity)
-		if(GSL_REAL(square)>0)
-		  {
-		    foundU+=1;
-		    for (int j = 0; j < 4; ++j)
-		      {	
-			gsl_complex z = gsl_vector_complex_get(&evec_i.vector, j);
-			z = gsl_complex_mul(z,factor);
-			
-			if(j==0 && GSL_REAL(z)<0)
-			  {
-			    changeSign=1;
-			    GSL_SET_COMPLEX(&z, -1.*GSL_REAL(z), -1.*GSL_IMAG(z));
-			  }
-			
-			if(j>0 && changeSign==1)
-			  {
-			    GSL_SET_COMPLEX(&z, -1.*GSL_REAL(z), -1.*GSL_IMAG(z));
-			  }
-			
-			if(j==0)
-			  {
-			    if(eps>0.1)
-			      utau = GSL_REAL(z);
-			    else 
-			      utau=1.;
-			  }
-			if(j==1)
-			  {
-			    if(eps>0.1)
-			      ux = GSL_REAL(z);
-			    else 
-			      ux=0.;
-			  }
-			if(j==2)
-			  {
-			    if(eps>0.1)
-			      uy = GSL_REAL(z);
-			    else 
-			      uy=0.;
-			  }
-			if(j==3)
-			  {
-			    if(eps>0.1)
-			      ueta = GSL_REAL(z);
-			    else 
-			      ueta=0.;
-			  }
-			if(abs(GSL_IMAG(z))>0.001 && eps>0.001 && si>10 && sj>10 && si<N-10  && sj<N-10)
-			  {
-			    utau=1.;
-			    ux = 0.;
-			    uy = 0.;
-			    ueta=0.;
-                            eps = lat->cells[pos]->getTtautau();
-			  }
-                      }
-		    
-		    lat->cells[pos]->setutau(utau);
-		    lat->cells[pos]->setux(ux);
-		    lat->cells[pos]->setuy(uy);
-		    lat->cells[pos]->setueta(ueta);
-		    lat->cells[pos]->setEpsilon(eps);
-
-		    averageux+=ux*ux*eps;
-		    averageuy+=uy*uy*eps;
-		    averageueta+=ueta*ueta*eps*it*dtau*a*it*dtau*a;
-		    averageeps+=eps;
-
-		    count ++;
-                  }
-                
-	      }
-            
-	  }
+            // set to 'zero' if no flow velocity was found or the energy density is too small
+            if (foundU==0 || eps<=0.1)
+              {
+                u[0] = 1.; u[1] = 0.; u[2] = 0.; u[3] = 0.;
+              }
 
-	    // write Tmunu in case no u was found
-	    if ( foundU==0 ) 
-	      {
-                if(si==N/2 && sj==N/2)
-                  {	cout << si << " " << sj << endl << endl;
-                    cout << lat->cells[pos]->getTtautau() << " " << lat->cells[pos]->getTtaux() 
-                         << " " << lat->cells[pos]->getTtauy() << " " << lat->cells[pos]->getTtaueta() << endl;
-                    cout << lat->cells[pos]->getTtaux() << " " << lat->cells[pos]->getTxx() 
-                         << " " << lat->cells[pos]->getTxy() << " " << lat->cells[pos]->getTxeta() << endl;
-                    cout << lat->cells[pos]->getTtauy() << " " << lat->cells[pos]->getTxy() 
-                         << " " << lat->cells[pos]->getTyy() << " " << lat->cells[pos]->getTyeta() << endl;
-                    cout << lat->cells[pos]->getTtaueta() << " " << lat->cells[pos]->getTxeta() 
-                         << " " << lat->cells[pos]->getTyeta() << " " << lat->cells[pos]->getTetaeta() << endl;
-                    cout << "ux=" << ux << endl;
-                    cout << "uy=" << uy << endl;
-                    cout << "ueta=" << ueta << endl;
-                  }
+            const double utau = u[0];
+            const double ux = u[1];
+            const double uy = u[2];
+            const double ueta = u[3];
+
+            cell->setutau(utau);
+            cell->setux(ux);
+            cell->setuy(uy);
+            cell->setueta(ueta);
+            cell->setEpsilon(eps);
+
+            if (foundU>0)
+              {
+                averageux+=ux*ux*eps;
+                averageuy+=uy*uy*eps;
+                averageueta+=ueta*ueta*eps*tau2;
+                averageeps+=eps;
+                count ++;
               }
-	  
-	    // compute pi^{\mu\nu}
-	    if(utau==1 && ux ==0 && uy == 0 && ueta == 0)
-	      {
-		lat->cells[pos]->setpitautau(0.);
-		lat->cells[pos]->setpixx(0.);
-		lat->cells[pos]->setpiyy(0.);
-		lat->cells[pos]->setpietaeta(0.);
+            else if(si==N/2 && sj==N/2)
+              {
+                // write Tmunu in case no u was found
+                cout << si << " " << sj << endl << endl;
+                cout << cell->getTtautau() << " " << cell->getTtaux() 
+                     << " " << cell->getTtauy() << " " << cell->getTtaueta() << endl;
+                cout << cell->getTtaux() << " " << cell->getTxx() 
+                     << " " << cell->getTxy() << " " << cell->getTxeta() << endl;
+                cout << cell->getTtauy() << " " << cell->getTxy() 
+                     << " " << cell->getTyy() << " " << cell->getTyeta() << endl;
+                cout << cell->getTtaueta() << " " << cell->getTxeta() 
+                     << " " << cell->getTyeta() << " " << cell->getTetaeta() << endl;
+              }
+            
+            // compute pi^{\mu\nu}
+            if(utau==1 && ux ==0 && uy == 0 && ueta == 0)
+              {
+                cell->setpitautau(0.);
+                cell->setpixx(0.);
+                cell->setpiyy(0.);
+                cell->setpietaeta(0.);
 		
-		lat->cells[pos]->setpitaux(0.);
-		lat->cells[pos]->setpitauy(0.);
-		lat->cells[pos]->setpitaueta(0.);
+                cell->setpitaux(0.);
+                cell->setpitauy(0.);
+                cell->setpitaueta(0.);
 		
-		lat->cells[pos]->setpixeta(0.);
-		lat->cells[pos]->setpixy(0.);
-		lat->cells[pos]->setpiyeta(0.);
-	      }
-	    else
-	      {
-		lat->cells[pos]->setpitautau(lat->cells[pos]->getTtautau() - 4./3.*eps*utau*utau + eps/3.);
-		lat->cells[pos]->setpixx(lat->cells[pos]->getTxx() - 4./3.*eps*ux*ux - eps/3.);
-		lat->cells[pos]->setpiyy(lat->cells[pos]->getTyy() - 4./3.*eps*uy*uy - eps/3.);
-		lat->cells[pos]->setpietaeta(lat->cells[pos]->getTetaeta() - 4./3.*eps*ueta*ueta - eps/3./it/dtau/a/it/dtau/a);
+                cell->setpixeta(0.);
+                cell->setpixy(0.);
+                cell->setpiyeta(0.);
+              }
+            else
+              {
+                cell->setpitautau(cell->getTtautau() - 4./3.*eps*utau*utau + eps/3.);
+                cell->setpixx(cell->getTxx() - 4./3.*eps*ux*ux - eps/3.);
+                cell->setpiyy(cell->getTyy() - 4./3.*eps*uy*uy - eps/3.);
+                cell->setpietaeta(cell->getTetaeta() - 4./3.*eps*ueta*ueta - eps/3./tau2);
 		
-		lat->cells[pos]->setpitaux(lat->cells[pos]->getTtaux() - 4./3.*eps*utau*ux);
-		lat->cells[pos]->setpitauy(lat->cells[pos]->getTtauy() - 4./3.*eps*utau*uy);
-		lat->cells[pos]->setpitaueta(lat->cells[pos]->getTtaueta() - 4./3.*eps*utau*ueta);
+                cell->setpitaux(cell->getTtaux() - 4./3.*eps*utau*ux);
+                cell->setpitauy(cell->getTtauy() - 4./3.*eps*utau*uy);
+                cell->setpitaueta(cell->getTtaueta() - 4./3.*eps*utau*ueta);
 		
-		lat->cells[pos]->setpixeta(lat->cells[pos]->getTxeta() - 4./3.*eps*ux*ueta);
-		lat->cells[pos]->setpixy(lat->cells[pos]->getTxy() - 4./3.*eps*ux*uy);
-		lat->cells[pos]->setpiyeta(lat->cells[pos]->getTyeta() - 4./3.*eps*uy*ueta);
-	      }
-	    
-	    gsl_vector_complex_free (eval);
-	    gsl_matrix_complex_free (evec);
-	
-	}
-    }
+                cell->setpixeta(cell->getTxeta() - 4./3.*eps*ux*ueta);
+                cell->setpixy(cell->getTxy() - 4./3.*eps*ux*uy);
+                cell->setpiyeta(cell->getTyeta() - 4./3.*eps*uy*ueta);
+              }
+          }
+      }
+  }
 
   cout << it*dtau*a << " average u^x=" << sqrt(averageux/averageeps) << endl;
   cout << it*dtau*a << " average u^y=" << sqrt(averageuy/averageeps) << endl;
@@ -279,6 +351,7 @@ void MyEigen::flowVelocity4D(Lattice *lat, Group *group, Parameters *param, int
       if(hL>L)
 	cout << "WARNING: hydro grid length larger than the computed one." << endl;
       
+      int pos;
       int xpos, ypos, xposUp, yposUp, pos1, pos2, pos3;
       double fracx, fracy, x1, x2;
       double xlow, xhigh, ylow, yhigh;
@@ -11,6 +11,8 @@
 #include <fstream>
 #include <iomanip>
 #include <complex>
+#include <vector>
+#include <cmath>
 
 #include "gsl/gsl_eigen.h"
 #include "gsl/gsl_complex.h"
@@ -37,7 +39,12 @@ class MyEigen {
     { 
     };
   
+  // number of Rayleigh quotient iterations and relative residual accepted in the Landau matching
+  static const int landauIterations = 6;
+  static constexpr double landauTolerance = 1e-9;
+
   void test();
+  int landauMatchGSL(double *data, double tau2, double Ttautau, int si, int sj, int N, double &eps, double *u);
   void flowVelocity4D(Lattice *lat, Group *group, Parameters *param, int it);
 
 
@@ -0,0 +1,285 @@
+// Observables.cpp is part of the IP-Glasma solver.
+#include "Observables.h"
+#include <zlib.h>
+
+//**************************************************************************
+// Observables class.
+
+Observables::Observables()
+{
+  stopWriter = false;
+  writeMoments = 0;
+  writeSnapshots = 0;
+  writer = thread(&Observables::writerLoop, this);
+}
+
+Observables::~Observables()
+{
+  {
+    lock_guard<mutex> lock(queueMutex);
+    stopWriter = true;
+  }
+  queueCondition.notify_all();
+  writer.join();
+}
+
+void Observables::beginEvent(Lattice *lat, Parameters *param)
+{
+  flush();
+  writeMoments = param->getWriteMoments();
+  writeSnapshots = param->getWriteSnapshots();
+
+  int N = param->getSize();
+  gfactor.clear();
+  if (param->getRunningCoupling() && (writeMoments>0 || writeSnapshots>0))
+    {
+      gfactor.resize(N*N);
+      for (int pos=0; pos<N*N; pos++)
+        gfactor[pos] = runningCouplingFactor(lat,param,pos);
+    }
+  if (writeMoments>0)
+    cellEnergy.resize(N*N);
+
+  stringstream strmom_name;
+  strmom_name << "moments" << param->getMPIRank() << ".dat";
+  momentsName = strmom_name.str();
+
+  if (writeMoments>0)
+    {
+      Job job;
+      job.fileName = momentsName;
+      job.append = !firstWrite(momentsName);
+      job.compressed = false;
+      stringstream head;
+      head << "# event with random seed " << param->getRandomSeed() << endl
+           << "# tau [fm]  dE/deta [GeV]  <x> [fm]  <y> [fm]  eps_2  Psi_2  eps_3  Psi_3" << endl;
+      job.text = head.str();
+      enqueue(job);
+    }
+}
+
+// true the first time a file is written by this job, so that output of earlier runs is overwritten
+bool Observables::firstWrite(const string &fileName)
+{
+  return written.insert(fileName).second;
+}
+
+double Observables::runningCouplingFactor(Lattice *lat, Parameters *param, int pos)
+{
+  int N = param->getSize();
+  double a = param->getL()/N; // lattice spacing in fm
+  double g = param->getg();
+  double c = param->getc();
+  double muZero = param->getMuZero();
+  double g2mu2A, g2mu2B, Qs = 0., alphas = 0.;
+
+  if(pos>0 && pos<(N-1)*N+N-1)
+    {
+      g2mu2A = lat->cells[pos]->getg2mu2A();
+      g2mu2B = lat->cells[pos]->getg2mu2B();
+    }
+  else
+    g2mu2A = g2mu2B = 0;
+
+  if(param->getRunWithQs()==2)
+    {
+      if(g2mu2A > g2mu2B)
+        Qs = sqrt(g2mu2A*param->getQsmuRatio()*param->getQsmuRatio()/a/a*0.1973269718*0.1973269718*g*g);
+      else
+        Qs = sqrt(g2mu2B*param->getQsmuRatio()*param->getQsmuRatio()/a/a*0.1973269718*0.1973269718*g*g);
+    }
+  else if(param->getRunWithQs()==0)
+    {
+      if(g2mu2A < g2mu2B)
+        Qs = sqrt(g2mu2A*param->getQsmuRatio()*param->getQsmuRatio()/a/a*0.1973269718*0.1973269718*g*g);
+      else
+        Qs = sqrt(g2mu2B*param->getQsmuRatio()*param->getQsmuRatio()/a/a*0.1973269718*0.1973269718*g*g);
+    }
+  else if(param->getRunWithQs()==1)
+    {
+      Qs = sqrt((g2mu2A+g2mu2B)/2.*param->getQsmuRatio()*param->getQsmuRatio()/a/a*0.1973269718*0.1973269718*g*g);
+    }
+
+  if ( param->getRunWithLocalQs() == 1 )
+    {
+      // 3 flavors, run with the local (in transverse plane) coupling
+      alphas = 4.*PI/(9.* log(pow(pow(muZero/0.2,2./c) + pow(param->getRunWithThisFactorTimesQs()*Qs/0.2,2./c),c)));
+    }
+  else
+    {
+      if ( param->getRunWithQs() == 0 )
+        alphas = 4.*PI/(9.* log(pow(pow(muZero/0.2,2./c) + pow(param->getRunWithThisFactorTimesQs()*param->getAverageQsmin()/0.2,2./c),c)));
+      else if ( param->getRunWithQs() == 1 )
+        alphas = 4.*PI/(9.* log(pow(pow(muZero/0.2,2./c) + pow(param->getRunWithThisFactorTimesQs()*param->getAverageQsAvg()/0.2,2./c),c)));
+      else if ( param->getRunWithQs() == 2 )
+        alphas = 4.*PI/(9.* log(pow(pow(muZero/0.2,2./c) + pow(param->getRunWithThisFactorTimesQs()*param->getAverageQs()/0.2,2./c),c)));
+    }
+
+  return g*g/(4.*PI*alphas);
+}
+
+void Observables::enqueue(Job &job)
+{
+  {
+    lock_guard<mutex> lock(queueMutex);
+    queue.push_back(Job());
+    swap(queue.back(), job);
+  }
+  // flush() waits on the same condition
+  queueCondition.notify_all();
+}
+
+void Observables::flush()
+{
+  unique_lock<mutex> lock(queueMutex);
+  queueCondition.wait(lock, [this]{ return queue.empty(); });
+}
+
+void Observables::writerLoop()
+{
+  unique_lock<mutex> lock(queueMutex);
+  while (true)
+    {
+      queueCondition.wait(lock, [this]{ return stopWriter || !queue.empty(); });
+      if (queue.empty() && stopWriter)
+        break;
+
+      // leave the job in the queue while writing so that flush() waits for it
+      Job &job = queue.front();
+      lock.unlock();
+
+      if (job.compressed)
+        {
+          gzFile out = gzopen(job.fileName.c_str(), job.append ? "ab" : "wb");
+          if (out == NULL)
+            cerr << "[Observables] could not open " << job.fileName << endl;
+          else
+            {
+              gzwrite(out, job.header, sizeof(job.header));
+              gzwrite(out, job.headerf, sizeof(job.headerf));
+              gzwrite(out, job.data.data(), job.data.size()*sizeof(float));
+              gzclose(out);
+            }
+        }
+      else
+        {
+          ofstream out(job.fileName.c_str(), job.append ? ios::app : ios::out);
+          out << job.text;
+          out.close();
+        }
+
+      lock.lock();
+      queue.pop_front();
+      queueCondition.notify_all();
+    }
+}
+
+void Observables::recordMoments(Parameters *param, double tau)
+{
+  if (writeMoments==0)
+    return;
+
+  int N = param->getSize();
+  double L = param->getL();
+  double a = L/N; // lattice spacing in fm
+  double tauPhys = tau*a;
+  const double *eps = &cellEnergy[0];
+
+  // center of the energy density
+  double s0 = 0., sx = 0., sy = 0.;
+#pragma omp parallel for reduction(+:s0,sx,sy)
+  for (int pos=0; pos<N*N; pos++)
+    {
+      s0 += eps[pos];
+      sx += eps[pos]*(-L/2.+a*(pos/N));
+      sy += eps[pos]*(-L/2.+a*(pos%N));
+    }
+  if (s0<=0.)
+    return;
+  const double avx = sx/s0;
+  const double avy = sy/s0;
+
+  // moments with respect to the center, normalized by <r^n> as in Evolution::eccentricity
+  double avrSq = 0., avr3 = 0., avcos = 0., avsin = 0., avcos3 = 0., avsin3 = 0.;
+#pragma omp parallel for reduction(+:avrSq,avr3,avcos,avsin,avcos3,avsin3)
+  for (int pos=0; pos<N*N; pos++)
+    {
+      const double x = -L/2.+a*(pos/N)-avx;
+      const double y = -L/2.+a*(pos%N)-avy;
+      const double x2 = x*x;
+      const double y2 = y*y;
+      const double rSq = x2+y2;
+      avrSq += eps[pos]*rSq;
+      avr3 += eps[pos]*rSq*sqrt(rSq);
+      avcos += eps[pos]*(x2-y2);           // r^2 cos(2 phi)
+      avsin += eps[pos]*2.*x*y;            // r^2 sin(2 phi)
+      avcos3 += eps[pos]*x*(x2-3.*y2);     // r^3 cos(3 phi)
+      avsin3 += eps[pos]*y*(3.*x2-y2);     // r^3 sin(3 phi)
+    }
+
+  // dE/deta = tau * int d^2x_T eps, eps is in lattice units (a^-4) here
+  double dEdeta = tauPhys*s0/a/a*param->gethbarc();
+  double eps2 = 0., eps3 = 0., Psi2 = 0., Psi3 = 0.;
+  if (avrSq>0.)
+    {
+      eps2 = sqrt(avcos*avcos+avsin*avsin)/avrSq;
+      eps3 = sqrt(avcos3*avcos3+avsin3*avsin3)/avr3;
+      Psi2 = (atan2(avsin,avcos)+param->getPi())/2.;
+      Psi3 = (atan2(avsin3,avcos3)+param->getPi())/3.;
+    }
+
+  Job job;
+  job.fileName = momentsName;
+  job.append = true;
+  job.compressed = false;
+  stringstream line;
+  line << tauPhys << " " << dEdeta << " " << avx << " " << avy << " "
+       << eps2 << " " << Psi2 << " " << eps3 << " " << Psi3 << endl;
+  job.text = line.str();
+  enqueue(job);
+}
+
+void Observables::recordSnapshot(Lattice *lat, Parameters *param, int it, const string &name)
+{
+  if (writeSnapshots==0)
+    return;
+
+  const int nFields = 5;
+  int N = param->getSize();
+  double L = param->getL();
+  double a = L/N; // lattice spacing in fm
+
+  Job job;
+  stringstream strsnap_name;
+  strsnap_name << name << param->getMPIRank() << ".bin.gz";
+  job.fileName = strsnap_name.str();
+  job.append = !firstWrite(job.fileName);
+  job.compressed = true;
+  job.header[0] = 0x53475049; // "IPGS"
+  job.header[1] = N;
+  job.header[2] = nFields;
+  job.header[3] = it;
+  job.headerf[0] = L;
+  job.headerf[1] = it*param->getdtau()*a;
+
+  // fields one after the other: epsilon [GeV/fm^3], u^tau, u^x, u^y, u^eta
+  job.data.resize(nFields*N*N);
+  float *eps = &job.data[0];
+  float *utau = &job.data[N*N];
+  float *ux = &job.data[2*N*N];
+  float *uy = &job.data[3*N*N];
+  float *ueta = &job.data[4*N*N];
+  const double hbarcGeV = param->gethbarc();
+
+#pragma omp parallel for
+  for (int pos=0; pos<N*N; pos++)
+    {
+      eps[pos] = hbarcGeV*getGfactor(pos)*lat->cells[pos]->getEpsilon();
+      utau[pos] = lat->cells[pos]->getutau();
+      ux[pos] = lat->cells[pos]->getux();
+      uy[pos] = lat->cells[pos]->getuy();
+      ueta[pos] = lat->cells[pos]->getueta();
+    }
+
+  enqueue(job);
+}
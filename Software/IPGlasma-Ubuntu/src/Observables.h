@@ -0,0 +1,98 @@
+// Observables.h is part of the IP-Glasma solver.
+// On-the-fly observables: moments of the energy density accumulated during the
+// evolution and full-field snapshots written by a background thread.
+
+#ifndef Observables_H
+#define Observables_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <complex>
+#include <vector>
+#include <deque>
+#include <string>
+#include <set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "Lattice.h"
+#include "Parameters.h"
+#include "Matrix.h"
+#include "Util.h"
+
+using namespace std;
+
+class Observables {
+
+ private:
+  // one unit of work for the writer thread
+  struct Job
+  {
+    string fileName;
+    bool append;
+    bool compressed;
+    string text;         // written as is
+    vector<float> data;  // binary payload (snapshots)
+    int header[4];       // magic, N, number of fields, iteration
+    float headerf[2];    // L, tau
+  };
+
+  thread writer;
+  mutex queueMutex;
+  condition_variable queueCondition;
+  deque<Job> queue;
+  bool stopWriter;
+
+  int writeMoments;
+  int writeSnapshots;
+  string momentsName;
+
+  vector<double> gfactor;     // running coupling factor of each cell, empty without runningCoupling
+  vector<double> cellEnergy;  // energy density of each cell (lattice units), filled by Evolution::evolveE
+  set<string> written;        // files written by this job so far, truncated on their first write
+
+  void writerLoop();
+  void enqueue(Job &job);
+  bool firstWrite(const string &fileName);
+
+ public:
+  Observables();
+  ~Observables();
+
+  // set up output for a new event (file names depend on the MPI rank)
+  void beginEvent(Lattice *lat, Parameters *param);
+  // wait until everything handed to the writer is on disk
+  void flush();
+
+  bool getWriteMoments() { return writeMoments>0; }
+  bool getWriteSnapshots() { return writeSnapshots>0; }
+  // where evolveE stores the energy density of each cell, NULL without writeMoments
+  double *getCellEnergy() { return writeMoments>0 ? &cellEnergy[0] : NULL; }
+  // factor g^2/(4 pi alpha_s) applied to epsilon under runningCoupling, 1 otherwise
+  double getGfactor(int pos) { return gfactor.empty() ? 1. : gfactor[pos]; }
+
+  // the running coupling factor of one cell, as in Evolution::eccentricity
+  static double runningCouplingFactor(Lattice *lat, Parameters *param, int pos);
+
+  // energy density (lattice units) of one cell, as in Evolution::Tmunu but from single links only
+  static double traceSquare(const Matrix &A, int Nc)
+  {
+    double result = 0.;
+    for (int i=0; i<Nc; i++)
+      for (int j=0; j<Nc; j++)
+        result += real(A(i,j)*A(j,i));
+    return result;
+  }
+
+  // dE/deta, center and eccentricities from the cell energies, handed to the writer
+  void recordMoments(Parameters *param, double tau);
+  // copy epsilon and u^mu of all cells and write them as a compressed binary record
+  void recordSnapshot(Lattice *lat, Parameters *param, int it, const string &name);
+};
+
+#endif // Observables_H
@@ -59,6 +59,8 @@ class Parameters
   double xExponent; // - exponent with which Q_s grows with x (usually 0.31 in IP-Sat for nuclei)
   int writeOutputs; // decide whether to write (1) or not write (0) large output files (like hydro input data)
   int writeEvolution; // decide whether to write (1) or not write (0) time dependent quantities like the anisotropy 
+  int writeMoments; // decide whether to write (1) or not write (0) energy weighted moments and eccentricities at every time step
+  int writeSnapshots; // decide whether to write (1) or not write (0) compressed binary snapshots of epsilon and u^mu
   int writeInitialWilsonLines; // decide whether to write (1) or not write (0) generated Wilson lines (before any evolution)
   unsigned long long int randomSeed; // stores the random seed used (so the event can be reproduced)
   string NucleusQsTableFileName; // the file name for the table containing Qs^2 as a function of Y and Qs^2(Y=0)
@@ -91,6 +93,7 @@ class Parameters
   int useNucleus;   // use nuclei (1) or a constant g^2mu distribution over the lattice 
   double dtau;      // time step in lattice units
   double maxtime;   // maximal evolution time in fm/c
+  double gaugeFixTolerance; // Coulomb gauge fixing stops once the mean squared divergence is below this
   int Npart;        // Number of participants
   int averageOverNuclei; // average over this many nuclei to get a smooth(er) distribution
   int nucleonPositionsFromFile; // switch to determine whether to sample nucleon positions (0) or read them from a file (1)
@@ -101,8 +104,10 @@ class Parameters
   int smearQs;       // decide whether to smear Q_s using a Poisson distribution around its mean at every x_T (1) or not (0)
   double smearingWidth; // width of the Gaussian smearing around the mean g^2mu^2
   int gaussianWounding; // use hard sphere profile (0) or Gaussian cross section (1) to determine whether a nucleon is wounded
-  int MPIrank; // MPI rank
+  int MPIrank; // MPI rank, while an event is run the event number that labels its output files
+  int MPIworldRank; // MPI rank of this process
   int MPIsize; // MPI number of cores
+  int nEvents; // number of events to run in this job, distributed over the ranks on demand (0: one event per rank)
   int success; // no collision happened (0) or collision happened (1) - used to restart if there was no collision
   int readMultFromFile; // if set, the gluon distribution as a function of k_T is read from file and the integrated rate computed
   double rmax; // radius at which we cut distribution for each nucleon (in fm)
@@ -201,6 +206,8 @@ class Parameters
   double getMaxtime() {return maxtime;}
   void setdtau(double x) {dtau=x;}
   double getdtau() {return dtau;}
+  void setGaugeFixTolerance(double x) {gaugeFixTolerance=x;}
+  double getGaugeFixTolerance() {return gaugeFixTolerance;}
   void setNpart(int x) {Npart=x;};
   int getNpart() {return Npart;}
   void setAverageQs(double x) {averageQs=x;}
@@ -259,8 +266,12 @@ class Parameters
   double getSmearingWidth() {return smearingWidth;}
   void setMPIRank(int x) {MPIrank=x;}
   int getMPIRank() {return MPIrank;}
+  void setMPIWorldRank(int x) {MPIworldRank=x;}
+  int getMPIWorldRank() {return MPIworldRank;}
   void setMPISize(int x) {MPIsize=x;}
   int getMPISize() {return MPIsize;}
+  void setNEvents(int x) {nEvents=x;}
+  int getNEvents() {return nEvents;}
   void setSuccess(int x) {success=x;}
   int getSuccess() {return success;}
   void setRmax(double x) {rmax=x;}
@@ -286,6 +297,10 @@ class Parameters
   int getWriteOutputs() {return writeOutputs;}
   void setWriteEvolution(int x) {writeEvolution=x;};
   int getWriteEvolution() {return writeEvolution;}
+  void setWriteMoments(int x) {writeMoments=x;};
+  int getWriteMoments() {return writeMoments;}
+  void setWriteSnapshots(int x) {writeSnapshots=x;};
+  int getWriteSnapshots() {return writeSnapshots;}
   void setWriteInitialWilsonLines(int x) {writeInitialWilsonLines=x;}
   int getWriteInitialWilsonLines(){ return writeInitialWilsonLines; }
   void setNucleonPositionsFromFile(int x) {nucleonPositionsFromFile=x;}
@@ -61,6 +61,7 @@
 /* initializes mt[NN] with a seed */
 void Random::init_genrand64(unsigned long long seed)
 {
+    iset = 0; // drop a cached Gaussian from the previous stream
     mt[0] = seed;
     for (mti=1; mti<NN; mti++) 
         mt[mti] =  (6364136223846793005ULL * (mt[mti-1] ^ (mt[mti-1] >> 62)) + mti);
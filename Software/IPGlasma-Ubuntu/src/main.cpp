@@ -19,6 +19,7 @@
 #include "Spinor.h"
 #include "MyEigen.h"
 #include "Fragmentation.h"
+#include "EventScheduler.h"
 
 #define _SECURE_SCL 0
 #define _HAS_ITERATOR_DEBUGGING 0
@@ -52,7 +53,7 @@ int main(int argc, char *argv[])
       cout << "-----------------------------------------------------------------------------" << endl;
       
       cout << "This version uses Qs as obtained from IP-Sat using the sum over proton T_p(b)" << endl;
-      cout << "This is a simple MPI version that runs many events in one job. No communication." << endl;
+      cout << "This MPI version runs many events in one job. Events are handed to ranks on demand (nEvents)." << endl;
       
       cout << "Run using large lattices to improve convergence of the root finder in initial condition. Recommended: 600x600 using L=30fm" << endl;
       cout << endl;
@@ -71,6 +72,7 @@ int main(int argc, char *argv[])
   param = new Parameters();
 
   param->setMPIRank(rank);
+  param->setMPIWorldRank(rank);
   param->setMPISize(size);
   param->setSuccess(0);
 
@@ -231,13 +233,7 @@ int main(int argc, char *argv[])
       // ofstream foutAni(aniso_name.c_str(),ios::out); 
       // foutAni.close();
       
-      stringstream strecc_name;
-      strecc_name << "eccentricities" << param->getMPIRank() << ".dat";
-      string ecc_name;
-      ecc_name = strecc_name.str();
-      
-      ofstream foutEcc(ecc_name.c_str(),ios::out); 
-      foutEcc.close();
+      // eccentricities<event>.dat is cleaned when the event starts
             
       // stringstream strmult_name;
       // strmult_name << "multiplicity" << param->getMPIRank() << ".dat";
@@ -269,14 +265,65 @@ int main(int argc, char *argv[])
 
     }
   
-  while(param->getSuccess()==0)
+  // events are handed out on demand. nEvents 0 runs exactly one event per rank (event = rank).
+  EventScheduler *scheduler;
+  scheduler = new EventScheduler(param->getNEvents(), rank);
+  int nEvents = param->getNEvents();
+  if (nEvents<=0)
+    nEvents = size;
+
+  // seeds from a list are indexed by the event number
+  vector<unsigned long long int> seedList;
+  if(param->getUseSeedList()==1)
     {
-      param->setSuccess(0);
-      // allocate lattice
-      Lattice *lat;
-      lat = new Lattice(param, param->getNc(), param->getSize());
-      BufferLattice *bufferlat;
-      bufferlat = new BufferLattice(param, param->getNc(), param->getSize());
+      ifstream fin;
+      fin.open("seedList"); 
+      if(fin)
+	{	 
+	  for (int i=0; i<nEvents; i++)
+	    {
+	      unsigned long long int seedIn;
+	      if (fin >> seedIn)
+		{  
+		  seedList.push_back(seedIn);
+		}
+	      else
+		{
+		  cerr << "Error: Not enough random seeds for the number of events selected. Exiting." << endl;
+		  exit(1);
+		}
+	    }
+	}
+      else
+	{
+	  cerr << "Random seed file 'seedList' not found. Exiting." << endl;
+	  exit(1);
+	}
+      fin.close();
+    }
+
+  // the lattices are allocated once and reused for all events on this rank
+  Lattice *lat;
+  lat = new Lattice(param, param->getNc(), param->getSize());
+  BufferLattice *bufferlat;
+  bufferlat = new BufferLattice(param, param->getNc(), param->getSize());
+
+  unsigned long long int timeForSeed = time(0);
+  int event;
+  while((event = scheduler->next()) >= 0)
+    {
+      // all output files of an event are labelled by the event number (equal to the rank for nEvents 0)
+      param->setMPIRank(event);
+      
+      if(param->getReadMultFromFile()!=1)
+	{
+	  stringstream strecc_name;
+	  strecc_name << "eccentricities" << event << ".dat";
+	  string ecc_name;
+	  ecc_name = strecc_name.str();
+	  ofstream foutEcc(ecc_name.c_str(),ios::out); 
+	  foutEcc.close();
+	}
 
       //initialize random generator using time and seed from input file
       unsigned long long int rnum;
@@ -285,89 +332,67 @@ int main(int argc, char *argv[])
 	{
 	  if(param->getUseTimeForSeed()==1)
 	    {
-	      rnum=time(0)+param->getSeed()*10000;
+	      rnum=timeForSeed+param->getSeed()*10000;
 	    }
 	  else
 	    {
 	      rnum = param->getSeed();
-	      cout << "Random seed = " << rnum+(rank*1000) << " - entered directly +rank*1000."  << endl;
+	      cout << "Random seed = " << rnum+(event*1000) << " - entered directly +event*1000."  << endl;
 	    }
 	  
-	  param->setRandomSeed(rnum+rank*1000);
+	  param->setRandomSeed(rnum+event*1000);
 	  if(param->getUseTimeForSeed()==1)
 	    {
 	      cout << "Random seed = " << param->getRandomSeed() << " made from time " 
-		   << rnum-param->getSeed()-(rank*1000) << " and argument (+1000*rank) " 
-		   << param->getSeed()+(rank*1000) << endl;
+		   << rnum-param->getSeed()*10000 << " and argument (+1000*event) " 
+		   << param->getSeed()+(event*1000) << endl;
 	    }
-	  
-	  random->init_genrand64(rnum+rank*1000);
 	}
       else
 	{
-	  ifstream fin;
-	  fin.open("seedList"); 
-	  unsigned long long int seedList[size];
-	  if(fin)
-	    {	 
-	      for (int i=0; i<size; i++)
-		{
-		  if (!fin.eof())
-		    {  
-		      fin >> seedList[i];
-		    }
-		  else
-		    {
-		      cerr << "Error: Not enough random seeds for the number of processors selected. Exiting." << endl;
-		      exit(1);
-		    }
-		}
-	    }
-	  else
-	    {
-	      cerr << "Random seed file 'seedList' not found. Exiting." << endl;
-	      exit(1);
-	    }
-	  fin.close();
-	  //cout << size << " seeds read from file." << endl;
-
-	  param->setRandomSeed(seedList[rank]);
-	  random->init_genrand64(seedList[rank]);
-	  cout << "Random seed on rank " << rank << " = " << seedList[rank] << " read from list."  << endl;
+	  param->setRandomSeed(seedList[event]);
+	  cout << "Random seed for event " << event << " = " << seedList[event] << " read from list."  << endl;
 	}
-      
+      random->init_genrand64(param->getRandomSeed());
 
-      
       ofstream fout1(up_name.c_str(),ios::app); 
-      fout1 << "Random seed used on rank " << rank << ": " << param->getRandomSeed() << endl;
+      fout1 << "Random seed used on rank " << rank << " for event " << event << ": " << param->getRandomSeed() << endl;
       fout1.close();
       
-      // initialize gsl random number generator (used for non-Gaussian distributions)
-      //random->gslRandomInit(rnum);
-      
-      // initialize U-fields on the lattice
-      //      init->init(lat, group, param, random, glauber);
-      int READFROMFILE = 0;
-      init->init(lat, group, param, random, glauber, READFROMFILE);
-      cout << " done." << endl;
-
-      if(param->getSuccess()==0)
+      // initialize U-fields on the lattice, retry until a valid configuration was found
+      double startTime = MPI_Wtime();
+      int attempts = 0;
+      param->setSuccess(0);
+      while(param->getSuccess()==0)
 	{
-	  delete lat;
-          delete bufferlat;
-	  continue;
+	  attempts++;
+	  if (attempts>1)
+	    lat->reset();
+	  int READFROMFILE = 0;
+	  init->init(lat, group, param, random, glauber, READFROMFILE);
+	  cout << " done." << endl;
 	}
-
-      delete init;
-      delete random;
-      delete glauber;
+      double initTime = MPI_Wtime()-startTime;
 
       // do the CYM evolution of the initialized fields using parmeters in param
+      startTime = MPI_Wtime();
       evolution->run(lat, bufferlat,  group, param);
-      delete bufferlat;
-      delete lat;
+      double evolutionTime = MPI_Wtime()-startTime;
+
+      scheduler->record(event, param->getRandomSeed(), attempts, initTime, evolutionTime);
+      lat->reset();
     }
 
+  param->setMPIRank(rank);
+  scheduler->summary();
+
+  delete bufferlat;
+  delete lat;
+  delete scheduler;
+  delete init;
+  delete random;
+  delete glauber;
+
   MPI_Barrier(MPI_COMM_WORLD);
        
   delete group;
@@ -444,6 +469,7 @@ int readInput(Setup *setup, Parameters *param, int argc, char *argv[], int rank)
   param->setg2mu(setup->DFind(file_name,"g2mu"));
   param->setMaxtime(setup->DFind(file_name,"maxtime"));
   param->setdtau(setup->DFind(file_name,"dtau"));
+  param->setGaugeFixTolerance(setup->DFind(file_name,"gaugeFixTolerance"));
   // param->setxExponent(setup->DFind(file_name,"xExponent")); //  is now obsolete
   param->setRunWithQs(setup->IFind(file_name,"runWith0Min1Avg2MaxQs"));
   param->setRunWithkt(setup->IFind(file_name,"runWithkt"));
@@ -454,6 +480,9 @@ int readInput(Setup *setup, Parameters *param, int argc, char *argv[], int rank)
   param->setWriteOutputs(setup->IFind(file_name,"writeOutputs"));
   param->setWriteEvolution(setup->IFind(file_name,"writeEvolution"));
   param->setWriteInitialWilsonLines(setup->IFind(file_name, "writeInitialWilsonLines"));
+  param->setWriteMoments(setup->IFind(file_name,"writeMoments"));
+  param->setWriteSnapshots(setup->IFind(file_name,"writeSnapshots"));
+  param->setNEvents(setup->IFind(file_name,"nEvents"));
   param->setAverageOverNuclei(setup->IFind(file_name,"averageOverThisManyNuclei"));
   param->setUseTimeForSeed(setup->IFind(file_name,"useTimeForSeed"));
   param->setUseFixedNpart(setup->IFind(file_name,"useFixedNpart"));
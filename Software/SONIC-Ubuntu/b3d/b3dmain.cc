@@ -3,38 +3,82 @@
 
 using namespace std;
 
+// runs neventsmax events of the surface read last, returns the summed dNch/dy
+double RunEvents(CB3D *b3d,int neventsmax){
+	double dnchdy=0.0;
+	int nparts,ievent;
+	for(ievent=0;ievent<neventsmax;ievent++){
+		nparts=b3d->hydrotob3d->MakeEventPR();
+		b3d->PerformAllActions();
+		dnchdy+=b3d->WriteDataH5();
+		printf("##### finished event %d ##### dNch/dy=%g #####\n",b3d->ievent_write,double(dnchdy)/double(ievent+1));
+		printf("nscatter=%g, ninelastic=%g, nmerges=%g, ncellexits=%g\n",double(b3d->nscatter),double(b3d->ninelastic),double(b3d->nmerge),double(b3d->nexit));
+		cout << "Elastic Scattering: " << b3d->nscatter << " Inelastic Scatter: " << b3d->ninelastic << " Merges: " << b3d->nmerge << endl;
+		//cout << "Total collisions: " << b3d->ncollision << endl;
+		// printf("nactivate=%lld, nexit/N=%g, nscatter/N=%g, nmerge/N=%g, ndecay/N=%g,\n", b3d->nactivate,double(b3d->nexit)/N,double(b3d->nscatter)/N,double(b3d->nmerge)/N,double(b3d->ndecay)/N);
+		// printf("ncheck=%lld, nscatter=%lld, npass=%lld\n",b3d->ncheck,b3d->nscatter,b3d->npass);
+	}
+	return dnchdy;
+}
+
+// Event-loop mode: every line of surface_list reads
+//     qualifier surface_file seed
+// (lines starting with # are skipped). The resonances, the cell lattice and
+// the particle and action pools are set up once; for every line the surface
+// (freezeout_bulk.dat format) replaces the previous one, the random streams
+// restart from seed and B3D_NEVENTSMAX oversampled events are written to
+// output/run_name/qualifier/b3d.h5. A surface can be oversampled with several
+// seeds by listing it under different qualifiers.
+void RunSurfaceList(CB3D *b3d,string surfacelistname,int neventsmax){
+	char line[1000],qualifier[200],surfacename[800];
+	int seed,nsurfaces=0;
+	FILE *fptr=fopen(surfacelistname.c_str(),"r");
+	if(fptr==NULL){
+		printf("cannot open surface list %s\n",surfacelistname.c_str());
+		exit(1);
+	}
+	while(fgets(line,1000,fptr)!=NULL){
+		if(line[0]=='#' || sscanf(line,"%199s %799s %d",qualifier,surfacename,&seed)!=3)
+			continue;
+		printf("----- surface %s, seed=%d -> %s -----\n",surfacename,seed,qualifier);
+		b3d->SetQualifier(qualifier);
+		b3d->SetSeed(seed);
+		if(!b3d->hydrotob3d->ReadSurfacePR(surfacename,true)){
+			printf("cannot open surface %s\n",surfacename);
+			exit(1);
+		}
+		RunEvents(b3d,neventsmax);
+		nsurfaces+=1;
+	}
+	fclose(fptr);
+	printf("finished %d surfaces\n",nsurfaces);
+}
+
 int main(int argc, char *argv[]){
-	if (argc != 2) {
-		printf("Usage: b3d run_name\n");
+	if (argc != 2 && argc != 3) {
+		printf("Usage: b3d run_name [surface_list]\n");
 		exit(-1);
   }
-	double dnchdy=0.0;
-	int nparts;
-	int ievent=0,iqual,neventsmax;
+	int iqual,neventsmax;
 	string run_name=argv[1];
 	CB3D *b3d=new CB3D(run_name);
 	CQualifiers qualifiers;
-	qualifiers.Read("qualifiers.dat");
 	neventsmax=parameter::getI(b3d->parmap,"B3D_NEVENTSMAX",10);
 	//b3d->randy->reset(-time(NULL));
   
-	for(int iqual=0;iqual<qualifiers.nqualifiers;iqual++){
-		dnchdy=0;
-		b3d->SetQualifier(qualifiers.qualifier[iqual]);
-		qualifiers.SetPars(&(b3d->parmap),iqual);
-		b3d->hydrotob3d->ReadInputPR();
-		for(ievent=0;ievent<neventsmax;ievent++){
-			nparts=b3d->hydrotob3d->MakeEventPR();
-			b3d->PerformAllActions();
-      dnchdy+=b3d->WriteDataH5();
-      printf("##### finished event %d ##### dNch/dy=%g #####\n",b3d->ievent_write,double(dnchdy)/double(ievent+1));
-			printf("nscatter=%g, ninelastic=%g, nmerges=%g, ncellexits=%g\n",double(b3d->nscatter),double(b3d->ninelastic),double(b3d->nmerge),double(b3d->nexit));
-      cout << "Elastic Scattering: " << b3d->nscatter << " Inelastic Scatter: " << b3d->ninelastic << " Merges: " << b3d->nmerge << endl;
-			//cout << "Total collisions: " << b3d->ncollision << endl;
-			// printf("nactivate=%lld, nexit/N=%g, nscatter/N=%g, nmerge/N=%g, ndecay/N=%g,\n", b3d->nactivate,double(b3d->nexit)/N,double(b3d->nscatter)/N,double(b3d->nmerge)/N,double(b3d->ndecay)/N);
-      // printf("ncheck=%lld, nscatter=%lld, npass=%lld\n",b3d->ncheck,b3d->nscatter,b3d->npass);
+	if(argc==3)
+		RunSurfaceList(b3d,argv[2],neventsmax);
+	else{
+		qualifiers.Read("qualifiers.dat");
+		for(iqual=0;iqual<qualifiers.nqualifiers;iqual++){
+			b3d->SetQualifier(qualifiers.qualifier[iqual]);
+			qualifiers.SetPars(&(b3d->parmap),iqual);
+			b3d->hydrotob3d->ReadInputPR();
+			RunEvents(b3d,neventsmax);
 		}
 	}
+	// closes b3d.h5, after the writer thread of B3D_H5_WRITERTHREAD is done
+	delete b3d;
   
 	return 0;
 }
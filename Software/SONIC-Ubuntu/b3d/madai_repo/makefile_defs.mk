@@ -12,6 +12,8 @@ MADAI_CPP = $(shell which g++-4.8)
 #compiler
 MADAI_INSTALLDIR = $(B3DMAINDIR)/install
 #location of where you want things installed
-MADAI_CFLAGS = -O2
+MADAI_CFLAGS = -O2 -fopenmp
 #MADAI_CFLAGS = -O
 #compiler optimization flags, usually -O2 for linux, -fast for OSX with g++
+#-fopenmp runs the domains of the parallel b3d cascade (B3D_NDOMAINS>1) and the sampling of
+#the hydro surface on several threads
@@ -41,7 +41,7 @@ double CAnalyze::CalcSpectra_PHENIX(){
 	printf("CAnalyze::CalcSpectra, opening %s\n",h5_infilename.c_str());
 	h5file=new H5File(h5_infilename,H5F_ACC_RDONLY);
 	
-	nevents=int(h5file->getNumObjs());
+	nevents=GetNEventsH5();
 		//printf("nevents=%d\n",nevents);
 	if(nevents>neventsmax) nevents=neventsmax;
 	double meanpt_pion=0.0,meanpt_kaon=0.0,meanpt_proton=0.0,meanpt_omega=0.0;
@@ -283,7 +283,7 @@ void CAnalyze::CalcSpectra_PHENIXppbar(){
 	printf("CAnalyze::CalcSpectra, opening %s\n",h5_infilename.c_str());
 	h5file=new H5File(h5_infilename,H5F_ACC_RDONLY);
 
-	nevents=int(h5file->getNumObjs());
+	nevents=GetNEventsH5();
 	printf("nevents=%d\n",nevents);
 	if(nevents>neventsmax) nevents=neventsmax;
 	for(ievent=1;ievent<=nevents;ievent++){
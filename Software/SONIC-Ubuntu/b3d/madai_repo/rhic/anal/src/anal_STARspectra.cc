@@ -38,7 +38,7 @@ void CAnalyze::CalcSpectra_STAR(){
 	printf("CAnalyze::CalcSpectra, opening %s\n",h5_infilename.c_str());
 	h5file=new H5File(h5_infilename,H5F_ACC_RDONLY);
 	
-	nevents=int(h5file->getNumObjs());
+	nevents=GetNEventsH5();
 	if(nevents>neventsmax) nevents=neventsmax;
 	double meanpt_pion=0.0,meanpt_kaon=0.0,meanpt_proton=0.0,meanpt_omega=0.0;
 	long long int npions=0,nkaons=0,nprotons=0,nomegas=0;
@@ -13,7 +13,7 @@ void CAnalyze::CalcBalance(){
 	string infilename=input_dataroot+"/"+qualifier+"/"+h5_infilename;
 	printf("CAnalyze::ReadData, opening %s\n",infilename.c_str());
 	h5file = new H5File(infilename,H5F_ACC_RDONLY);
-	nevents=int(h5file->getNumObjs());
+	nevents=GetNEventsH5();
 	if(nevents>neventsmax) nevents=neventsmax;
 	for(ievent=1;ievent<=nevents;ievent++){
 		nparts=ReadDataH5(ievent);
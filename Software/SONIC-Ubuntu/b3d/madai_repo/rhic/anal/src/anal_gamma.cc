@@ -17,7 +17,7 @@ void CAnalyze::CalcGamma(){
 	//string infilename=input_dataroot+"/"+qualifier+"/"+h5_infilename;
 	printf("CAnalyze::ReadData, opening %s\n",h5_infilename.c_str());
 	h5file = new H5File(h5_infilename,H5F_ACC_RDONLY);
-	nevents=int(h5file->getNumObjs());
+	nevents=GetNEventsH5();
 	if(nevents>neventsmax) nevents=neventsmax;
 	for(ievent=1;ievent<=nevents;ievent++){
 		cphitot=cphi2tot=sphitot=sphi2tot=0.0;
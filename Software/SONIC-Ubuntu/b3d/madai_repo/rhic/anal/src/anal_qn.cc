@@ -59,7 +59,7 @@ void CAnalyze::CalcFlucQnEbE(){
   CPartH5 *ph5;
   printf("CAnalyze::CalcFlucQn, opening %s\n",h5_infilename.c_str());
   h5file = new H5File(h5_infilename,H5F_ACC_RDONLY);
-  nevents=int(h5file->getNumObjs());
+  nevents=GetNEventsH5();
   printf("nevents=%d\n",nevents);
   if(nevents>neventsmax) nevents=neventsmax;
   for(ievent=1;ievent<=nevents;ievent++){
@@ -249,7 +249,7 @@ void CAnalyze::CalcFlucQn(){
   CPartH5 *ph5;
   printf("CAnalyze::CalcFlucQn, opening %s\n",h5_infilename.c_str());
   h5file = new H5File(h5_infilename,H5F_ACC_RDONLY);
-  nevents=int(h5file->getNumObjs());
+  nevents=GetNEventsH5();
   printf("nevents=%d\n",nevents);
   if(nevents>neventsmax) nevents=neventsmax;
   for(ievent=1;ievent<=nevents;ievent++){
@@ -43,7 +43,7 @@ void CAnalyze::CalcV2(){
 	CPartH5 *ph5;
 	printf("CAnalyze::CalcV2, opening %s\n",h5_infilename.c_str());
 	h5file = new H5File(h5_infilename,H5F_ACC_RDONLY);
-	nevents=int(h5file->getNumObjs());
+	nevents=GetNEventsH5();
 	printf("nevents=%d\n",nevents);
 	if(nevents>neventsmax) nevents=neventsmax;
 	for(ievent=1;ievent<=nevents;ievent++){
@@ -301,7 +301,7 @@ void CAnalyze::CalcFlucVn(){
   CPartH5 *ph5;
   printf("CAnalyze::CalcFlucVn, opening %s\n",h5_infilename.c_str());
   h5file = new H5File(h5_infilename,H5F_ACC_RDONLY);
-  nevents=int(h5file->getNumObjs());
+  nevents=GetNEventsH5();
   printf("nevents=%d\n",nevents);
   if(nevents>neventsmax) nevents=neventsmax;
   for(ievent=1;ievent<=nevents;ievent++){
@@ -547,7 +547,7 @@ void CAnalyze::CalcFlucVnGamma(){
   CPartH5 *ph5;
   printf("CAnalyze::CalcFlucVn, opening %s\n",h5_infilename.c_str());
   h5file = new H5File(h5_infilename,H5F_ACC_RDONLY);
-  nevents=int(h5file->getNumObjs());
+  nevents=GetNEventsH5();
   printf("nevents=%d\n",nevents);
   if(nevents>neventsmax) nevents=neventsmax;
   for(ievent=1;ievent<=nevents;ievent++){
@@ -79,26 +79,37 @@ CAnalyze::~CAnalyze(){
 	if(output!=NULL) fclose(output);
 }
 
+int CAnalyze::GetNEventsH5(){
+	int nevents=CB3DH5Stream::GetNEvents(h5file);
+	if(nevents<0)
+		nevents=int(h5file->getNumObjs());
+	return nevents;
+}
+
 int CAnalyze::ReadDataH5(int ievent){
 	int nparts,ipart=0;
 	char eventno[20];
 	H5D_space_status_t status;
-	sprintf(eventno,"event%d",ievent);
-	hsize_t dim[1];
-	DataSet *dataset = new DataSet (h5file->openDataSet(eventno));
-	//dataset->getSpaceStatus(status);
-	//hsize_t datasetsize=dataset->getStorageSize();
-	//printf("ievent=%d, status=%d, size=%d\n",ievent,int(status),int(datasetsize));
-	DataSpace filespace = dataset->getSpace();
-	int rank=filespace.getSimpleExtentDims(dim);
-	nparts=dim[0];
 	part->b3d=b3d;
-	if(nparts>npartsmax){
-		printf("Increase B3D_NPARTSMAX, nparts=%d, npartsmax=%d\n",nparts,npartsmax);
-		exit(1);
+	if(CB3DH5Stream::GetNEvents(h5file)>=0)
+		nparts=CB3DH5Stream::Read(h5file,ptype,ievent,partH5,npartsmax);
+	else{
+		sprintf(eventno,"event%d",ievent);
+		hsize_t dim[1];
+		DataSet *dataset = new DataSet (h5file->openDataSet(eventno));
+		//dataset->getSpaceStatus(status);
+		//hsize_t datasetsize=dataset->getStorageSize();
+		//printf("ievent=%d, status=%d, size=%d\n",ievent,int(status),int(datasetsize));
+		DataSpace filespace = dataset->getSpace();
+		int rank=filespace.getSimpleExtentDims(dim);
+		nparts=dim[0];
+		if(nparts>npartsmax){
+			printf("Increase B3D_NPARTSMAX, nparts=%d, npartsmax=%d\n",nparts,npartsmax);
+			exit(1);
+		}
+		dataset->read(partH5,*ptype);
+		delete dataset;
 	}
-	dataset->read(partH5,*ptype);
-	delete dataset;
 	CPart *dptr;
 	CPartH5 *ph5;
 	
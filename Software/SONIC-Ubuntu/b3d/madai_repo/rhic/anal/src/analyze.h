@@ -40,6 +40,7 @@ public:
 	bool CALCGARRAYS;
 	bool STAR_ACCEPTANCE;
 	int ReadDataH5(int ievent); // returns nparts for given event
+	int GetNEventsH5(); // number of events in h5file, also for files written with B3D_H5_STREAM
 	int ReadVizData(double tau);
 	void CalcSpectra_STAR();
 	double CalcSpectra_PHENIX();
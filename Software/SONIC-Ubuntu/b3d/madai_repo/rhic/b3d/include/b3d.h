@@ -9,8 +9,10 @@
 #include <complex>
 #include <cstdio>
 #include <list>
+#include <vector>
 #include <sys/stat.h>
 #include <ctime>
+#include <pthread.h>
 #include "part.h"
 #include "coralutils.h"
 #include "H5Cpp.h"
@@ -32,6 +34,220 @@ typedef multimap<double,CAction *> CActionMap;
 typedef pair<int,CPart*> CPartPair;
 typedef pair<double,CAction*> CActionPair;
 
+//!The schedule of future actions.
+/*!
+\version 1.0
+
+An indexed 4-ary min-heap of CAction objects, ordered by CAction::key. Actions with equal keys come out in the order in which they were inserted, as they did from the multimap previously used for the schedule. Each scheduled action stores its position in the heap (CAction::queuepos), so that an action can be removed when it is killed without searching for it. The heap entries carry a copy of the key, so reordering the heap does not touch the CAction objects.
+
+With the parallel cascade (B3D_NDOMAINS>1) the master's queue is filled and emptied by several threads at once; insert and erase are then serialized while shared is set. The order in which the threads insert is arbitrary, so actions inserted while shared are ordered by their listid instead, after the actions inserted before.
+*/
+class CActionQueue{
+public:
+	CActionQueue();
+	void insert(CAction *action);
+	void erase(CAction *action);
+	void clear();
+	CAction *top(){return heap[0].action;}	//!< The earliest action, the queue must not be empty.
+	bool empty(){return heap.empty();}
+	int size(){return int(heap.size());}
+	CAction *operator[](int i){return heap[i].action;}	//!< Actions in heap order, not in time order.
+	void GetSorted(vector<CAction *> &actionlist);	//!< All actions in the order they will be performed.
+	void Share(bool sharedset);	//!< called by the master before and after the domain engines run
+	bool shared;	//!< insert and erase lock the queue, set while the domain engines run
+private:
+	struct CEntry{
+		double key;
+		long long int sequence;
+		CAction *action;
+	};
+	vector<CEntry> heap;
+	long long int nsequence;
+	static bool Before(const CEntry &a,const CEntry &b){
+		return (a.key<b.key) || (a.key==b.key && a.sequence<b.sequence);
+	}
+	void Push(CAction *action);
+	void Remove(CAction *action);
+	void Place(int i,const CEntry &entry);
+	void SiftUp(int i,CEntry entry);
+	void SiftDown(int i,CEntry entry);
+};
+
+//!Storage for the CPart or CAction objects of a CB3D object.
+/*!
+\version 1.0
+
+The objects are allocated in slabs, contiguous arrays of objects that are never given back, and handed out from a list of free objects threaded through the objects themselves (T::nextfree), the most recently freed first. An empty pool grows by another slab, so B3D_NPARTSMAX and B3D_NACTIONSMAX only set the size of the first slab. Every object gets a listid, its number within the pool, when its slab is allocated.
+
+With the parallel cascade the pools of the engines are adopted by the master's pool (Adopt). Each pool of the family then allocates its own slabs, with listids in its own range, so that what an engine gets from its pool does not depend on the other threads. A freed object always goes back to the pool it came from: the master's pool hands it over directly, an engine's pool keeps it aside until Flush, which the master calls between the windows.
+*/
+template <class T> class CB3DPool{
+public:
+	CB3DPool(){
+		family=NULL;
+		listidbase=0;
+		idrange=2147483647;
+		deferforeign=false;
+		freelist=foreign=NULL;
+		nfree=ntotal=0;
+	}
+	~CB3DPool(){
+		for(int islab=0;islab<int(slabs.size());islab++)
+			delete [] slabs[islab];
+	}
+	T *Get(){
+		T *object;
+		if(freelist==NULL)
+			Grow((ntotal>NSLAB) ? ntotal/2 : NSLAB);
+		object=freelist;
+		freelist=object->nextfree;
+		object->nextfree=NULL;
+		nfree-=1;
+		return object;
+	}
+	void Put(T *object){
+		CB3DPool<T> *home=Home(object);
+		if(home==this){
+			object->nextfree=freelist;
+			freelist=object;
+			nfree+=1;
+		}
+		else if(deferforeign){
+			object->nextfree=foreign;
+			foreign=object;
+		}
+		else home->Put(object);
+	}
+	//! Adds a slab of nobjects objects to the pool.
+	void Grow(int nobjects){
+		int i;
+		if(ntotal+nobjects>idrange){
+			printf("CB3DPool::Grow, more than %d objects in one pool\n",idrange);
+			exit(1);
+		}
+		T *slab=new T[nobjects];
+		slabs.push_back(slab);
+		slabsize.push_back(nobjects);
+		ntotal+=nobjects;
+		for(i=nobjects-1;i>=0;i--){
+			slab[i].listid=listidbase+ntotal-nobjects+i;
+			Put(&slab[i]);
+		}
+	}
+	//! Makes child one of nmembers pools of the family of this pool, the master's.
+	void Adopt(CB3DPool<T> *child,int nmembers){
+		if(family==NULL){
+			idrange=2147483647/nmembers;
+			if(ntotal>idrange){
+				printf("CB3DPool::Adopt, %d objects do not fit into a range of %d listids\n",ntotal,idrange);
+				exit(1);
+			}
+			members.push_back(this);
+			family=&members;
+		}
+		child->family=&members;
+		child->idrange=idrange;
+		child->listidbase=int(members.size())*idrange;
+		child->deferforeign=true;
+		members.push_back(child);
+	}
+	//! Sends the objects freed by an engine that belong to other pools home, only called by the master.
+	void Flush(){
+		T *object;
+		while(foreign!=NULL){
+			object=foreign;
+			foreign=object->nextfree;
+			Home(object)->Put(object);
+		}
+	}
+	//! Puts the free lists of the family back in listid order, as in new pools. Only done if every object is free, returns false otherwise.
+	bool Restack(){
+		int imember,islab,i;
+		CB3DPool<T> *pool;
+		for(imember=0;imember<NMembers();imember++){
+			pool=Member(imember);
+			if(pool->nfree!=pool->ntotal || pool->foreign!=NULL)
+				return false;
+		}
+		for(imember=0;imember<NMembers();imember++){
+			pool=Member(imember);
+			pool->freelist=NULL;
+			pool->nfree=0;
+			for(islab=int(pool->slabs.size())-1;islab>=0;islab--){
+				for(i=pool->slabsize[islab]-1;i>=0;i--)
+					pool->Put(&pool->slabs[islab][i]);
+			}
+		}
+		return true;
+	}
+	int CountFree(){	//!< free objects of the family
+		int n=0;
+		for(int imember=0;imember<NMembers();imember++)
+			n+=Member(imember)->nfree;
+		return n;
+	}
+	int CountTotal(){	//!< objects allocated by the family
+		int n=0;
+		for(int imember=0;imember<NMembers();imember++)
+			n+=Member(imember)->ntotal;
+		return n;
+	}
+	int nfree;	//!< number of objects in the free list
+	int ntotal;	//!< number of objects allocated by the pool
+private:
+	enum{NSLAB=4096};
+	T *freelist,*foreign;
+	vector<T *> slabs;
+	vector<int> slabsize;
+	vector<CB3DPool<T> *> members,*family;
+	int listidbase,idrange;
+	bool deferforeign;
+	int NMembers(){return (family==NULL) ? 1 : int(family->size());}
+	CB3DPool<T> *Member(int imember){return (family==NULL) ? this : (*family)[imember];}
+	CB3DPool<T> *Home(T *object){return (family==NULL) ? this : (*family)[object->listid/idrange];}
+};
+
+//!An entry of the event index of a streamed b3d.h5 file.
+/*!
+The particles of the event are nparts consecutive entries of the "particles" dataset, starting at offset.
+*/
+class CEventH5{
+public:
+	int ievent,nparts;
+	long long int offset;
+};
+
+//!The output of B3D_H5_STREAM.
+/*!
+\version 1.0
+
+Instead of a dataset per event, all particles go into one extendible dataset, "particles", which is chunked (B3D_H5_CHUNKSIZE particles) and compressed with deflate (level B3D_H5_COMPRESSION, 0 for none). The dataset "events" holds a CEventH5 entry for every event, in the order the events were written.
+
+With B3D_H5_WRITERTHREAD the events are written by a thread of their own while the cascade goes on with the next event. There is at most one event in flight, Write waits for the previous one first. The HDF5 library is not used by the cascade in the meantime; anything else using it has to call Wait first.
+*/
+class CB3DH5Stream{
+public:
+	CB3DH5Stream(H5File *h5file,CompType *ptypeset,int chunksize,int compression,bool writerthreadset);
+	~CB3DH5Stream();	//!< Waits for the writer, the file stays open.
+	//! Writes the particles of an event. The vector is swapped with a buffer of the stream and comes back with undefined contents.
+	void Write(int ievent,vector<CPartH5> &parts);
+	void Wait();	//!< Returns once the last event is on disk (in the HDF5 library).
+	static int GetNEvents(H5File *h5file);	//!< number of events in a streamed file, -1 if the file has a dataset per event
+	static int Read(H5File *h5file,CompType *ptype,int ievent,CPartH5 *parts,int npartsmax);	//!< reads the event numbered ievent, returns nparts
+private:
+	CompType *ptype,*etype;
+	DataSet *partset,*eventset;
+	long long int npartswritten;
+	int neventswritten;
+	bool writerthread,busy;
+	pthread_t writer;
+	vector<CPartH5> pending;
+	int pendingievent;
+	void Append();
+	static void *WriterMain(void *stream);
+	static CompType *MakeEventType();
+};
+
 //!The main model routine.
 /*!
 \version 1.0
@@ -51,36 +267,28 @@ public:
 	The parameterMap type is a custom version of the generalized C++ map container. It contains various methods for storing and returning almost all data types. The parameter map is designed to be implemented using the fixed.param and stats.param convention discussed in the User's Manual.
 	*/
 	parameterMap parmap;
-	//!A C++ map for dead CPart objects.
+	//!The storage for all CPart objects.
 	/*!
-	This map is populated by "dead" particles; that is, particles which have been removed from the functional particle map.
-	\sa PartMap
+	"Dead" particles, particles which are not in the functional particle map or the final map, wait in the pool's free list until they are used again.
+	\sa CB3DPool
 	*/
-	CPartMap DeadPartMap;
+	CB3DPool<CPart> partpool;
 	CPartMap PartMap;		//!< A C++ map for active CPart objects in the model.
 	CPartMap FinalPartMap;	//!< A C++ map that stores information about particles that have left the model (hit the outer edge).
-	//!A C++ map for CAction objects
+	//!The schedule of CAction objects
 	/*!
-	This map is used to schedule and organize the various actions that the model must perform in time order. It contains all actions (as CAction objects) that have yet to occur, and the map's key is the boost-invariant time \f$\tau\f$ at which the action is scheduled to occur.
+	This queue is used to schedule and organize the various actions that the model must perform in time order. It contains all actions (as CAction objects) that have yet to occur, and the queue's key is the boost-invariant time \f$\tau\f$ at which the action is scheduled to occur.
+	\sa CActionQueue
 	*/
-	CActionMap ActionMap;
-	//!A C++ map for CAction objects that have already occured.
+	CActionQueue ActionMap;
+	//!The storage for all CAction objects.
 	/*!
+	Actions that have occured or were killed go back to the pool.
 	\sa ActionMap
 	*/
-	CActionMap DeadActionMap;
+	CB3DPool<CAction> actionpool;
 	CResList *reslist;	//!< The CResList instance for the model (dynamically allocated).
 	CInelasticList *inelasticlist;	//!< The CInelasicList instance for the model (dynamically allocated).
-	//!A dynamically allocated array of CPart objects.
-	/*!
-	This array is allocated to be the size of the parameter NPARTSMAX (the highest number of particles in the model), and is used only to allocate the memory that the CPart objects use. It was thought that if the total number of particles (dead, alive, and final) remains constant and allocated at the initialization of the model would be a more efficient method.
-	*/
-	CPart **partarray;
-	//!A dynamically allocated array of CAction objects.
-	/*!
-	Much like the part array, this array is dynamically allocated (using NACTIONSMAX) and used to allocate the memory for all CAction objects during the model's running.
-	*/
-	CAction **actionarray;
 	
 	int NXY;	//!< Determines size of mesh. The mesh size is \f$(2NXY,2NXY, 2NETA)\f$.
 	int NETA;
@@ -116,8 +324,8 @@ public:
 	int ievent_write,ievent_read;
 	//
 	// READ IN FROM PARAMETER FILE
-	int NACTIONSMAX;
-	int NPARTSMAX,nbaryons;
+	int NACTIONSMAX;	//!< initial size of actionpool
+	int NPARTSMAX,nbaryons;	//!< initial size of partpool
 	double SIGMAMAX,SIGMADEFAULT, SIGMAINELASTIC, Q0; // cross sections in sq. fm
 	string input_dataroot;
 	string output_dataroot;
@@ -126,11 +334,16 @@ public:
 
 	string outfilename,oscarfilename;
 	H5File *h5outfile, *h5infile;
+	bool H5STREAM,H5_WRITERTHREAD;	//!< see CB3DH5Stream
+	int H5_CHUNKSIZE,H5_COMPRESSION;
+	CB3DH5Stream *h5stream;
+	vector<CPartH5> h5buffer;	//!< the particles of the event being written
 	FILE *oscarfile;// *h5vizfile;
 	int NACTIONS;
 	int NSAMPLE;
 	//
 	void SetQualifier(string qualifier_set);
+	void SetSeed(int seed);	//!< clears the event and restarts the random streams and the pools, the events that follow depend on seed alone, for any B3D_NDOMAINS and number of threads
 	int ReadDataH5(int ievent);
 	void MovePartsToFinalMap();
 	double WriteDataH5(); // returns dnch/deta
@@ -158,12 +371,14 @@ public:
 	void PrintPartList();
 
 	bool FindCollision(CPart *part1,CPart *part2,double &taucoll);
+	void FindCollisions(CPart *part1,CB3DCell *cell2);
 	void Decay(CPart *&mother,int &nbodies, CPart **&daughter);
 	double CalcSigma(CPart *part1,CPart *part2);
 
 	CRandom *randy;
 
 	void PrintActionMap(CActionMap *actionmap);
+	void PrintActionMap(CActionQueue *actionqueue);
 
 	double GetPiBsquared(CPart *part1,CPart *part2);
 	int Collide(CPart *part1,CPart *part2); // will collide if sigma>scompare
@@ -182,6 +397,22 @@ public:
 	hid_t viz_file_id;
 	//
 
+	//!Parallel cascade (domain.cc)
+	/*!
+	With B3D_NDOMAINS>1 the lattice is cut into NDOMAINS slabs in x, each run by its own engine, a CB3D object that shares the cells, the resonance list and the parameters with the master but has its own action queue, maps of dead and live objects, random number generator, clock and counters. Actions involving only particles in cells whose neighbors belong to the same domain are scheduled with that domain's engine, all others with the master. The engines run in parallel through windows of DOMAIN_DTAU in tau; the master then performs its own actions of the window, together with whatever the engines could not, in time order. The result is statistically, not event by event, equivalent to the serial cascade; it does not depend on the number of threads or their timing.
+	*/
+	int NDOMAINS;
+	double DOMAIN_DTAU;	//!< Length of the synchronization window.
+	CB3D *master;	//!< The CB3D object that owns the lattice (this, unless this is a domain engine).
+	CB3D **domain;	//!< The NDOMAINS domain engines, NULL for the serial cascade.
+	void InitDomains();
+	CActionQueue *GetActionQueue(int type,CPart *part1,CPart *part2,double taction);
+	CAction *GetNextAction();
+	void SetThreadContext();
+	void PerformDomainActions();
+	void PerformDomainWindow(double tauwindow);
+	void MergeDomains();
+
 	void freegascalc_onespecies(double m,double t,double &p,double &e,double &dens,double &sigma2,double &dedt);
 };
 //!An action in the CB3D model.
@@ -190,9 +421,9 @@ public:
 \author Scott Pratt
 \date March 2011
 
-This class handles any actions that the model takes during execution. Examples of "actions" that the model takes are a resonance decaying, a particle crossing a cell boundary, a collision, new particles being generated, etc. In this way, a complex system of interacting particles is reduced to a scheduled list of actions. Scheduling is handled using a C++ map container of CAction objects, keyed by the boost-invariant time tau (\f$\tau\f$) at which they are scheduled to occur. Note that this map is revised consistently, as future actions often change dramatically as a result of the current action.
+This class handles any actions that the model takes during execution. Examples of "actions" that the model takes are a resonance decaying, a particle crossing a cell boundary, a collision, new particles being generated, etc. In this way, a complex system of interacting particles is reduced to a scheduled list of actions. Scheduling is handled using a priority queue of CAction objects (CActionQueue), keyed by the boost-invariant time tau (\f$\tau\f$) at which they are scheduled to occur. Note that this queue is revised consistently, as future actions often change dramatically as a result of the current action.
 
-Much like particles and CPart objects, the total number of actions is also a constant (set by CB3D::NACTIONSMAX). Actions are allocated in one memory block in the CB3D constructor, and are moved from the map of future actions (CB3D::ActionMap) to the list of completed actions (CB3D::DeadActionMap) once they have been performed.
+Much like particles and CPart objects, actions are allocated in slabs (CB3D::actionpool), and go back to the pool's free list once they have been performed or killed. The particles of an action keep references to it (CPart::actionmap) that are not removed when the action is killed; the generation, which counts the kills, tells these stale references apart from the references to the action's current use.
 */
 class CAction{
 public:
@@ -219,15 +450,14 @@ public:
 	CAction();
 	~CAction();
 
-	static CB3D *b3d;
+	static __thread CB3D *b3d;
 
-	CActionMap::iterator GetPos(CActionMap *actionmap);
-	void MoveToActionMap();
-	void RemoveFromActionMap();
-	void AddToMap(CActionMap *newmap);
-	void AddToMap(CActionMap::iterator guess,CActionMap *newmap);
+	void MoveToActionMap(CActionQueue *actionqueue);
 	void CheckPartList();
-	CActionMap *currentmap;
+	unsigned int generation;	//!< incremented each time the action is killed, accessed atomically since stale references may be read by another engine
+	CAction *nextfree;	//!< next action in the free list of a CB3DPool
+	int queuepos;	//!< position in CB3D::ActionMap, -1 if the action is not scheduled
+	CActionQueue *queue;	//!< the queue the action is scheduled in
 };
 //!A cell in the expanding cell mesh
 /*!
@@ -235,7 +465,9 @@ public:
 \author Scott Pratt
 \date March 2011
 
-In the CB3D model, the model space is expressed as a mesh grid of cells that expand as time propogates. The mesh is populated by cells, which are CB3DCell objects. This class keeps track of the particles populating it (in a particle map), as well as its spatial dimensions and neighbors. The neighbors are especially relevant, as actions such as collisions are scheduled by checking against particles inside its the current cell, as well as all neighboring cells.
+In the CB3D model, the model space is expressed as a mesh grid of cells that expand as time propogates. The mesh is populated by cells, which are CB3DCell objects. This class keeps track of the particles populating it, as well as its spatial dimensions and neighbors. The neighbors are especially relevant, as actions such as collisions are scheduled by checking against particles inside its the current cell, as well as all neighboring cells.
+
+The particles of a cell are kept in a contiguous array (partlist) in no particular order, so that the collision search streams through it. Each particle knows its position in the array (CPart::cellpos): adding and removing a particle takes constant time, the last particle of the array fills the gap left by a removed one.
 */
 
 class CB3DCell{
@@ -245,15 +477,19 @@ public:
 	class CB3DCell *creflection;
 	int ireflection;
 	double xmin,xmax,ymin,ymax,etamin,etamax;
-	CPartMap partmap;
+	vector<CPart *> partlist;
+	void AddPart(CPart *part);
+	void RemovePart(CPart *part);
 	void PrintPartMap(CPartMap *partmap);
 	void KillAllParts();
 	void ReKeyAllParts();
 	void Print();
 	double *dens;
+	int idomain;	//!< domain of the parallel cascade
+	bool border;	//!< true if a neighbor belongs to another domain
 	
 	CB3DCell(double xmin,double xmax,double ymin,double ymax,double etamin,double etamax);
-	static CB3D *b3d;
+	static __thread CB3D *b3d;
 };
 
 
@@ -23,7 +23,7 @@ using namespace H5;
 
 using namespace std;
 
-class CRing; class CResList; class CPRCell;
+class CRing; class CResList; class CPRCell; class CHydroChunk;
 
 class CHYDROtoB3D{
 public:
@@ -41,30 +41,42 @@ public:
 	int MakeEvent();
 	int MakeEventPR();
 	int MakeEvent3D();
-	int GenerateParticles(int iring);
-	int GenerateParticlesPR(int iprcell);
-	int GenerateParticles3D(int ieta,int iring);
+	int GenerateParticles(int iring,CHydroChunk *chunk);
+	int GenerateParticlesPR(int iprcell,CHydroChunk *chunk);
+	int GenerateParticles3D(int ieta,int iring,CHydroChunk *chunk);
 	void freegascalc_onespecies(double m,double t,double &p,double &e,double &dens,double &sigma2,double &dedt);
 	void Init();
 	void InitPR();
 	void Init3D();
 	void ReadInput();
 	void ReadInputPR();
+	bool ReadSurfacePR(string filename,bool bulk);
 	void ReadInput3D();
 	CB3D *b3d;
 	void GetLambdaFact();
 	void TestLambdaFact();
 protected:
 	int MC_NWrite;
-	double MC_Ntarget,MC_Nbar,nsample,Ncheck;
+	double MC_Nbar,nsample,Ncheck;
 	CRandom *randy;
 	int nres,nrings,nprcells,*nrings3d;
 	double *density,*ID;
+	// species sampled from the surface (no photons), with mass and density*NSAMPLE at the freeze-out temperature
+	int nspecies,*speciesID;
+	double *speciesmass,*speciesdNbar;
+	// the surface is sampled in chunks of rings or of NPRCHUNK cells, see CHydroChunk
+	int NPRCHUNK,nchunks;
+	vector<CHydroChunk> chunk;
+	void InitSpecies();
+	void StartChunks(int nchunksset);
+	int AddChunks();
+	void GrowPRCells();
 	string tmpfilename;
 	FILE *tmpfile,*input;
 	CRing *ring;
 	CRing **ring3d;
 	CPRCell *prcell;
+	int nprcellsalloc;	// size of prcell, grown by ReadSurfacePR up to B3D_PR_NPRCELLSMAX
 	void GetRingInfo();
 	void GetRingInfo3D();
 	void ReadHeader(FILE *);
@@ -72,6 +84,27 @@ protected:
 	void ReadHeader3D(FILE *);
 };
 
+// A hadron sampled from the surface, added to the cascade by CHYDROtoB3D::AddChunks
+class CHydroSample{
+public:
+	int ID;
+	double x,y,tau,eta,px,py,mass,rapidity;
+};
+
+// Part of the surface sampled by one thread. Each chunk has its own random stream, seeded from
+// the event's stream, and its own Poisson process, so the event does not depend on the number
+// of threads. The samples stay in the chunk until the chunks are added to the cascade in order.
+class CHydroChunk{
+public:
+	CHydroChunk();
+	CRandom *randy;
+	int seed,MC_NWrite,normpt;
+	double MC_Ntarget,MC_Nbar,meanpt,meanu,etot,vtot;
+	vector<CHydroSample> sample;
+	void Start();
+	void Add(int ID,double x,double y,double tau,double eta,double px,double py,double mass,double rapidity);
+};
+
 // This fills out Pi[4][4] given Pi_xx, Pi_yy, Pi_xy, u_x and u_y (all specified in lab frame)
 void FillOutPi(double **Pi,double pixx,double piyy,double pixy,double ux,double uy);
 
@@ -136,6 +169,9 @@ public:
 	double x,y,ux,uy,eta,tau;
 	double Omega_x,Omega_y,Omega_0;
 	double dToverH[4][4];
+	// set by Prepare, the same for every event
+	double u[4],lambda[4][4],wmax;
+	void Prepare(double lambdafact);
 	void GetPiTildeOverH(double pixx,double pixy,double piyy);
 	void GetPiTildeOverH(double pixx,double pixy,double piyy,double pib);
 };
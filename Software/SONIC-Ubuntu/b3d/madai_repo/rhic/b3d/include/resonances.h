@@ -77,12 +77,21 @@ public:
 	CResInfo *nextResInfoptr;	//!< Pointer to next CResInfo object in linked list.
 	CBranchInfo *firstbptr;	//!< Pointer to first decay channel of particle.
 	CBranchInfo	*bptr_minmass;	//!< Pointer to decay channel with minimum mass.
+	//!Alias table of the decay channels
+	/*!
+	Built once by MakeBranchTable from the list of CBranchInfo objects. Channel i of the table is chosen with probability branchprob[i], branchalias[i] otherwise (Walker's alias method), so that choosing a decay channel takes one random number and no walk through the list.
+	*/
+	vector<CBranchInfo *> branchtable;
+	vector<CBranchInfo *> branchalias;	//!< see branchtable
+	vector<double> branchprob;	//!< see branchtable
+	void MakeBranchTable();
 	void Print();	//!< Print out information.
 	void DecayGetResInfoptr(int &nbodies,CResInfo **&daughterresinfoptr);
 	void DecayGetResInfoptr_minmass(int &nbodies,CResInfo **&daughterresinfoptr);
 	bool CheckForDaughters(int code);
 	CResInfo();	//!< Constructor.
 	static CRandom *ranptr;	//!< A dynamically allocated random number generator.
+	static __thread CRandom *domainranptr;	//!< Used instead of ranptr by the engines of the parallel cascade.
 	
 };
 //!This class is used for storing and organizing CResInfo objects.
@@ -129,6 +138,11 @@ public:
 	\sa CMerge::ires
 	*/
 	CMerge ***MergeArray;
+	//!Upper bounds of the merge cross sections.
+	/*!
+	For the pair of resonances ires1<=ires2, \f$4\pi(\hbar c)^2\sum b(2j_R+1)/((2j_1+1)(2j_2+1))\f$ summed over MergeArray[ires1][ires2]. Divided by \f$q^2\f$ it bounds the sum of the merge cross sections at any invariant mass, since the Breit-Wigner factor of each resonance is at most one. CB3D::Collide skips the pairs that can not reach the impact parameter.
+	*/
+	double **MergeSigmaBound;
 	static CB3D *b3d;	//!< Pointer to the CB3D object the CResList object belongs to.
 	
 };
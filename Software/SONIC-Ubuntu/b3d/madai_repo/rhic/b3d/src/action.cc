@@ -3,82 +3,41 @@
 
 #include "b3d.h"
 
-CB3D *CAction::b3d=NULL;
+__thread CB3D *CAction::b3d=NULL;
 CAction::CAction(){
+	queuepos=-1;
+	queue=NULL;
+	generation=0;
+	nextfree=NULL;
+}
+CAction::~CAction(){
 }
 
 // type=0(creation) 1(decay) 2(collision) 3(VizWrite) 4(DensCalc)
 
-CActionMap::iterator CAction::GetPos(CActionMap *emap){
-	pair<CActionMap::iterator,CActionMap::iterator> epospair;
-	CActionMap::iterator epos;
-	epospair=emap->equal_range(key);
-	epos=epospair.first;
-	while(epos->second!=this && epos!=epospair.second){
-		++epos;
-	}
-	if(epos->second!=this){
-		return emap->end();
-	}
-	else return epos;
-}
-
-void CAction::MoveToActionMap(){
-	CActionMap::iterator epos,eepos;
-	if(currentmap==&b3d->ActionMap){
+// the action is fresh from b3d->actionpool
+void CAction::MoveToActionMap(CActionQueue *actionqueue){
+	if(queuepos>=0){
 		printf("trying to move action to ActionMap even though action is already in ActionMap\n");
 		printf("wrong current map\n");
 		exit(1);
 	}
-	if(currentmap==&b3d->DeadActionMap){
-		epos=GetPos(currentmap);
-		if(epos!=currentmap->end()){
-			b3d->DeadActionMap.erase(epos);
-			partmap.clear();
-		}
-		else{
-			printf("can't find epos!!!\n");
-			exit(1);
-		}
-		key=tau;
-		AddToMap(&b3d->ActionMap);
-	}
+	partmap.clear();
+	key=tau;
+	actionqueue->insert(this);
 }
 
+// the references to the action held by its particles become stale with the new generation
 void CAction::Kill(){
-	if(currentmap==&b3d->ActionMap){
-		CActionMap::iterator eepos,epos=GetPos(currentmap);
-		currentmap->erase(epos);
-		key=double(b3d->NACTIONSMAX+b3d->nactionkills);
+	if(queuepos>=0){
+		queue->erase(this);
+#pragma omp atomic
+		generation+=1;
 		b3d->nactionkills+=1;
-		AddToMap(b3d->DeadActionMap.end(),&b3d->DeadActionMap);
-		CPart *part;
-		CPartMap::iterator ppos=partmap.begin();
-		while(ppos!=partmap.end()){
-			part=ppos->second;
-			epos=part->actionmap.begin();
-			while(epos!=part->actionmap.end()){
-				eepos=epos;
-				++eepos;
-				if(epos->second==this)
-					part->actionmap.erase(epos);
-				epos=eepos;
-			}
-			++ppos;
-		}
+		b3d->actionpool.Put(this);
 	}
 }
 
-void CAction::AddToMap(CActionMap *newmap){
-	currentmap=newmap;
-	newmap->insert(CActionPair(key,this));
-}
-
-void CAction::AddToMap(CActionMap::iterator guess,CActionMap *newmap){
-	currentmap=newmap;
-	newmap->insert(guess,CActionPair(key,this));
-}
-
 void CAction::AddPart(CPart *part){
 	partmap.insert(CPartPair(part->key,part));
 }
@@ -125,7 +84,7 @@ void CAction::PerformDensCalc(){
 		for(iy=0;iy<2*b3d->NXY;iy++){
 			for(ieta=0;ieta<2*b3d->NETA;ieta++){
 				cell=b3d->cell[ix][iy][ieta];
-				cell->dens[itau]+=cell->partmap.size();
+				cell->dens[itau]+=cell->partlist.size();
 			}
 		}
 	}
@@ -22,11 +22,15 @@ void CAction::Perform(){
 	}
 	*/
 
-	if(currentmap!=&(b3d->ActionMap)){
+	if(queuepos<0){
 		printf("FATAL: trying to perform dead action\n");
 		exit(1);
 	}
-	Kill();
+	// as Kill(), but the action only goes back to the pool once it has been performed
+	queue->erase(this);
+#pragma omp atomic
+	generation+=1;
+	b3d->nactionkills+=1;
 
 	b3d->tau=tau;
 
@@ -62,6 +66,7 @@ void CAction::Perform(){
 	}
 	*/
 	//printf("action finished, listid=%d, %d more to go\n",listid,int(b3d->ActionMap.size()));
+	b3d->actionpool.Put(this);
 }
 
 
@@ -14,13 +14,14 @@ void CAction::PerformActivate(){
 	part->tau_lastint=tau;
 	part->actionmother=b3d->nactions;
 	b3d->nactions++;
-	if(part->currentmap!=&(b3d->PartMap)){
+	// with the parallel cascade the particle may still be in the master's PartMap
+	if(part->currentmap!=&(b3d->PartMap) && part->currentmap!=&(b3d->master->PartMap)){
 		printf("FATAL: particles to be activated should be in PartMap\n");
 		part->Print();
 		exit(1);
 	}
 	part->KillActions();
-	if(part->currentmap!=&(b3d->PartMap)){
+	if(part->currentmap!=&(b3d->PartMap) && part->currentmap!=&(b3d->master->PartMap)){
 		printf("A FATAL: particles to be activated should be in PartMap\n");
 		part->Print();
 		exit(1);
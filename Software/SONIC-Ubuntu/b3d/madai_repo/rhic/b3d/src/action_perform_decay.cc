@@ -70,12 +70,11 @@ void CAction::PerformDecay(){
 		ntry++;
 	}while(mtot>mothermass);
 	
-	ppos=b3d->DeadPartMap.begin();
 	for(ibody=0;ibody<nbodies;ibody++){
-		daughter[ibody]=ppos->second;
+		daughter[ibody]=b3d->partpool.Get();
 		dptr=daughter[ibody];
+		dptr->SetInitialKey();
 		dptr->resinfo=daughterresinfo[ibody];
-		++ppos;
 	}
 	// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 	b3d->Decay(mother,nbodies,daughter);
@@ -84,10 +83,6 @@ void CAction::PerformDecay(){
 		printf("FATAL: Action.Perform(), In decay, nbodies=%d\n",nbodies);
 		exit(1);
 	}
-	if(b3d->DeadPartMap.size()<nbodies){
-		printf("PERFORM_DECAY: MUST INCREASE NPARTMAX\n");
-		exit(1);
-	}
 	CB3DCell *newcell;
 	for(ibody=0;ibody<nbodies;ibody++){
 		dptr=daughter[ibody];
@@ -14,8 +14,7 @@ void CAction::PerformExitCell(){
 	ppos=partmap.begin();
 	part=ppos->second;
 
-	ppos=part->GetPos(&(part->cell->partmap));
-	if(ppos==part->cell->partmap.end()){
+	if(part->cellpos<0 || part->cell->partlist[part->cellpos]!=part){
 		printf("YIKES, particle not in cell, tau=%g\n",tau);
 		part->Print();
 		part->cell->Print();
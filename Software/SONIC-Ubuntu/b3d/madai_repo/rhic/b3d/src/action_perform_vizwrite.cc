@@ -16,7 +16,7 @@ void CAction::PerformVizWrite(){
 	CPartMap::iterator ppos;
 	CB3DCell *c;
 	int ix,iy,ieta;
-	int nparts,npartsmax=b3d->NPARTSMAX;
+	int nparts,npartsmax=b3d->partpool.CountTotal();
 	double (*xyz)[3]=new double[npartsmax][3];
 	int *listid=new int[npartsmax];
 	int *ID=new int[npartsmax];
@@ -30,9 +30,8 @@ void CAction::PerformVizWrite(){
 		for(iy=0;iy<2*b3d->NXY;iy++){
 			for(ieta=0;ieta<2*b3d->NETA;ieta++){
 				c=b3d->cell[ix][iy][ieta];
-				ppos=c->partmap.begin();
-				while(ppos!=c->partmap.end()){
-					part=ppos->second;
+				for(ipart=0;ipart<int(c->partlist.size());ipart++){
+					part=c->partlist[ipart];
 					pperp=sqrt(part->p[1]*part->p[1]+part->p[2]*part->p[2]);
 					eperp=sqrt(pperp*pperp+part->resinfo->mass*part->resinfo->mass);
 					v=pperp/eperp;
@@ -47,7 +46,6 @@ void CAction::PerformVizWrite(){
 					py[nparts]=part->p[2];
 					rapidity[nparts]=part->y;
 					mass[nparts]=part->GetMass();
-					++ppos;
 					nparts+=1;
 				}
 			}
@@ -0,0 +1,125 @@
+#ifndef __ACTIONQUEUE_CC__
+#define __ACTIONQUEUE_CC__
+
+#include "b3d.h"
+#include <algorithm>
+
+// children of heap[i] are heap[4*i+1] ... heap[4*i+4]
+
+CActionQueue::CActionQueue(){
+	nsequence=0;
+	shared=false;
+}
+
+void CActionQueue::clear(){
+	for(int i=0;i<int(heap.size());i++)
+		heap[i].action->queuepos=-1;
+	heap.clear();
+	nsequence=0;
+}
+
+void CActionQueue::Place(int i,const CEntry &entry){
+	heap[i]=entry;
+	entry.action->queuepos=i;
+}
+
+void CActionQueue::SiftUp(int i,CEntry entry){
+	int parent;
+	while(i>0){
+		parent=(i-1)/4;
+		if(!Before(entry,heap[parent]))
+			break;
+		Place(i,heap[parent]);
+		i=parent;
+	}
+	Place(i,entry);
+}
+
+void CActionQueue::SiftDown(int i,CEntry entry){
+	int n=int(heap.size()),child,ichild,best;
+	while(true){
+		child=4*i+1;
+		if(child>=n)
+			break;
+		best=child;
+		for(ichild=child+1;ichild<child+4 && ichild<n;ichild++){
+			if(Before(heap[ichild],heap[best]))
+				best=ichild;
+		}
+		if(!Before(heap[best],entry))
+			break;
+		Place(i,heap[best]);
+		i=best;
+	}
+	Place(i,entry);
+}
+
+void CActionQueue::insert(CAction *action){
+	if(shared){
+#pragma omp critical(b3d_actionqueue)
+		Push(action);
+	}
+	else Push(action);
+}
+
+void CActionQueue::erase(CAction *action){
+	if(shared){
+#pragma omp critical(b3d_actionqueue)
+		Remove(action);
+	}
+	else Remove(action);
+}
+
+// while shared the sequence is nsequence+listid, which is unique among the scheduled
+// actions and does not depend on the order of the threads
+void CActionQueue::Share(bool sharedset){
+	if(shared && !sharedset)
+		nsequence+=2147483648LL;
+	shared=sharedset;
+}
+
+void CActionQueue::Push(CAction *action){
+	if(action->queuepos>=0){
+		printf("CActionQueue::insert, action is already scheduled\n");
+		exit(1);
+	}
+	CEntry entry;
+	entry.key=action->key;
+	entry.action=action;
+	if(shared)
+		entry.sequence=nsequence+action->listid;
+	else{
+		entry.sequence=nsequence;
+		nsequence+=1;
+	}
+	action->queue=this;
+	heap.push_back(entry);
+	SiftUp(int(heap.size())-1,entry);
+}
+
+void CActionQueue::Remove(CAction *action){
+	int i=action->queuepos;
+	if(i<0 || i>=int(heap.size()) || heap[i].action!=action){
+		printf("CActionQueue::erase, action is not scheduled\n");
+		exit(1);
+	}
+	action->queuepos=-1;
+	CEntry last=heap.back();
+	heap.pop_back();
+	if(i<int(heap.size())){
+		if(i>0 && Before(last,heap[(i-1)/4]))
+			SiftUp(i,last);
+		else
+			SiftDown(i,last);
+	}
+}
+
+void CActionQueue::GetSorted(vector<CAction *> &actionlist){
+	vector<CEntry> entries(heap);
+	sort(entries.begin(),entries.end(),Before);
+	actionlist.resize(entries.size());
+	for(int i=0;i<int(entries.size());i++)
+		actionlist[i]=entries[i].action;
+}
+
+#endif
@@ -10,47 +10,35 @@ using namespace std;
 
 
 void CB3D::AddAction_Activate(CPart *part){
-	CActionMap::iterator epos;
 	part->active=false;
 	CAction *action;
-	if(DeadActionMap.size()==0){
-		printf("MUST INCREASE NACTIONS_MAX\n");
-		exit(1);
-	}
 	if(BJORKEN && fabs(part->eta)>ETAMAX){
 		printf("CB3D::AddAction_Activate, eta out of bounds, =%g\n",fabs(part->eta));
 		exit(1);
 	}
-	epos=DeadActionMap.begin();
-	action=epos->second;
-	if(action->currentmap==&ActionMap){
+	action=actionpool.Get();
+	if(action->queuepos>=0){
 		printf("don't even try, key=%d\n",int(action->key));
 		exit(1);
 	}
 	action->type=0;
 	action->tau=part->tau0;
-	action->MoveToActionMap();
+	action->MoveToActionMap(GetActionQueue(0,part,NULL,action->tau));
 	action->partmap.insert(CPartPair(part->key,part));
 	if(action->tau<tau){
 		printf("trying to AddAction_Activate at earler time!!! action->tau=%g, tau=%g\n",action->tau,tau);
 		exit(1);
 	}
-	part->actionmap.insert(CActionPair(action->key,action));
+	part->AddAction(action);
 }
 
 #ifdef VIZWRITE
 void CB3D::AddAction_VizWrite(double tauwrite){
-	CAction *action;
-	if(DeadActionMap.size()==0){
-		printf("MUST INCREASE NACTIONS_MAX\n");
-		exit(1);
-	}
-	CActionMap::iterator epos=DeadActionMap.begin();
-	action=epos->second;
-	action->DeleteFromCurrentMap();
+	CAction *action=actionpool.Get();
 	action->type=3;
 	action->tau=tauwrite;
-	action->AddToMap(&ActionMap);
+	action->key=tauwrite;
+	GetActionQueue(3,NULL,NULL,action->tau)->insert(action);
 	action->partmap.clear();
 	if(action->tau<tau){
 		printf("trying to AddAction_VizWrite at earler time!!! action->tau=%g, tau=%g\n",action->tau,tau);
@@ -66,19 +54,13 @@ void CB3D::AddAction_Decay(CPart *part,double taudecay){
 		part->Print();
 		exit(1);
 	}
-	if(DeadActionMap.size()==0){
-		printf("MUST INCREASE NACTIONS MAX\n");
-		exit(1);
-	}
-	CActionMap::iterator epos=DeadActionMap.begin();
-	action=epos->second;
+	action=actionpool.Get();
 	action->tau=taudecay;
-	action->partmap.clear();
 	action->type=1;
-	action->MoveToActionMap();
+	action->MoveToActionMap(GetActionQueue(1,part,NULL,action->tau));
 	//printf("added action at tau=%g, key=%lld\n",action->tau,action->key);
 	action->partmap.insert(CPartPair(part->key,part));
-	part->actionmap.insert(CActionPair(action->key,action));
+	part->AddAction(action);
 	if(action->tau<tau){
 		printf("CB3D::AddAction_Decay, trying to AddAction_Decay at earler time!!! action->tau=%g, tau=%g\n",action->tau,tau);
 		part->Print();
@@ -89,22 +71,13 @@ void CB3D::AddAction_Decay(CPart *part,double taudecay){
 
 void CB3D::AddAction_ExitCell(CPart *part){
 	CAction *action;
-	if(DeadActionMap.size()==0){
-		printf("MUST INCREASE NACTIONS_MAX\n");
-		exit(1);
-	}
 	if(part->tauexit<TAUCOLLMAX){
-		if(DeadActionMap.size()==0){
-			printf("MUST INCREASE NACTIONS MAX\n");
-			exit(1);
-		}
-		CActionMap::iterator epos=DeadActionMap.begin();
-		action=epos->second;
+		action=actionpool.Get();
 		action->type=6;
 		action->tau=part->tauexit;
-		action->MoveToActionMap();
+		action->MoveToActionMap(GetActionQueue(6,part,NULL,action->tau));
 		action->partmap.insert(CPartPair(part->key,part));
-		part->actionmap.insert(CActionPair(action->key,action));
+		part->AddAction(action);
 		if(action->tau<tau){
 			printf("CB3D::AddAction_ExitCell, trying to AddAction_ExitCell at earler time!!! action->tau=%g, tau=%g\n",action->tau,tau);
 			part->Print();
@@ -116,16 +89,10 @@ void CB3D::AddAction_ExitCell(CPart *part){
 }
 
 void CB3D::AddAction_Collision(CPart *part1,CPart *part2,double taucoll){
-	CAction *action;
-	if(DeadActionMap.size()==0){
-		printf("MUST INCREASE NACTIONSMAX\n");
-		exit(1);
-	}
-	CActionMap::iterator epos=DeadActionMap.begin();
-	action=epos->second;
+	CAction *action=actionpool.Get();
 	action->type=2;
 	action->tau=taucoll;
-	action->MoveToActionMap();
+	action->MoveToActionMap(GetActionQueue(2,part1,part2,action->tau));
 	if(action->tau<tau){
 		printf("trying to AddAction_Collision at earler time!!!  tau=%g\n",tau);
 		action->Print();
@@ -135,21 +102,15 @@ void CB3D::AddAction_Collision(CPart *part1,CPart *part2,double taucoll){
 	action->partmap.insert(CPartPair(part1->key,part1));
 	action->partmap.insert(CPartPair(part2->key,part2));
 
-	part1->actionmap.insert(CActionPair(action->key,action));
-	part2->actionmap.insert(CActionPair(action->key,action));
+	part1->AddAction(action);
+	part2->AddAction(action);
 }
 
 void CB3D::AddAction_DensCalc(double taucalc){
-	CAction *action;
-	if(DeadActionMap.size()==0){
-		printf("MUST INCREASE NACTIONSMAX\n");
-		exit(1);
-	}
-	CActionMap::iterator epos=DeadActionMap.begin();
-	action=epos->second;
+	CAction *action=actionpool.Get();
 	action->type=4;
 	action->tau=taucalc;
-	action->MoveToActionMap();
+	action->MoveToActionMap(GetActionQueue(4,NULL,NULL,action->tau));
 	action->partmap.clear(); 
 	if(action->tau<tau){
 		printf("trying to AddAction_Collision at earler time!!!  tau=%g\n",tau);
@@ -13,7 +13,6 @@ int CB3D::Annihilate(CPart *part1,CPart *part2){
 	double mt,Minv,Ptot[4];
 	double MM,P[4]={0.0},PP[4],T;
 	const double g[4]={1.0,-1.0,-1.0,-1.0};
-	CPartMap::iterator ppos;
 	CB3DCell *newcell;
 
 	netq = part1->resinfo->charge+part2->resinfo->charge;
@@ -75,11 +74,10 @@ int CB3D::Annihilate(CPart *part1,CPart *part2){
 	}
 	Minv=0.0;
 	ndaughters=npi0+npiplus+npiminus+nKplus+nKminus+nK0+nK0bar;
-	ppos=DeadPartMap.begin();
 	for(idaughter=0;idaughter<ndaughters;idaughter++){
-		daughter[idaughter]=ppos->second;
+		daughter[idaughter]=partpool.Get();
+		daughter[idaughter]->SetInitialKey();
 		daughter[idaughter]->actionmap.clear();
-		++ppos;
 	}
 	for(alpha=0;alpha<4;alpha++){
 		P[alpha]=part1->p[alpha]+part2->p[alpha];
@@ -11,6 +11,11 @@ using namespace std;
 CB3D::CB3D(){
 	randy=new CRandom(-1234);
 	BJORKEN=false;
+	NDOMAINS=1;
+	master=this;
+	domain=NULL;
+	H5STREAM=false;
+	h5stream=NULL;
 };
 
 CB3D::CB3D(string run_name_set){
@@ -54,6 +59,16 @@ CB3D::CB3D(string run_name_set){
 	HYDRO_PURE_BJORKEN=parameter::getB(parmap,"HYDRO_PURE_BJORKEN",false);
 	ANNIHILATION_CHECK=parameter::getB(parmap,"B3D_ANNIHILATION_CHECK",false);
 	ANNIHILATION_SREDUCTION=parameter::getD(parmap,"B3D_ANNIHILATION_SREDUCTION",1.0);
+	NDOMAINS=parameter::getI(parmap,"B3D_NDOMAINS",1);
+	DOMAIN_DTAU=parameter::getD(parmap,"B3D_DOMAIN_DTAU",0.5);
+	H5STREAM=parameter::getB(parmap,"B3D_H5_STREAM",false);
+	H5_CHUNKSIZE=parameter::getI(parmap,"B3D_H5_CHUNKSIZE",4096);
+	H5_COMPRESSION=parameter::getI(parmap,"B3D_H5_COMPRESSION",4);
+	H5_WRITERTHREAD=parameter::getB(parmap,"B3D_H5_WRITERTHREAD",false);
+	if(H5_WRITERTHREAD && VIZWRITE){
+		printf("B3D_VIZWRITE uses HDF5 during the cascade, B3D_H5_WRITERTHREAD is switched off\n");
+		H5_WRITERTHREAD=false;
+	}
 
 	SIGMAMAX=SIGMAMAX/double(NSAMPLE);
 	NPARTSMAX*=NSAMPLE;
@@ -84,11 +99,9 @@ CB3D::CB3D(string run_name_set){
 	CInelasticList::UseInelasticArray = false;
 	tau=0.0;
 	itau=0;
-	DeadPartMap.clear();
 	PartMap.clear();
 	FinalPartMap.clear();
 	ActionMap.clear();
-	DeadActionMap.clear();
 	cell=new CB3DCell***[2*NXY];
 	int ix,iy,ieta;
 	for(ix=0;ix<2*NXY;ix++){
@@ -152,25 +165,14 @@ CB3D::CB3D(string run_name_set){
 		}
 	}
 	randy=new CRandom(-1234);
-	// create particle objects, and put into deadpartmap
-	int ipart;
-	partarray=new CPart *[NPARTSMAX];
-	for(ipart=0;ipart<NPARTSMAX;ipart++){
-		partarray[ipart]=new CPart();
-	}
-	// create array of action objects
-	int iaction;
 	CAction::b3d=this;
-	actionarray=new CAction *[NACTIONSMAX];
-	for(iaction=0;iaction<NACTIONSMAX;iaction++){
-		actionarray[iaction]=new CAction();
-	}
 
 	reslist=new CResList();
 	if(INELASTIC) inelasticlist = new CInelasticList();
 	oscarfile=NULL;
 	h5infile=NULL;
 	h5outfile=NULL;
+	h5stream=NULL;
 	viz_file_id=-1;
 	
 	ptype=new CompType(sizeof(CPartH5));
@@ -209,51 +211,46 @@ CB3D::CB3D(string run_name_set){
 			annihilation_array[i]=0.0;
 		}
 	}
+	master=this;
+	domain=NULL;
+	if(NDOMAINS>1)
+		InitDomains();
+}
+
+// The streams of CResInfo::ranptr and of the engines are seeded from randy.
+// The pools are restacked as well, since the listids of the particles, the
+// keys of PartMap, would otherwise depend on the events before.
+void CB3D::SetSeed(int seed){
+	Reset();
+	if(!partpool.Restack() || !actionpool.Restack()){
+		printf("CB3D::SetSeed, cannot restack the pools, %d particles and %d actions are still in use\n",
+			partpool.CountTotal()-partpool.CountFree(),actionpool.CountTotal()-actionpool.CountFree());
+		exit(1);
+	}
+	randy->reset(seed);
+	CResInfo::ranptr->reset(1+int(randy->iran(2147483646)));
+	if(domain!=NULL){
+		for(int idomain=0;idomain<NDOMAINS;idomain++)
+			domain[idomain]->randy->reset(1+int(randy->iran(2147483646)));
+	}
 }
 
+// the particle and action objects are created here, more are added by the pools as needed
 void CB3D::InitArrays(){
-	int ipart,alpha;
 	PartMap.clear();
-	DeadPartMap.clear();
 	FinalPartMap.clear();
-	for(ipart=0;ipart<NPARTSMAX;ipart++){
-		partarray[ipart]->listid=ipart;
-		partarray[ipart]->key=ipart;
-		partarray[ipart]->tau0=0.0;
-		partarray[ipart]->tauexit=0.0;
-		partarray[ipart]->tau_lastint=0.0;
-		partarray[ipart]->currentmap=&DeadPartMap;
-		partarray[ipart]->cell=NULL;
-		partarray[ipart]->actionmap.clear();
-		partarray[ipart]->active=false;
-		partarray[ipart]->taudecay=0.0;
-		reslist->GetResInfoptr(211,partarray[ipart]->resinfo);
-		for(alpha=0;alpha<4;alpha++){
-			partarray[ipart]->r[alpha]=partarray[ipart]->p[alpha]=0.0;
-		}
-		partarray[ipart]->r[0]=1.0;
-		partarray[ipart]->tau0=1.0;
-		partarray[ipart]->p[0]=139.58;
-		partarray[ipart]->y=partarray[ipart]->eta=0.0;
-		DeadPartMap.insert(CPartPair(partarray[ipart]->key,partarray[ipart]));
-	}
-	// create array of action objects
 	ActionMap.clear();
-	DeadActionMap.clear();
-	int iaction;
-	for(iaction=0;iaction<NACTIONSMAX;iaction++){
-		actionarray[iaction]->listid=iaction;
-		actionarray[iaction]->key=iaction;
-		actionarray[iaction]->tau=0.0;
-		actionarray[iaction]->type=-1;
-		actionarray[iaction]->currentmap=&DeadActionMap;
-		DeadActionMap.insert(CActionPair(actionarray[iaction]->key,actionarray[iaction]));
-	}
+	partpool.Grow(NPARTSMAX);
+	actionpool.Grow(NACTIONSMAX);
 }
 
 void CB3D::SetQualifier(string qualifier_set){
 	ievent_write=ievent_read=0;
 	qualifier=qualifier_set;
+	if(h5stream!=NULL){
+		delete h5stream;
+		h5stream=NULL;
+	}
 	if(h5outfile!=NULL) delete h5outfile;
 	if(h5infile!=NULL) delete h5infile;
 #ifdef VIZWRITE
@@ -268,6 +265,8 @@ void CB3D::SetQualifier(string qualifier_set){
 	system(command.c_str());
 	outfilename="output/"+run_name+"/"+qualifier+"/b3d.h5";
 	h5outfile = new H5File(outfilename,H5F_ACC_TRUNC);
+	if(H5STREAM)
+		h5stream=new CB3DH5Stream(h5outfile,ptype,H5_CHUNKSIZE,H5_COMPRESSION,H5_WRITERTHREAD);
 	h5infile=NULL;
 	oscarfilename="output/"+run_name+"/"+qualifier+"/oscar.dat";
 
@@ -312,6 +311,8 @@ int CB3D::ReadDataH5(int ievent){
 	KillAllActions();
 	nactions=0;
 	KillAllParts();
+	if(h5stream!=NULL)
+		h5stream->Wait();
 	if(h5infile==NULL){
 		string infilename="output/"+run_name+"/"+qualifier+"/hydro.h5";
 		h5infile = new H5File(infilename,H5F_ACC_RDONLY);
@@ -330,14 +331,10 @@ int CB3D::ReadDataH5(int ievent){
 	int rank=filespace.getSimpleExtentDims(dim);
 	nparts=dim[0];
 	CPartH5 *partH5=new CPartH5[nparts];
-	if(nparts>NPARTSMAX){
-		printf("Increase NPARTSMAX, nparts=%d\n",nparts);
-		exit(1);
-	}
 	dataset->read(partH5,*ptype);
 	delete dataset;
 	for(ipart=0;ipart<nparts;ipart++){
-		partarray[ipart]->Init(partH5[ipart].ID,partH5[ipart].x,partH5[ipart].y,partH5[ipart].tau,partH5[ipart].eta,
+		partpool.Get()->Init(partH5[ipart].ID,partH5[ipart].x,partH5[ipart].y,partH5[ipart].tau,partH5[ipart].eta,
 			partH5[ipart].px,partH5[ipart].py,partH5[ipart].mass,partH5[ipart].rapidity);
 	}
 	delete [] partH5;
@@ -349,15 +346,14 @@ void CB3D::MovePartsToFinalMap(){
 	CPart *part;
 	CPartMap::iterator ppos,pppos;
 	CB3DCell *c;
-	int ix,iy,ieta,iaction;
+	int ix,iy,ieta;
 	for(ix=0;ix<2*NXY;ix++){
 		for(iy=0;iy<2*NXY;iy++){
 			for(ieta=0;ieta<2*NETA;ieta++){
 				c=cell[ix][iy][ieta];
-				while(c->partmap.size()>0){
-					//printf("partmap size=%d\n",int(c->partmap.size()));
-					ppos=c->partmap.begin();
-					part=ppos->second;
+				while(c->partlist.size()>0){
+					//printf("partlist size=%d\n",int(c->partlist.size()));
+					part=c->partlist.back();
 					if(part->cell!=c){
 						printf("cells don't match\n");
 					}
@@ -367,21 +363,14 @@ void CB3D::MovePartsToFinalMap(){
 						exit(1);
 					}
 					part->ChangeMap(&FinalPartMap);
-					part->DeleteFromMap(&c->partmap);
+					c->RemovePart(part);
 					part->cell=NULL;
 				}
-				c->partmap.clear();
 			}
 		}
 	}
-	DeadActionMap.clear();
-	for(iaction=0;iaction<NACTIONSMAX;iaction++){
-		actionarray[iaction]->listid=iaction;
-		actionarray[iaction]->key=iaction;
-		DeadActionMap.insert(CActionPair(actionarray[iaction]->key,actionarray[iaction]));
-	}
-	if(DeadActionMap.size()!=NACTIONSMAX){
-		printf("DeadActionMap wrong length = %d\n",int(DeadActionMap.size()));
+	if(actionpool.CountFree()!=actionpool.CountTotal()){
+		printf("%d actions still scheduled\n",actionpool.CountTotal()-actionpool.CountFree());
 	}
 }
 
@@ -392,7 +381,8 @@ double CB3D::WriteDataH5(){
 	CPartMap::iterator ppos;
 	ievent_write+=1;
 	int nparts=int(FinalPartMap.size());
-	CPartH5 *partH5=new CPartH5[nparts];
+	h5buffer.resize(nparts);
+	CPartH5 *partH5=(nparts>0) ? &h5buffer[0] : NULL;
 	ppos=FinalPartMap.begin();
 	ipart=0;
 	while(ppos!=FinalPartMap.end()){
@@ -437,11 +427,16 @@ double CB3D::WriteDataH5(){
 		ipart+=1;
 		part->Kill();
 	}
-	if(int(DeadPartMap.size())!=NPARTSMAX){
+	if(partpool.CountFree()!=partpool.CountTotal()){
 		printf("some particles still out there\n");
 		exit(1);
 	}
 
+	if(h5stream!=NULL){
+		printf("writing  for event %d, nparts=%d\n",ievent_write,ipart);
+		h5stream->Write(ievent_write,h5buffer);
+		return dnchdeta/(2.0*ETAMAX);
+	}
 	hsize_t dim[] = {nparts};   /* Dataspace dimensions */
 	DataSpace space(1,dim );
 	DataSet* dataset;
@@ -449,10 +444,10 @@ double CB3D::WriteDataH5(){
 	sprintf(event_number,"event%d",ievent_write);
 	printf("writing  for event %s, nparts=%d\n",event_number,ipart);
 	dataset = new DataSet(h5outfile->createDataSet(event_number,*ptype, space));
-	dataset->write(partH5,*ptype);
+	if(nparts>0)
+		dataset->write(partH5,*ptype);
 
 	delete dataset;
-	delete [] partH5;
 	return dnchdeta/(2.0*ETAMAX);
 }
 
@@ -563,37 +558,45 @@ void CB3D::PerformAllActions(){
 		}
 		//PrintActionMap(&ActionMap);
 	}
-	CActionMap::iterator epos=ActionMap.begin();
 	//cout << ActionMap.size() << " actions to perform" << endl;
 	CAction *action;
 	nscatter=ndecay=npass=nmerge=nswallow=npass=nexit=nactivate=ninelastic=ncheck=nactionkills=0;
 	ncollisions=nannihilate=0;
 	tau=0.0;
 	nactions=0;	
-	while(epos!=ActionMap.end()){
-		action=epos->second;
-		action->Perform();
-		epos=ActionMap.begin();
+	if(domain!=NULL)
+		PerformDomainActions();
+	else{
+		while(!ActionMap.empty()){
+			action=ActionMap.top();
+			action->Perform();
+		}
 	}
 	MovePartsToFinalMap();
 	/*
 	printf("Actions Finished, nactions=%lld\n",nactions);
 	printf("%d actions in ActionMap\n",int(ActionMap.size()));
-	printf("%d actions in DeadActionMap\n",int(DeadActionMap.size()));
+	printf("%d of %d actions free\n",actionpool.nfree,actionpool.ntotal);
 	printf("%d particles in FinalPartMap\n",int(FinalPartMap.size()));
 	printf("%d particles in PartMap\n",int(PartMap.size()));
-	printf("%d particles in DeadPartMap\n",int(DeadPartMap.size()));
+	printf("%d of %d particles free\n",partpool.nfree,partpool.ntotal);
 	*/
 
 }
 
 void CB3D::KillAllActions(){
 	CAction *action;
-	CActionMap::iterator epos=ActionMap.begin();
-	while(epos!=ActionMap.end()){
-		action=epos->second;
+	while(!ActionMap.empty()){
+		action=ActionMap.top();
 		action->Kill();
-		epos=ActionMap.begin();
+	}
+	if(domain!=NULL){
+		for(int idomain=0;idomain<NDOMAINS;idomain++){
+			while(!domain[idomain]->ActionMap.empty()){
+				action=domain[idomain]->ActionMap.top();
+				action->Kill();
+			}
+		}
 	}
 	nactions=0;
 }
@@ -618,12 +621,9 @@ void CB3D::KillAllParts(){
 	for(ix=0;ix<2*NXY;ix++){
 		for(iy=0;iy<2*NXY;iy++){
 			for(ieta=0;ieta<2*NETA;ieta++){
-				partmap=&(cell[ix][iy][ieta]->partmap);
-				ppos=partmap->begin();
-				while(ppos!=partmap->end()){
-					part=ppos->second;
+				while(!cell[ix][iy][ieta]->partlist.empty()){
+					part=cell[ix][iy][ieta]->partlist.back();
 					part->Kill();
-					ppos=partmap->begin();
 				}
 			}
 		}
@@ -644,13 +644,23 @@ void CB3D::PrintActionMap(CActionMap *actionmap){
 	}
 }
 
+void CB3D::PrintActionMap(CActionQueue *actionqueue){
+	vector<CAction *> actionlist;
+	int iaction;
+	actionqueue->GetSorted(actionlist);
+	printf("_________________ ACTIONMAP %d actions _________________________\n",int(actionlist.size()));
+	for(iaction=0;iaction<int(actionlist.size());iaction++){
+		printf("iaction=%d : ",iaction+1);
+		actionlist[iaction]->Print();
+	}
+}
+
 void CB3D::FindAllCollisions(){
 	double taucoll;
 	CPartMap::iterator ppos1,ppos2;
 	CPart *part1,*part2;
-	CActionMap::iterator epos;
 	CAction *action;
-	int nbefore=ActionMap.size();
+	int iaction,nbefore=ActionMap.size();
 	//printf("CB3D::FindAllCollisions, Resetting Collisions\n");
 
 	for(ppos1=PartMap.begin();ppos1!=PartMap.end();++ppos1){
@@ -658,8 +668,8 @@ void CB3D::FindAllCollisions(){
 		part1->KillActions();
 	}
 
-	for(epos=ActionMap.begin();epos!=ActionMap.end();++epos){
-		action=epos->second;
+	for(iaction=0;iaction<ActionMap.size();iaction++){
+		action=ActionMap[iaction];
 		if(action->type==2){
 			printf("CB3D::FindAllCollisions, expected all type-2 actions to be dead\n");
 			exit(1);
@@ -698,18 +708,18 @@ void CB3D::PrintPartList(){
 }
 
 void CB3D::ListFutureCollisions(){
-	CActionMap::iterator epos=ActionMap.begin();
+	vector<CAction *> actionlist;
 	CAction *action;
 	CPartMap::iterator p1,p2;
+	ActionMap.GetSorted(actionlist);
 	printf("------------------- LIST OF FUTURE COLLISIONS ---------------------\n");
-	while(epos!=ActionMap.end()){
-		action=epos->second;
+	for(int iaction=0;iaction<int(actionlist.size());iaction++){
+		action=actionlist[iaction];
 		if(action->type==2){
 			p1=action->partmap.begin();
 			p2=p1; ++p2;
 			printf("%d  %d  will collide at %g\n",p1->second->listid,p2->second->listid,double(action->tau));
 		}
-		epos++;
 	}
 }
 
@@ -956,6 +966,19 @@ void CB3D::Reset(){
 }
 
 CB3D::~CB3D(){
+	if(domain!=NULL){
+		for(int idomain=0;idomain<NDOMAINS;idomain++)
+			delete domain[idomain];
+		delete [] domain;
+	}
+	// an engine shares everything else with the master
+	if(master!=this){
+		delete randy;
+		if(ANNIHILATION_CHECK)
+			delete [] annihilation_array;
+		return;
+	}
+	delete h5stream;
 	delete h5outfile;
 #ifdef VIZWRITE
 	if(VIZWRITE){
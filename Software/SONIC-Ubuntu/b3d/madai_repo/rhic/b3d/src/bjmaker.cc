@@ -87,7 +87,7 @@ int CBjMaker::GenerateParticles(){
 			randy->generate_boltzmann(m,T,p);
 			mt=sqrt(m*m+p[1]*p[1]+p[2]*p[2]);
 			rapidity=eta+asinh(p[3]/mt);
-			b3d->partarray[nparts]->Init(resinfo->code,x,y,tau,eta,p[1],p[2],resinfo->mass,rapidity);
+			b3d->partpool.Get()->Init(resinfo->code,x,y,tau,eta,p[1],p[2],resinfo->mass,rapidity);
 			nparts+=1;
 		}
 		resinfo=resinfo->nextResInfoptr;
@@ -131,7 +131,7 @@ void CBjMaker::GenerateParticles_Gaussian(int nparts){
 		randy->generate_boltzmann(m,T,p);
 		mt=sqrt(m*m+p[1]*p[1]+p[2]*p[2]);
 		rapidity=eta+asinh(p[3]/mt);
-		b3d->partarray[ipart]->Init(resinfo->code,x,y,tau,eta,p[1],p[2],m,rapidity);
+		b3d->partpool.Get()->Init(resinfo->code,x,y,tau,eta,p[1],p[2],m,rapidity);
 	}
 }
 
@@ -172,7 +172,7 @@ void CBjMaker::GenerateParticles_Gaussian_Balance(int nparts){
 			randy->generate_boltzmann(m,T,p);
 			mt=sqrt(m*m+p[1]*p[1]+p[2]*p[2]);
 			rapidity=eta+asinh(p[3]/mt);
-			b3d->partarray[2*ipart+ii]->Init(ID,x,y,tau,eta,p[1],p[2],m,rapidity);
+			b3d->partpool.Get()->Init(ID,x,y,tau,eta,p[1],p[2],m,rapidity);
 		}
 	}
 	printf("CBjMaker::GenerateParticles_Gaussian_Balance, %d particles generated\n",nparts);
@@ -4,18 +4,39 @@
 #include "b3d.h"
 using namespace std;
 
-CB3D *CB3DCell::b3d=NULL;
+__thread CB3D *CB3DCell::b3d=NULL;
 
 CB3DCell::CB3DCell(double xminset,double xmaxset,double yminset,double ymaxset,double etaminset,double etamaxset){
 	xmin=xminset; xmax=xmaxset; ymin=yminset; ymax=ymaxset; etamin=etaminset; etamax=etamaxset;	
 	ireflection=0;
 	creflection=NULL;
+	idomain=0;
+	border=false;
+}
+
+void CB3DCell::AddPart(CPart *part){
+	part->cellpos=int(partlist.size());
+	partlist.push_back(part);
+}
+
+void CB3DCell::RemovePart(CPart *part){
+	int ipart=part->cellpos;
+	if(ipart<0 || ipart>=int(partlist.size()) || partlist[ipart]!=part){
+		printf("FATAL: In CB3DCell::RemovePart, particle is not in cell\n");
+		part->Print();
+		printf("cell has %d parts\n",int(partlist.size()));
+		exit(1);
+	}
+	partlist[ipart]=partlist.back();
+	partlist[ipart]->cellpos=ipart;
+	partlist.pop_back();
+	part->cellpos=-1;
 }
 
 void CB3DCell::Print(){
 	printf("___ CELL INFO _____\n");
 	printf("ix=%d, iy=%d, ieta=%d, xmin=%g, xmax=%g, ymin=%g, ymax=%g, etamin=%g, etamax=%g\n", ix,iy,ieta,xmin,xmax,ymin,ymax,etamin,etamax);
-	printf("%d parts in cell\n",int(partmap.size()));
+	printf("%d parts in cell\n",int(partlist.size()));
 	printf("---------------------\n");
 }
 
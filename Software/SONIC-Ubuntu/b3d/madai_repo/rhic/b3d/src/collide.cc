@@ -9,7 +9,7 @@ using namespace std;
 int CB3D::Collide(CPart *part1,CPart *part2){
 	CPartMap::iterator ppos;
 	const double g[4]={1,-1,-1,-1};
-	double sigma=0.0,sigma_annihilation,sigma_inel,Gamma,G,G2,MR,M,m1,m2,b,q2,q3,q4,qR2,tan2delta,scompare;
+	double sigma=0.0,sigmamax,sigma_annihilation,sigma_inel,Gamma,G,G2,MR,M,m1,m2,b,q2,q3,q4,qR2,tan2delta,scompare;
 	double mt,P[4],q[4],r[4],qdotr,P2,Pdotq,Pdotr,rsquared;
 	const int NWMAX=5000;
 	double weight[NWMAX]={0.0};
@@ -110,6 +110,18 @@ int CB3D::Collide(CPart *part1,CPart *part2){
 		else q2=Misc::triangle(M,m1,m2);
 	}
 
+	//Skip merging and inelastic scattering if even the upper bound of their cross sections can not reach scompare
+	bool reachable=true;
+	if(merge!=NULL && q2>0.0){
+		sigmamax=sigma+1.000001*reslist->MergeSigmaBound[ir1][ir2]/(q2*double(NSAMPLE));
+		if(INELASTIC)
+			sigmamax+=SIGMAINELASTIC/double(NSAMPLE);
+		if(sigmamax<scompare){
+			reachable=false;
+			merge=NULL;
+		}
+	}
+
 	//Check for merging
 	while(merge!=NULL){
 		Gamma=merge->resinfo->width;
@@ -121,8 +133,9 @@ int CB3D::Collide(CPart *part1,CPart *part2){
 
 		if(m1+m2<MR){
 			qR2=Misc::triangle(MR,m1,m2);
+			// (2L+1)/2 and 2L/2 are both L in integer arithmetic
 			q3=pow(q2/qR2,(2*L_merge + 1)/2);
-			q4=pow(q2/qR2,(2*L_merge)/2);
+			q4=q3;
 			G=Gamma*(MR/M)*q3*1.2/(1.0+0.2*q4);
 			tan2delta=0.25*G*G/((M-MR)*(M-MR));
 
@@ -145,7 +158,7 @@ int CB3D::Collide(CPart *part1,CPart *part2){
 
 	//Check for Inelastic Scatering
 	//inel_d = (2.0*j1+1.0)*(2.0*j2+1.0)*q2;
-	if(INELASTIC){
+	if(INELASTIC && reachable){
 		if(sigma+(SIGMAINELASTIC/double(NSAMPLE))>scompare){
 			if(part1->resinfo->G_Parity && part2->resinfo->G_Parity){
 				G_Parity = true;
@@ -0,0 +1,230 @@
+#ifndef __DOMAIN_CC__
+#define __DOMAIN_CC__
+
+#include "b3d.h"
+using namespace std;
+
+// Parallel cascade, B3D_NDOMAINS>1. The domains are slabs of the lattice in x.
+// A cell is on the border if one of its neighbors lies in another domain.
+// Decays, collisions and cell exits whose particles stay in non-border cells
+// of one domain (and activations into such a cell) go to that domain's
+// engine, everything else to the master. Since the engines never touch a
+// border cell, the engines of different domains share no particles or cells.
+//
+// The cascade moves forward in windows of DOMAIN_DTAU: the engines first
+// perform their actions of the window in parallel, then the master performs
+// the actions of all queues left in the window in time order. An engine hands
+// an action to the master if one of its particles has an earlier action
+// scheduled with the master. Actions of the master within a window may
+// therefore see particles of the engines at times later than their own, a
+// collision is only accepted after the last interaction of both particles.
+//
+// For the same seed the events do not depend on the threads: every engine has
+// pools of its own (see CB3DPool::Adopt) and its own random numbers, the
+// master's pools are only touched between the windows, and actions the engines
+// add to the master's queue are ordered by listid at equal tau (CActionQueue::Share).
+
+void CB3D::InitDomains(){
+	int ix,iy,ieta,jx,jy,jeta,idomain,imax;
+	CB3DCell *c,*c2;
+	CB3D *engine;
+	CRandom *engine_randy;
+	if(NDOMAINS>2*NXY){
+		printf("CB3D::InitDomains, B3D_NDOMAINS=%d can not be larger than 2*B3D_NXY=%d\n",NDOMAINS,2*NXY);
+		exit(1);
+	}
+	for(ix=0;ix<2*NXY;ix++){
+		for(iy=0;iy<2*NXY;iy++){
+			for(ieta=0;ieta<2*NETA;ieta++)
+				cell[ix][iy][ieta]->idomain=ix*NDOMAINS/(2*NXY);
+		}
+	}
+	for(ix=0;ix<2*NXY;ix++){
+		for(iy=0;iy<2*NXY;iy++){
+			for(ieta=0;ieta<2*NETA;ieta++){
+				c=cell[ix][iy][ieta];
+				c->border=false;
+				for(jx=0;jx<3;jx++){
+					for(jy=0;jy<3;jy++){
+						for(jeta=0;jeta<3;jeta++){
+							c2=c->neighbor[jx][jy][jeta];
+							if(c2!=NULL && c2->idomain!=c->idomain)
+								c->border=true;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	// the engines start as copies of the master, with pools of their own in the master's family
+	domain=new CB3D *[NDOMAINS];
+	for(idomain=0;idomain<NDOMAINS;idomain++){
+		engine=new CB3D();
+		engine_randy=engine->randy;
+		*engine=*this;
+		engine->randy=engine_randy;
+		engine->randy->reset(-1235-idomain);
+		engine->master=this;
+		engine->domain=NULL;
+		engine->partpool=CB3DPool<CPart>();
+		engine->actionpool=CB3DPool<CAction>();
+		partpool.Adopt(&engine->partpool,NDOMAINS+1);
+		actionpool.Adopt(&engine->actionpool,NDOMAINS+1);
+		engine->h5outfile=engine->h5infile=NULL;
+		engine->h5stream=NULL;
+		engine->oscarfile=NULL;
+		if(ANNIHILATION_CHECK){
+			imax=lrint(TAUCOLLMAX);
+			engine->annihilation_array=new double[imax];
+			for(int i=0;i<imax;i++)
+				engine->annihilation_array[i]=0.0;
+		}
+		domain[idomain]=engine;
+	}
+	printf("parallel cascade with %d domains, window dtau=%g\n",NDOMAINS,DOMAIN_DTAU);
+}
+
+// type and particles as in AddAction_*, called before the particles are added to the action
+CActionQueue *CB3D::GetActionQueue(int type,CPart *part1,CPart *part2,double taction){
+	CB3DCell *cell1,*cell2=NULL;
+	if(master->domain==NULL || taction>=TAUCOLLMAX)
+		return &(master->ActionMap);
+	if(type==0)
+		cell1=part1->FindCell();
+	else if(type==1)
+		cell1=part1->cell;
+	else if(type==2){
+		cell1=part1->cell;
+		cell2=part2->cell;
+		// the products of an annihilation are placed in between the two particles
+		if(ANNIHILATION_CHECK && cell1!=cell2)
+			return &(master->ActionMap);
+	}
+	else if(type==6){
+		cell1=part1->cell;
+		cell2=part1->nextcell;
+		if(cell2==NULL)
+			return &(master->ActionMap);
+	}
+	else return &(master->ActionMap);
+	if(cell1==NULL || cell1->border)
+		return &(master->ActionMap);
+	if(cell2!=NULL && (cell2->border || cell2->idomain!=cell1->idomain))
+		return &(master->ActionMap);
+	return &(master->domain[cell1->idomain]->ActionMap);
+}
+
+// the earliest action of the master and the engines, NULL if there is none
+CAction *CB3D::GetNextAction(){
+	CAction *action=NULL;
+	int idomain;
+	if(!ActionMap.empty())
+		action=ActionMap.top();
+	for(idomain=0;idomain<NDOMAINS;idomain++){
+		if(!domain[idomain]->ActionMap.empty() && (action==NULL || domain[idomain]->ActionMap.top()->key<action->key))
+			action=domain[idomain]->ActionMap.top();
+	}
+	return action;
+}
+
+void CB3D::SetThreadContext(){
+	CPart::b3d=this;
+	CAction::b3d=this;
+	CB3DCell::b3d=this;
+	CResInfo::domainranptr=(this==master) ? NULL : randy;
+}
+
+void CB3D::PerformDomainActions(){
+	CAction *action;
+	CB3D *engine;
+	double tauwindow;
+	int idomain;
+	for(idomain=0;idomain<NDOMAINS;idomain++){
+		engine=domain[idomain];
+		engine->tau=0.0;
+		engine->nscatter=engine->ndecay=engine->nmerge=engine->nswallow=engine->npass=engine->nexit=0;
+		engine->nactivate=engine->ninelastic=engine->ncheck=engine->nactionkills=0;
+		engine->ncollisions=engine->nannihilate=0;
+		// the engines number their actions in disjoint ranges, CPart::actionmother is an int
+		engine->nactions=(long long int)(idomain+1)*(2147483647/(NDOMAINS+1));
+	}
+	while((action=GetNextAction())!=NULL){
+		if(action->key<TAUCOLLMAX){
+			tauwindow=action->key+DOMAIN_DTAU;
+			if(tauwindow>TAUCOLLMAX)
+				tauwindow=TAUCOLLMAX;
+			ActionMap.Share(true);
+#pragma omp parallel for schedule(dynamic,1)
+			for(idomain=0;idomain<NDOMAINS;idomain++){
+				domain[idomain]->SetThreadContext();
+				domain[idomain]->PerformDomainWindow(tauwindow);
+			}
+			ActionMap.Share(false);
+			SetThreadContext();
+			// in domain order, so that the free lists do not depend on the threads
+			for(idomain=0;idomain<NDOMAINS;idomain++){
+				domain[idomain]->partpool.Flush();
+				domain[idomain]->actionpool.Flush();
+			}
+		}
+		else tauwindow=1.0E99;
+		while((action=GetNextAction())!=NULL && action->key<tauwindow)
+			action->Perform();
+	}
+	MergeDomains();
+}
+
+void CB3D::PerformDomainWindow(double tauwindow){
+	CAction *action,*other;
+	CPartMap::iterator ppos;
+	CActionRefList *refs;
+	int iref;
+	unsigned int generation;
+	bool blocked;
+	while(!ActionMap.empty() && ActionMap.top()->key<tauwindow){
+		action=ActionMap.top();
+		blocked=false;
+		for(ppos=action->partmap.begin();ppos!=action->partmap.end();++ppos){
+			refs=&(ppos->second->actionmap);
+			for(iref=0;iref<int(refs->size());iref++){
+				other=(*refs)[iref].action;
+				// a stale reference may point to an action another engine is reusing
+#pragma omp atomic read
+				generation=other->generation;
+				if(other!=action && (*refs)[iref].generation==generation && other->key<=action->key)
+					blocked=true;
+			}
+		}
+		if(blocked){
+			ActionMap.erase(action);
+			master->ActionMap.insert(action);
+		}
+		else action->Perform();
+	}
+}
+
+// hand everything back to the master at the end of the event
+void CB3D::MergeDomains(){
+	int idomain,itau,imax=lrint(TAUCOLLMAX);
+	CB3D *engine;
+	for(idomain=0;idomain<NDOMAINS;idomain++){
+		engine=domain[idomain];
+		while(!engine->PartMap.empty())
+			engine->PartMap.begin()->second->ChangeMap(&PartMap);
+		while(!engine->FinalPartMap.empty())
+			engine->FinalPartMap.begin()->second->ChangeMap(&FinalPartMap);
+		nscatter+=engine->nscatter; ndecay+=engine->ndecay; nmerge+=engine->nmerge;
+		nswallow+=engine->nswallow; npass+=engine->npass; nexit+=engine->nexit;
+		nactivate+=engine->nactivate; ninelastic+=engine->ninelastic; ncheck+=engine->ncheck;
+		ncollisions+=engine->ncollisions; nannihilate+=engine->nannihilate;
+		if(ANNIHILATION_CHECK){
+			for(itau=0;itau<imax;itau++){
+				annihilation_array[itau]+=engine->annihilation_array[itau];
+				engine->annihilation_array[itau]=0.0;
+			}
+		}
+	}
+}
+
+#endif
@@ -25,7 +25,8 @@ double rhoovers;
 step = INTERP_STEP;
 e_max = INTERP_EMAX;
 
-int N = static_cast<int>(e_max/step);
+N = static_cast<int>(e_max/step);
+nmesh = 1;
 string parsfilename="eqofstpars.dat";
 
 
@@ -74,6 +75,7 @@ Cs2 = new double [N+1];     //using Cs2=sdens/dedT
 
 //Initialize
 e[0]=p[0]=t[0]=sdens[0]=Cs2[0]=0;
+tauIS_a[0]=B[0]=eta[0]=dedT[0]=0;
 intr->T=100;      
 intr->ZeroMu();
 eqofst->FreeGasCalc_of_TMu(intr); 
@@ -108,12 +110,14 @@ B[i]=intr->B;
 eta[i]=intr->eta;
 dedT[i]= intr->dedT;
 Cs2[i]= sdens[i]/dedT[i];
-
+nmesh = i+1;
 
 
 //printf("e=%g  P=%g  s=%g  T=%g  tau_a=%g  B=%g  eta=%g Cs2=%g dedT=%g\n",e[i],p[i],sdens[i],t[i],tauIS_a[i],B[i],eta[i],Cs2[i],dedT[i]);   
 	}
 
+MakeTable();
+
 //get dP/de
 //for(int i=1, epsilon=10;epsilon<e_max;epsilon+=step, i++){
 //dpde[i]=(p[i+1]-p[i])/(e[i+1]-e[i]);
@@ -146,7 +150,86 @@ delete[ ] eta;
 delete[ ] dpde;
 delete[ ] dedT;
 delete[ ] Cs2;
+delete[ ] table;
+
+}
 
+//=====================================================================================
+// Table for get and getAll. For the interval i, [i*step,(i+1)*step), the
+// get functions interpolate between e[i] and e[i+1]; their slopes are
+// computed here once. The entries of an interval are contiguous, so that
+// getAll reads one cache line or two.
+
+void CEos::MakeTable(){
+const int stride=1+2*EOS_NQ;
+double *q[EOS_NQ],*row;
+int i,iq;
+q[EOS_P]=p; q[EOS_T]=t; q[EOS_S]=sdens; q[EOS_CS2]=Cs2;
+q[EOS_TIS]=tauIS_a; q[EOS_SV]=eta; q[EOS_BV]=B;
+invstep=1.0/step;
+if(nmesh<2){
+  cout<<"In MakeTable: the mesh has less than two points"<<endl;
+  exit(1);
+}
+table = new double [(nmesh-1)*stride];
+for(i=0;i<nmesh-1;i++){
+  row=&table[i*stride];
+  row[0]=e[i];
+  for(iq=0;iq<EOS_NQ;iq++){
+    row[1+2*iq]=q[iq][i];
+    row[2+2*iq]=(q[iq][i+1]-q[iq][i])/(e[i+1]-e[i]);
+  }
+}
+}
+
+//=====================================================================================
+// Batch interpolation: y[k] is the value of quantity (EOS_P ... EOS_BV) at
+// energy density x[k]. Same limits as the get functions, except that e_max
+// itself and the intervals beyond the last mesh point are taken from the
+// last interval rather than from outside the arrays.
+
+void CEos::get(int quantity,int n,const double *x,double *y){
+const int stride=1+2*EOS_NQ;
+const double *row;
+int k,i,imax=nmesh-2;
+if(quantity<0 || quantity>=EOS_NQ){
+  cout<<"In get: no quantity "<<quantity<<endl;
+  exit(1);
+}
+for(k=0;k<n;k++){
+  if(x[k]<0) cout<<"epsilon is negative..."<<endl;
+  else if(x[k]>e_max){
+    cout<<"In get: epsilon>e_max not allowed"<<endl;
+    exit(1);
+  }
+  i=static_cast<int>(x[k]*invstep);
+  if(i<0) i=0;
+  if(i>imax) i=imax;
+  row=&table[i*stride];
+  y[k]=row[1+2*quantity]+row[2+2*quantity]*(x[k]-row[0]);
+}
+}
+
+//=====================================================================================
+// All quantities at one energy density, y[EOS_P] ... y[EOS_BV]
+
+void CEos::getAll(double x,double *y){
+const int stride=1+2*EOS_NQ;
+const double *row;
+double dx;
+int i,iq;
+if(x<0) cout<<"epsilon is negative..."<<endl;
+else if(x>e_max){
+  cout<<"In getAll: epsilon>e_max not allowed"<<endl;
+  exit(1);
+}
+i=static_cast<int>(x*invstep);
+if(i<0) i=0;
+if(i>nmesh-2) i=nmesh-2;
+row=&table[i*stride];
+dx=x-row[0];
+for(iq=0;iq<EOS_NQ;iq++)
+  y[iq]=row[1+2*iq]+row[2+2*iq]*dx;
 }
 
 //=====================================================================================
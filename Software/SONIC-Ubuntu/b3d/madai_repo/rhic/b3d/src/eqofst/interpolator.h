@@ -13,6 +13,9 @@ class CEos{
   double step ;
   double e_max ;
   int N ; 
+  int nmesh ;                 // number of mesh points filled by the constructor
+  double invstep ;
+  double* table;              // per interval: e[i], then value and slope of each quantity
   
   double* e ;
   double* p ;
@@ -37,5 +40,13 @@ class CEos{
   double getSV(double e);   // returns shear viscosity (1/fm)
   double getBV(double e);   // returns bulk viscosity (1/fm)
 
+  // same interpolation from a table of precomputed slopes, without the search and division of the get functions
+  enum {EOS_P,EOS_T,EOS_S,EOS_CS2,EOS_TIS,EOS_SV,EOS_BV,EOS_NQ};
+  void get(int quantity,int n,const double *e,double *y);  // y[k] = quantity at e[k] for k<n
+  void getAll(double e,double *y);                          // y[quantity] for all EOS_NQ quantities
+  double getEmax(){return e_max;}
+
+ private:
+  void MakeTable();
 }; 
 #endif
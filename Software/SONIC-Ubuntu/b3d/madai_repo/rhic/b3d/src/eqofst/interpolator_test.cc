@@ -10,6 +10,7 @@
 #include <cmath>
 #include <cstdio>
 #include <complex>
+#include <ctime>
 #define __FIRST_STATIC_DEF__
 #include <gsl/gsl_sf.h>
 #include <eqofst.h>
@@ -59,6 +60,43 @@ cout<<"Shear viscosity (1/fm) = "<<eta<<endl;
 cout<<"Bulk viscosity (1/fm) = "<<B<<endl;
 cout<<"================================================="<<endl;
 
-return(0);
+//fast backend section: get and getAll against the get functions above on a sweep of e
+const int nsweep=100003;  //prime, so that the sweep points miss the mesh points
+const char *name[CEos::EOS_NQ]={"Pressure","Temperature","Entropy density","Speed of Sound","Relaxation time","Shear viscosity","Bulk viscosity"};
+double (CEos::*getref[CEos::EOS_NQ])(double)={&CEos::getP,&CEos::getT,&CEos::getS,&CEos::getCs2,&CEos::getTIS,&CEos::getSV,&CEos::getBV};
+double *esweep=new double[nsweep],*yref=new double[nsweep],*yfast=new double[nsweep];
+double yall[CEos::EOS_NQ],dev,maxdev,tref=0,tfast=0;
+bool pass=true;
+clock_t start;
+for(int k=0;k<nsweep;k++) esweep[k]=interpolator->getEmax()*(k+0.5)/nsweep;
+cout<<"Fast interpolation, max relative deviation on "<<nsweep<<" points:"<<endl;
+for(int iq=0;iq<CEos::EOS_NQ;iq++){
+  start=clock();
+  for(int k=0;k<nsweep;k++) yref[k]=(interpolator->*getref[iq])(esweep[k]);
+  tref+=double(clock()-start)/CLOCKS_PER_SEC;
+  start=clock();
+  interpolator->get(iq,nsweep,esweep,yfast);
+  tfast+=double(clock()-start)/CLOCKS_PER_SEC;
+  maxdev=0;
+  for(int k=0;k<nsweep;k++){
+    dev=fabs(yfast[k]-yref[k])/(fabs(yref[k])+1.0E-300);
+    if(dev>maxdev) maxdev=dev;
+    if(k%97==0){
+      interpolator->getAll(esweep[k],yall);
+      dev=fabs(yall[iq]-yref[k])/(fabs(yref[k])+1.0E-300);
+      if(dev>maxdev) maxdev=dev;
+    }
+  }
+  if(maxdev>1.0E-10) pass=false;
+  cout<<" "<<name[iq]<<": "<<maxdev<<endl;
+}
+cout<<"get functions "<<tref<<" s, batch get "<<tfast<<" s"<<endl;
+cout<<(pass ? "PASSED" : "FAILED")<<endl;
+cout<<"================================================="<<endl;
+delete [] esweep;
+delete [] yref;
+delete [] yfast;
+
+return(pass ? 0 : 1);
 }
 #endif
@@ -24,14 +24,13 @@ bool CB3D::FindCollision(CPart *part1,CPart *part2,double &taucoll){
 	double q[4],P[4],r[4],p1dotp2=0.0,p1dotr=0.0,p2dotr=0.0,p1squared=0.0,p2squared=0.0,rsquared=0.0;
 	double tau1,tau2,eta1,y1,mt,t1,t2,z1,z2,x1,x2,y2,u[4];
 	double *p1=part1->p,*p2=part2->p,*r1=part1->r,*r2=part2->r;
+	double p1flip[4],r1flip[4];
 	double pibsquared;
 	const int g[4]={1,-1,-1,-1};
 	int alpha;
-	bool flip=false;
 	if(BJORKEN && ((cell1->ieta==0 && cell2->ieta==2*NETA-1) || (cell1->ieta==2*NETA-1 && cell2->ieta==0))){
-		flip=true;
-		p1=new double[4];
-		r1=new double[4];
+		p1=p1flip;
+		r1=r1flip;
 		for(alpha=0;alpha<4;alpha++){
 			p1[alpha]=part1->p[alpha]; r1[alpha]=part1->r[alpha];
 		}
@@ -85,7 +84,8 @@ bool CB3D::FindCollision(CPart *part1,CPart *part2,double &taucoll){
 				tau2=sqrt(t2*t2-z2*z2);
 				taucoll=0.5*(tau1+tau2);
 		//printf("tau1=%g,tau2=%g, taucoll=%g\n",tau1,tau2,taucoll);
-				if(taucoll>tau && taucoll<part1->tauexit && taucoll<part2->tauexit && taucoll<TAUCOLLMAX){
+				// the tau0 are behind tau in the serial cascade, but not always in the parallel one
+				if(taucoll>tau && taucoll>part1->tau0 && taucoll>part2->tau0 && taucoll<part1->tauexit && taucoll<part2->tauexit && taucoll<TAUCOLLMAX){
 					collide=true;
 					//printf("taucoll=%13.7e\n",taucoll);
 				}
@@ -96,10 +96,6 @@ bool CB3D::FindCollision(CPart *part1,CPart *part2,double &taucoll){
 			}
 		}
 	}
-	if(flip){
-		delete [] r1; delete [] p1;
-	}
-
 
 	if(collide==true){
 		//CB3DCell *cell1=part1->cell;
@@ -114,4 +110,100 @@ bool CB3D::FindCollision(CPart *part1,CPart *part2,double &taucoll){
 	return collide;
 }
 
+// Tests part1 against all particles of cell2 (a neighbor of part1->cell) and
+// schedules the collisions, with the same result as calling FindCollision for
+// every pair. The candidates are copied NBATCH at a time into local arrays,
+// the tests are then evaluated for the whole batch without branches, and
+// only the accepted pairs go on to AddAction_Collision.
+void CB3D::FindCollisions(CPart *part1,CB3DCell *cell2){
+	const int NBATCH=32;
+	CB3DCell *cell1=part1->cell;
+	CPart *part2,*batch[NBATCH];
+	double p1[4],r1[4],p1squared,eta1,y1,mt;
+	double r2[4][NBATCH],p2[4][NBATCH],tauexit2[NBATCH],tau02[NBATCH],taucoll[NBATCH];
+	bool accept[NBATCH];
+	double tauexit1=part1->tauexit,taumax,taumin;
+	int alpha,ipart,ibatch,nbatch,nparts=int(cell2->partlist.size());
+	CPart **partlist=&(cell2->partlist[0]);
+
+	if(part1->active==false || cell1==NULL){
+		printf("FindCollisions:: Why am I here?\n");
+		part1->Print();
+		exit(1);
+	}
+	for(alpha=0;alpha<4;alpha++){
+		p1[alpha]=part1->p[alpha]; r1[alpha]=part1->r[alpha];
+	}
+	if(BJORKEN && ((cell1->ieta==0 && cell2->ieta==2*NETA-1) || (cell1->ieta==2*NETA-1 && cell2->ieta==0))){
+		if(cell1->ieta==0){
+			eta1=part1->eta+2.0*ETAMAX; y1=part1->y+2.0*ETAMAX;
+		}
+		else{
+			eta1=part1->eta-2.0*ETAMAX; y1=part1->y-2.0*ETAMAX;
+		}
+		r1[0]=part1->tau0*cosh(eta1);
+		r1[3]=part1->tau0*sinh(eta1);
+		mt=part1->resinfo->mass;
+		mt=sqrt(mt*mt+p1[1]*p1[1]+p1[2]*p1[2]);
+		p1[0]=mt*cosh(y1);
+		p1[3]=mt*sinh(y1);
+	}
+	p1squared=p1[0]*p1[0]-p1[1]*p1[1]-p1[2]*p1[2]-p1[3]*p1[3];
+	taumax=(tauexit1<TAUCOLLMAX) ? tauexit1 : TAUCOLLMAX;
+	taumin=(part1->tau0>tau) ? part1->tau0 : tau;
+
+	ipart=0;
+	while(ipart<nparts){
+		nbatch=0;
+		while(ipart<nparts && nbatch<NBATCH){
+			part2=partlist[ipart];
+			ipart+=1;
+			if(part2==part1 || part2->actionmother==part1->actionmother)
+				continue;
+			if(part2->active==false){
+				printf("FindCollisions:: Why am I here?\n");
+				part1->Print();
+				part2->Print();
+				exit(1);
+			}
+			batch[nbatch]=part2;
+			for(alpha=0;alpha<4;alpha++){
+				r2[alpha][nbatch]=part2->r[alpha];
+				p2[alpha][nbatch]=part2->p[alpha];
+			}
+			tauexit2[nbatch]=part2->tauexit;
+			tau02[nbatch]=part2->tau0;
+			nbatch+=1;
+		}
+
+		// same arithmetic as in FindCollision, so that the same pairs are accepted
+		for(ibatch=0;ibatch<nbatch;ibatch++){
+			double r0=r1[0]-r2[0][ibatch],rx=r1[1]-r2[1][ibatch],ry=r1[2]-r2[2][ibatch],rz=r1[3]-r2[3][ibatch];
+			double q0=p2[0][ibatch],qx=p2[1][ibatch],qy=p2[2][ibatch],qz=p2[3][ibatch];
+			double rsquared=r0*r0-rx*rx-ry*ry-rz*rz;
+			double p1dotp2=p1[0]*q0-p1[1]*qx-p1[2]*qy-p1[3]*qz;
+			double p1dotr=p1[0]*r0-p1[1]*rx-p1[2]*ry-p1[3]*rz;
+			double p2dotr=q0*r0-qx*rx-qy*ry-qz*rz;
+			double p2squared=q0*q0-qx*qx-qy*qy-qz*qz;
+			double denom=p1dotp2*p1dotp2-p1squared*p2squared;
+			double pibsquared=PI*(-rsquared+(2.0*p1dotp2*p1dotr*p2dotr-p1dotr*p1dotr*p2squared-p2dotr*p2dotr*p1squared)/denom);
+			double t1=p1[0]*(p1dotr*p2squared-p2dotr*p1dotp2)/denom;
+			double t2=-q0*(p2dotr*p1squared-p1dotr*p1dotp2)/denom;
+			double z1=r1[3]+(p1[3]/p1[0])*t1;
+			double z2=r2[3][ibatch]+(qz/q0)*t2;
+			bool ahead=(t1+r1[0]>0) & (t2+r2[0][ibatch]>0);
+			t1+=r1[0];
+			t2+=r2[0][ibatch];
+			taucoll[ibatch]=0.5*(sqrt(fabs(t1*t1-z1*z1))+sqrt(fabs(t2*t2-z2*z2)));
+			accept[ibatch]=ahead & (pibsquared<SIGMAMAX) & (fabs(z1)<t1) & (fabs(z2)<t2)
+				& (taucoll[ibatch]>taumin) & (taucoll[ibatch]>tau02[ibatch]) & (taucoll[ibatch]<taumax) & (taucoll[ibatch]<tauexit2[ibatch]);
+		}
+
+		for(ibatch=0;ibatch<nbatch;ibatch++){
+			if(accept[ibatch])
+				AddAction_Collision(part1,batch[ibatch],taucoll[ibatch]);
+		}
+	}
+}
+
 #endif
@@ -0,0 +1,167 @@
+#ifndef __H5STREAM_CC__
+#define __H5STREAM_CC__
+
+#include "b3d.h"
+#ifndef H5_NO_NAMESPACE
+using namespace H5;
+#endif
+using namespace std;
+
+CB3DH5Stream::CB3DH5Stream(H5File *h5file,CompType *ptypeset,int chunksize,int compression,bool writerthreadset){
+	hsize_t dim[1]={0},maxdim[1]={H5S_UNLIMITED},chunkdim[1];
+	DataSpace partspace(1,dim,maxdim),eventspace(1,dim,maxdim);
+	DSetCreatPropList partlist,eventlist;
+	if(chunksize<1){
+		printf("CB3DH5Stream: B3D_H5_CHUNKSIZE=%d must be positive\n",chunksize);
+		exit(1);
+	}
+	ptype=ptypeset;
+	etype=MakeEventType();
+	chunkdim[0]=chunksize;
+	partlist.setChunk(1,chunkdim);
+	if(compression>0){
+		if(H5Zfilter_avail(H5Z_FILTER_DEFLATE)>0)
+			partlist.setDeflate(compression);
+		else
+			printf("CB3DH5Stream: deflate is not available in this HDF5 library, b3d.h5 will not be compressed\n");
+	}
+	chunkdim[0]=256;
+	eventlist.setChunk(1,chunkdim);
+	partset=new DataSet(h5file->createDataSet("particles",*ptype,partspace,partlist));
+	eventset=new DataSet(h5file->createDataSet("events",*etype,eventspace,eventlist));
+	npartswritten=0;
+	neventswritten=0;
+	writerthread=writerthreadset;
+	busy=false;
+}
+
+CB3DH5Stream::~CB3DH5Stream(){
+	Wait();
+	delete partset;
+	delete eventset;
+	delete etype;
+}
+
+void CB3DH5Stream::Write(int ievent,vector<CPartH5> &parts){
+	Wait();
+	pending.swap(parts);
+	pendingievent=ievent;
+	if(writerthread){
+		if(pthread_create(&writer,NULL,WriterMain,this)!=0){
+			printf("CB3DH5Stream: cannot start the writer thread\n");
+			exit(1);
+		}
+		busy=true;
+	}
+	else Append();
+}
+
+void CB3DH5Stream::Wait(){
+	if(busy){
+		pthread_join(writer,NULL);
+		busy=false;
+	}
+}
+
+void *CB3DH5Stream::WriterMain(void *stream){
+	((CB3DH5Stream *)stream)->Append();
+	return NULL;
+}
+
+// extends both datasets and writes the pending event to the new entries
+void CB3DH5Stream::Append(){
+	hsize_t size[1],offset[1],count[1];
+	CEventH5 event;
+	int nparts=int(pending.size());
+	if(nparts>0){
+		size[0]=npartswritten+nparts;
+		partset->extend(size);
+		DataSpace filespace=partset->getSpace();
+		offset[0]=npartswritten;
+		count[0]=nparts;
+		filespace.selectHyperslab(H5S_SELECT_SET,count,offset);
+		DataSpace memspace(1,count);
+		partset->write(&pending[0],*ptype,memspace,filespace);
+	}
+	event.ievent=pendingievent;
+	event.nparts=nparts;
+	event.offset=npartswritten;
+	size[0]=neventswritten+1;
+	eventset->extend(size);
+	DataSpace filespace=eventset->getSpace();
+	offset[0]=neventswritten;
+	count[0]=1;
+	filespace.selectHyperslab(H5S_SELECT_SET,count,offset);
+	DataSpace memspace(1,count);
+	eventset->write(&event,*etype,memspace,filespace);
+	npartswritten+=nparts;
+	neventswritten+=1;
+}
+
+CompType *CB3DH5Stream::MakeEventType(){
+	CompType *etype=new CompType(sizeof(CEventH5));
+	etype->insertMember("ievent",HOFFSET(CEventH5,ievent),PredType::NATIVE_INT);
+	etype->insertMember("nparts",HOFFSET(CEventH5,nparts),PredType::NATIVE_INT);
+	etype->insertMember("offset",HOFFSET(CEventH5,offset),PredType::NATIVE_LLONG);
+	return etype;
+}
+
+int CB3DH5Stream::GetNEvents(H5File *h5file){
+	hsize_t dim[1];
+	if(H5Lexists(h5file->getId(),"events",H5P_DEFAULT)<=0)
+		return -1;
+	DataSet eventset=h5file->openDataSet("events");
+	eventset.getSpace().getSimpleExtentDims(dim);
+	return int(dim[0]);
+}
+
+// The events are written in order, so event ievent is normally the ievent-th
+// entry of the index; otherwise the whole index is searched for it.
+int CB3DH5Stream::Read(H5File *h5file,CompType *ptype,int ievent,CPartH5 *parts,int npartsmax){
+	hsize_t offset[1],count[1],dim[1];
+	CEventH5 event;
+	int ientry;
+	CompType *etype=MakeEventType();
+	DataSet eventset=h5file->openDataSet("events");
+	DataSpace eventspace=eventset.getSpace();
+	eventspace.getSimpleExtentDims(dim);
+	event.ievent=-1;
+	if(ievent>=1 && hsize_t(ievent)<=dim[0]){
+		offset[0]=ievent-1;
+		count[0]=1;
+		eventspace.selectHyperslab(H5S_SELECT_SET,count,offset);
+		DataSpace eventmemspace(1,count);
+		eventset.read(&event,*etype,eventmemspace,eventspace);
+	}
+	if(event.ievent!=ievent && dim[0]>0){
+		vector<CEventH5> index(dim[0]);
+		eventset.read(&index[0],*etype);
+		for(ientry=0;ientry<int(dim[0]);ientry++){
+			if(index[ientry].ievent==ievent){
+				event=index[ientry];
+				break;
+			}
+		}
+	}
+	delete etype;
+	if(event.ievent!=ievent){
+		printf("CB3DH5Stream::Read, event %d is not in the index of the file\n",ievent);
+		exit(1);
+	}
+	if(event.nparts>npartsmax){
+		printf("Increase B3D_NPARTSMAX, nparts=%d, npartsmax=%d\n",event.nparts,npartsmax);
+		exit(1);
+	}
+	if(event.nparts>0){
+		DataSet partset=h5file->openDataSet("particles");
+		DataSpace partspace=partset.getSpace();
+		offset[0]=event.offset;
+		count[0]=event.nparts;
+		partspace.selectHyperslab(H5S_SELECT_SET,count,offset);
+		DataSpace partmemspace(1,count);
+		partset.read(parts,*ptype,partmemspace,partspace);
+	}
+	return event.nparts;
+}
+
+#endif
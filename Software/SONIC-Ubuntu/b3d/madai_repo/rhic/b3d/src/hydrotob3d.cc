@@ -16,7 +16,6 @@ void CHYDROtoB3D::Init(){
 	T=1000.0*parameter::getD(b3d->parmap,"HYDRO_FOTEMP",160.0);
 	ETAMAX=b3d->ETAMAX;
 	randy=b3d->randy;
-	MC_Ntarget=0.0;
 	MC_Nbar=0.0;
 	MC_NWrite=0;
 	nsample=b3d->NSAMPLE;
@@ -39,6 +38,7 @@ void CHYDROtoB3D::Init(){
 		}
 		resinfo=resinfo->nextResInfoptr;
 	}
+	InitSpecies();
 	GetLambdaFact();
 	//TestLambdaFact();
 	initialization=true;
@@ -58,7 +58,6 @@ void CHYDROtoB3D::Init3D(){
 	DETA=parameter::getD(b3d->parmap,"HYDRO_DN",0.1);
 	ETAMAX=NETA*DETA;
 	randy=b3d->randy;
-	MC_Ntarget=0.0;
 	MC_Nbar=0.0;
 	MC_NWrite=0;
 	nsample=b3d->NSAMPLE;
@@ -86,6 +85,7 @@ void CHYDROtoB3D::Init3D(){
 		}
 		resinfo=resinfo->nextResInfoptr;
 	}
+	InitSpecies();
 	GetLambdaFact();
 	//TestLambdaFact();
 	initialization=true;
@@ -181,20 +181,17 @@ void CHYDROtoB3D::ReadInput3D(){
 // -------------------------------------------------------------------
 
 int CHYDROtoB3D::MakeEvent(){
-	meanpt=0.0;
-	meanu=0.0;
-	normpt=0;
-	etot=vtot=0.0;
 	b3d->Reset();
-	int nparts=0,iring;
-	MC_NWrite=0;
-	MC_Nbar=0.0;
+	int nparts,iring;
 	Ncheck=0.0;
-	nparts=0;
-	MC_Ntarget=-log(randy->ran());
+	// one chunk for each ring
+	StartChunks(nrings-1);
+#pragma omp parallel for schedule(dynamic,1)
 	for(iring=1;iring<nrings;iring++){
-		nparts+=GenerateParticles(iring);
+		chunk[iring-1].Start();
+		GenerateParticles(iring,&chunk[iring-1]);
 	}
+	nparts=AddChunks();
 	
 		//	printf("before b3d, nparts=%d, meanpt for pions=%g\n",nparts,meanpt/double(normpt));
 	/** printf("nparts=%d, MC_Nbar=%g\n",nparts,MC_Nbar);
@@ -205,43 +202,96 @@ int CHYDROtoB3D::MakeEvent(){
 }
 
 int CHYDROtoB3D::MakeEvent3D(){
-	meanpt=0.0;
-	meanu=0.0;
-	normpt=0;
-	etot=vtot=0.0;
 	b3d->Reset();
-	int nparts=0,iring,ieta;
-	MC_NWrite=0;
-	MC_Nbar=0.0;
+	int nparts,iring,ieta,ichunk;
+	vector<int> chunkieta,chunkiring;
 	Ncheck=0.0;
-	nparts=0;
-	MC_Ntarget=-log(randy->ran());
+	// one chunk for each ring of each eta slice
 	for(ieta=0;ieta<NETA;ieta++){
 		for(iring=1;iring<nrings3d[ieta];iring++){
-			nparts+=GenerateParticles3D(ieta,iring);
+			chunkieta.push_back(ieta);
+			chunkiring.push_back(iring);
 		}
 	}
+	StartChunks(int(chunkieta.size()));
+#pragma omp parallel for schedule(dynamic,1)
+	for(ichunk=0;ichunk<nchunks;ichunk++){
+		chunk[ichunk].Start();
+		GenerateParticles3D(chunkieta[ichunk],chunkiring[ichunk],&chunk[ichunk]);
+	}
+	nparts=AddChunks();
+	return nparts;
+}
+
+// the species table, densities at the freeze-out temperature are computed once in Init
+void CHYDROtoB3D::InitSpecies(){
+	int ires;
+	CResInfo *resinfo=reslist->GfirstResInfoptr;
+	speciesID=new int[nres];
+	speciesmass=new double[nres];
+	speciesdNbar=new double[nres];
+	nspecies=0;
+	for(ires=0;ires<nres;ires++){
+		if(resinfo->code!=22){
+			speciesID[nspecies]=resinfo->code;
+			speciesmass[nspecies]=resinfo->mass;
+			speciesdNbar[nspecies]=density[ires]*nsample;
+			nspecies+=1;
+		}
+		resinfo=resinfo->nextResInfoptr;
+	}
+	nchunks=0;
+}
+
+// The seeds of the chunks' streams are drawn from the event's stream
+void CHYDROtoB3D::StartChunks(int nchunksset){
+	int ichunk;
+	nchunks=nchunksset;
+	if(int(chunk.size())<nchunks)
+		chunk.resize(nchunks);
+	for(ichunk=0;ichunk<nchunks;ichunk++)
+		chunk[ichunk].seed=1+int(randy->iran(2147483646));
+}
+
+// Adds the samples to the cascade one chunk after the other, returns the number of particles
+int CHYDROtoB3D::AddChunks(){
+	int ichunk,isample,nparts=0;
+	CHydroChunk *c;
+	CHydroSample *sample;
+	meanpt=meanu=etot=vtot=MC_Nbar=0.0;
+	normpt=MC_NWrite=0;
+	for(ichunk=0;ichunk<nchunks;ichunk++){
+		c=&chunk[ichunk];
+		for(isample=0;isample<int(c->sample.size());isample++){
+			sample=&(c->sample[isample]);
+			b3d->partpool.Get()->Init(sample->ID,sample->x,sample->y,sample->tau,sample->eta,sample->px,sample->py,sample->mass,sample->rapidity);
+		}
+		nparts+=int(c->sample.size());
+		meanpt+=c->meanpt; meanu+=c->meanu; normpt+=c->normpt;
+		etot+=c->etot; vtot+=c->vtot;
+		MC_Nbar+=c->MC_Nbar; MC_NWrite+=c->MC_NWrite;
+	}
 	return nparts;
 }
 
 // -----------------------------------------------
 
-int CHYDROtoB3D::GenerateParticles(int iring){
+int CHYDROtoB3D::GenerateParticles(int iring,CHydroChunk *chunk){
 	CRing *earlier=&ring[iring-1];
 	CRing *later=&ring[iring];
+	CRandom *randy=chunk->randy;
 	//printf("iring1=%d, tau1=%g, iring2=%d, tau2=%g\n",iring-1,earlier->tau,iring,later->tau);
-	CResInfo *resinfo;
 	double dNbarmax;
 	int ncalls;
 	//MC_Ntarget-=log(randy->ran())/nsample;
-	int ires,iquad;
+	int ispecies,iquad;
 	int iphi1,iphi2,alpha,beta,nphi=later->nphi,nparts=0;
 	double V0,Vx,Vy,V,V2,Vmag,x1[3],x2[3],y1[3],y2[3],a[3],b[3];
 	double smallestr,biggestr,cphi1,sphi1,cphi2,sphi2,phi1,phi2,rx,ry,w,r;
 	double zsize,lambda[4][4],u[4]={1.0,0.0,0.0,0.0},pdotV,pdotu,udotV,wmax,gamma;
 	double ptilde[4],p[4],pt,y,et,weight,minv,mass,eta,tau,wx,wy,x[4];
 	 
-	int ID,ipart;
+	int ID;
 	for(iphi1=0;iphi1<nphi;iphi1++){
 		//printf("iphi1=%d, nphi=%d, ",iphi1,nphi);
 		//printf("r1=%g r2=%g\n",earlier->r[iphi1],later->r[iphi1]);
@@ -281,7 +331,7 @@ int CHYDROtoB3D::GenerateParticles(int iring){
 		udotV=u[0]*V0-u[1]*Vx-u[2]*Vy;
 		V=sqrt(fabs(V2));
 		//etot+=V*(304.0*u[0]*u[0]+50.3*(u[0]*u[0]-1.0));
-		vtot+=V;
+		chunk->vtot+=V;
 		//printf("phi1=%g, phi2=%g, V=%g\n",phi1*180/PI,phi2*180/PI,V);
 		//printf("iphi1=%d, V=%g=(%g,%g,%g), u=(%g,%g,%g)\n",iphi1,V,V0,Vx,Vy,u[0],u[1],u[2]);
 		//printf("a=(%g,%g,%g), b=(%g,%g,%g)\n",a[0],a[1],a[2],b[0],b[1],b[2]);
@@ -307,135 +357,123 @@ int CHYDROtoB3D::GenerateParticles(int iring){
 				x1[0],x1[1],x1[2],x2[0],x2[1],x2[2],y1[0],y1[2],y1[2],y2[0],y2[1],y2[2]);
 			printf("V0=%g, Vx=%g, Vy=%g\n",V0,Vx,Vy);
 			printf("V2=%g, V=%g, gamma=%g, udotV=%g wmax=%g\n",V2,V,gamma,udotV,wmax);
-			printf("fabs(MC_Nbar)=%g\n",fabs(MC_Nbar));
+			printf("fabs(MC_Nbar)=%g\n",fabs(chunk->MC_Nbar));
 			exit(1);
 		}
-		resinfo=reslist->GfirstResInfoptr;
-		for(ires=0;ires<nres;ires++){
-			ID=resinfo->code;
-			if(ID!=22){
-				dNbarmax=density[ires]*wmax*double(nsample);
-				//if(ID==211 || ID==-211 || ID==111) printf("dNBarmax=%g\n",dNbarmax);
-				MC_Nbar+=dNbarmax;
-				while(MC_Nbar>MC_Ntarget){
-					MC_Ntarget-=log(randy->ran());
-					//MC_Ntarget+=1.0;
-					mass=resinfo->mass;
-					randy->generate_boltzmann(mass,T,ptilde);
-					for(alpha=1;alpha<4;alpha++){
-						p[alpha]=0.0;
-						for(beta=1;beta<4;beta++) p[alpha]+=ptilde[beta]*lambda[alpha][beta];
-						p[0]=sqrt(mass*mass+p[1]*p[1]+p[2]*p[2]+p[3]*p[3]);
-					}
-					
-					for(alpha=0;alpha<4;alpha++) ptilde[alpha]=p[alpha];
-					Misc::Boost(u,ptilde,p);
-					pt=sqrt(p[1]*p[1]+p[2]*p[2]);
+		for(ispecies=0;ispecies<nspecies;ispecies++){
+			ID=speciesID[ispecies];
+			mass=speciesmass[ispecies];
+			dNbarmax=speciesdNbar[ispecies]*wmax;
+			//if(ID==211 || ID==-211 || ID==111) printf("dNBarmax=%g\n",dNbarmax);
+			chunk->MC_Nbar+=dNbarmax;
+			while(chunk->MC_Nbar>chunk->MC_Ntarget){
+				chunk->MC_Ntarget-=log(randy->ran());
+				//MC_Ntarget+=1.0;
+				randy->generate_boltzmann(mass,T,ptilde);
+				for(alpha=1;alpha<4;alpha++){
+					p[alpha]=0.0;
+					for(beta=1;beta<4;beta++) p[alpha]+=ptilde[beta]*lambda[alpha][beta];
+					p[0]=sqrt(mass*mass+p[1]*p[1]+p[2]*p[2]+p[3]*p[3]);
+				}
+				
+				for(alpha=0;alpha<4;alpha++) ptilde[alpha]=p[alpha];
+				Misc::Boost(u,ptilde,p);
+				pt=sqrt(p[1]*p[1]+p[2]*p[2]);
 
+				pdotu=p[0]*u[0]-p[1]*u[1]-p[2]*u[2];
+				pdotV=p[0]*V0-p[1]*Vx-p[2]*Vy;
+				if(pdotV>0.0){
 					pdotu=p[0]*u[0]-p[1]*u[1]-p[2]*u[2];
-					pdotV=p[0]*V0-p[1]*Vx-p[2]*Vy;
-					if(pdotV>0.0){
-						pdotu=p[0]*u[0]-p[1]*u[1]-p[2]*u[2];
-						weight=(pdotV/pdotu)/wmax;
-						if(weight>1.00000001){
-							printf("Weight too large, weight=%g\n",weight);
-							printf("V0=%g, Vx=%g, Vy=%g\n",V0,Vx,Vy);
-							printf("p=(%g,%g,%g,%g), V2=%g, pdotV=%g, V/udotV=%g\n",p[0],p[1],p[2],p[3],V2,pdotV,(V/udotV));
-							//exit(1);
+					weight=(pdotV/pdotu)/wmax;
+					if(weight>1.00000001){
+						printf("Weight too large, weight=%g\n",weight);
+						printf("V0=%g, Vx=%g, Vy=%g\n",V0,Vx,Vy);
+						printf("p=(%g,%g,%g,%g), V2=%g, pdotV=%g, V/udotV=%g\n",p[0],p[1],p[2],p[3],V2,pdotV,(V/udotV));
+						//exit(1);
+					}
+					if(randy->ran()<weight){
+						chunk->MC_NWrite+=1;
+						chunk->etot+=p[0];
+						nparts+=1;
+						
+						rx=sqrt( pow(0.5*(x1[1]+x2[1]),2) + pow(0.5*(x1[2]+x2[2]),2) );
+						ry=sqrt( pow(0.5*(y1[1]+y2[1]),2) + pow(0.5*(y1[2]+y2[2]),2) );
+
+						w=randy->ran();
+						r=sqrt(w*rx*rx+(1.0-w)*ry*ry);
+						if((r>rx && r>ry) || (r<rx && r<ry)){
+							printf("r is out of range in CHYDROtoB3D::GenerateParticles, = %g, rx=%g,ry=%g\n",r,rx,ry);
+							exit(1);
+						}
+						wx=fabs(ry-r)/fabs(ry-rx);
+						wy=1.0-wx;
+
+						for(alpha=1;alpha<3;alpha++){
+							x[alpha]=0.5*(wx*x1[alpha]+wx*x2[alpha]+wy*y1[alpha]+wy*y2[alpha]);
+							x[alpha]+=(0.5-randy->ran())*a[alpha];
+						}
+						eta=ETAMAX-2.0*randy->ran()*ETAMAX;
+						tau=wx*later->tau+wy*earlier->tau;
+						x[0]=tau*cosh(eta);
+						x[3]=tau*sinh(eta);
+						//printf("success: p=(%g,%g,%g,%g), x=(%g,%g,%g,%g), tau=%g, eta=%g\n",p[0],p[1],p[2],p[3],x[0],x[1],x[2],x[3],tau,eta);
+						et=sqrt(mass*mass+p[1]*p[1]+p[2]*p[2]);
+						y=0.5*log((p[0]+p[3])/(p[0]-p[3]));
+						y+=eta;
+						p[0]=et*cosh(y);
+						p[3]=et*sinh(y);
+						if(fabs(p[0]*p[0]-p[1]*p[1]-p[2]*p[2]-p[3]*p[3]-mass*mass)>1.0E-2){
+							printf("invariant mass screwed up, =%g !=%g\n",sqrt(p[0]*p[0]-p[1]*p[1]-p[2]*p[2]-p[3]*p[3]),mass);
+							printf("p=(%g,%g,%g,%g)\n",p[0],p[1],p[2],p[3]);
+							exit(1);
 						}
-						if(randy->ran()<weight){
-							MC_NWrite+=1;
-							etot+=p[0];
-							nparts+=1;
-							
-							rx=sqrt( pow(0.5*(x1[1]+x2[1]),2) + pow(0.5*(x1[2]+x2[2]),2) );
-							ry=sqrt( pow(0.5*(y1[1]+y2[1]),2) + pow(0.5*(y1[2]+y2[2]),2) );
-
-							w=randy->ran();
-							r=sqrt(w*rx*rx+(1.0-w)*ry*ry);
-							if((r>rx && r>ry) || (r<rx && r<ry)){
-								printf("r is out of range in CHYDROtoB3D::GenerateParticles, = %g, rx=%g,ry=%g\n",r,rx,ry);
-								exit(1);
-							}
-							wx=fabs(ry-r)/fabs(ry-rx);
-							wy=1.0-wx;
-
-							for(alpha=1;alpha<3;alpha++){
-								x[alpha]=0.5*(wx*x1[alpha]+wx*x2[alpha]+wy*y1[alpha]+wy*y2[alpha]);
-								x[alpha]+=(0.5-randy->ran())*a[alpha];
-							}
-							eta=ETAMAX-2.0*randy->ran()*ETAMAX;
-							tau=wx*later->tau+wy*earlier->tau;
-							x[0]=tau*cosh(eta);
-							x[3]=tau*sinh(eta);
-							//printf("success: p=(%g,%g,%g,%g), x=(%g,%g,%g,%g), tau=%g, eta=%g\n",p[0],p[1],p[2],p[3],x[0],x[1],x[2],x[3],tau,eta);
-							et=sqrt(mass*mass+p[1]*p[1]+p[2]*p[2]);
-							y=0.5*log((p[0]+p[3])/(p[0]-p[3]));
-							y+=eta;
-							p[0]=et*cosh(y);
-							p[3]=et*sinh(y);
-							if(fabs(p[0]*p[0]-p[1]*p[1]-p[2]*p[2]-p[3]*p[3]-mass*mass)>1.0E-2){
-								printf("invariant mass screwed up, =%g !=%g\n",sqrt(p[0]*p[0]-p[1]*p[1]-p[2]*p[2]-p[3]*p[3]),mass);
-								printf("p=(%g,%g,%g,%g)\n",p[0],p[1],p[2],p[3]);
-								exit(1);
-							}
-							
-							if(ID==111 || ID==211 || ID==-211){
-								meanpt+=sqrt(p[1]*p[1]+p[2]*p[2]);
-								//meanu+=(ptilde[1]*u[1]+ptilde[2]*u[2])/sqrt(ptilde[1]*ptilde[1]+ptilde[2]*ptilde[2]);
-								meanu+=(p[1]*u[1]+p[2]*u[2])/pt;
-								//meanu+=sqrt(u[1]*u[1]+u[2]*u[2]);
-								normpt+=1;
-							}
-							
-							iquad=lrint(floor(4*randy->ran()));
-							if(iquad==1 || iquad==2){
-								x[1]=-x[1];
-								p[1]=-p[1];
-							}
-							if(iquad==2 || iquad==3){
-								x[2]=-x[2];
-								p[2]=-p[2];
-							}
-							ipart=int(b3d->PartMap.size());
-							
-							
-							
-							//printf("%d: ID=%d, x=%g, y=%g, tau=%g, eta=%g, px=%g, py=%g, mass=%g, y=%g\n",ipart,ID,x[1],x[2],tau,eta,p[1],p[2],mass,y);
-							if(b3d->DeadPartMap.size()==0){
-								printf("MUST INCREASE NPARTSMAX!!!!\n");
-								exit(1);
-							}
-							b3d->partarray[ipart]->Init(ID,x[1],x[2],tau,eta,p[1],p[2],mass,y);
+						
+						if(ID==111 || ID==211 || ID==-211){
+							chunk->meanpt+=sqrt(p[1]*p[1]+p[2]*p[2]);
+							//meanu+=(ptilde[1]*u[1]+ptilde[2]*u[2])/sqrt(ptilde[1]*ptilde[1]+ptilde[2]*ptilde[2]);
+							chunk->meanu+=(p[1]*u[1]+p[2]*u[2])/pt;
+							//meanu+=sqrt(u[1]*u[1]+u[2]*u[2]);
+							chunk->normpt+=1;
 						}
+						
+						iquad=lrint(floor(4*randy->ran()));
+						if(iquad==1 || iquad==2){
+							x[1]=-x[1];
+							p[1]=-p[1];
+						}
+						if(iquad==2 || iquad==3){
+							x[2]=-x[2];
+							p[2]=-p[2];
+						}
+						//printf("ID=%d, x=%g, y=%g, tau=%g, eta=%g, px=%g, py=%g, mass=%g, y=%g\n",ID,x[1],x[2],tau,eta,p[1],p[2],mass,y);
+						chunk->Add(ID,x[1],x[2],tau,eta,p[1],p[2],mass,y);
 					}
-				//else{
-					//printf("pdotV < 0, =%g\n",pdotV);
-				//}
 				}
+			//else{
+				//printf("pdotV < 0, =%g\n",pdotV);
+			//}
 			}
-			resinfo=resinfo->nextResInfoptr;
 		}
 	}
 	return nparts;
 }
 
-int CHYDROtoB3D::GenerateParticles3D(int ieta,int iring){
+int CHYDROtoB3D::GenerateParticles3D(int ieta,int iring,CHydroChunk *chunk){
 	CRing *earlier=&ring3d[ieta][iring-1];
 	CRing *later=&ring3d[ieta][iring];
+	CRandom *randy=chunk->randy;
 	//printf("iring1=%d, tau1=%g, iring2=%d, tau2=%g\n",iring-1,earlier->tau,iring,later->tau);
-	CResInfo *resinfo;
 	double dNbarmax,etamin,etamax;
 	
 	int ncalls;
 	//MC_Ntarget-=log(randy->ran())/nsample;
-	int ires,iquad;
+	int ispecies,iquad;
 	int iphi1,iphi2,alpha,beta,nphi=later->nphi,nparts=0;
 	double V0,Vx,Vy,V,V2,Vmag,x1[3],x2[3],y1[3],y2[3],a[3],b[3];
 	double smallestr,biggestr,cphi1,sphi1,cphi2,sphi2,phi1,phi2;
 	double zsize,lambda[4][4],u[4]={1.0,0.0,0.0,0.0},pdotV,pdotu,udotV,wmax,gamma;
 	double ptilde[4],p[4],pt,y,et,weight,minv,mass,eta,tau,wx,wy,x[4];	 
-	int ID,ipart;
+	int ID;
 	etamin=ring3d[ieta][iring].etamin;
 	etamax=ring3d[ieta][iring].etamax;
 	//printf("ieta=%d, iring=%d, etamin=%g, etamax=%g\n",ieta,iring,etamin,etamax);
@@ -478,7 +516,7 @@ int CHYDROtoB3D::GenerateParticles3D(int ieta,int iring){
 		udotV=u[0]*V0-u[1]*Vx-u[2]*Vy;
 		V=sqrt(fabs(V2));
 		//etot+=V*(304.0*u[0]*u[0]+50.3*(u[0]*u[0]-1.0));
-		vtot+=V;
+		chunk->vtot+=V;
 		//printf("phi1=%g, phi2=%g, V=%g\n",phi1*180/PI,phi2*180/PI,V);
 		//printf("iphi1=%d, V=%g=(%g,%g,%g), u=(%g,%g,%g)\n",iphi1,V,V0,Vx,Vy,u[0],u[1],u[2]);
 		//printf("a=(%g,%g,%g), b=(%g,%g,%g)\n",a[0],a[1],a[2],b[0],b[1],b[2]);
@@ -504,104 +542,92 @@ int CHYDROtoB3D::GenerateParticles3D(int ieta,int iring){
 				x1[0],x1[1],x1[2],x2[0],x2[1],x2[2],y1[0],y1[2],y1[2],y2[0],y2[1],y2[2]);
 			printf("V0=%g, Vx=%g, Vy=%g\n",V0,Vx,Vy);
 			printf("V2=%g, V=%g, gamma=%g, udotV=%g wmax=%g\n",V2,V,gamma,udotV,wmax);
-			printf("fabs(MC_Nbar)=%g\n",fabs(MC_Nbar));
+			printf("fabs(MC_Nbar)=%g\n",fabs(chunk->MC_Nbar));
 			exit(1);
 		}
-		resinfo=reslist->GfirstResInfoptr;
-		for(ires=0;ires<nres;ires++){
-			ID=resinfo->code;
-			if(ID!=22){
-				dNbarmax=density[ires]*wmax*double(nsample);
-				//if(ID==211 || ID==-211 || ID==111) printf("dNBarmax=%g\n",dNbarmax);
-				MC_Nbar+=dNbarmax;
-				while(MC_Nbar>MC_Ntarget){
-					MC_Ntarget-=log(randy->ran());
-					//MC_Ntarget+=1.0;
-					mass=resinfo->mass;
-					randy->generate_boltzmann(mass,T,ptilde);
-					for(alpha=1;alpha<4;alpha++){
-						p[alpha]=0.0;
-						for(beta=1;beta<4;beta++) p[alpha]+=ptilde[beta]*lambda[alpha][beta];
-						p[0]=sqrt(mass*mass+p[1]*p[1]+p[2]*p[2]+p[3]*p[3]);
-					}
-					
-					for(alpha=0;alpha<4;alpha++) ptilde[alpha]=p[alpha];
-					Misc::Boost(u,ptilde,p);
-					pt=sqrt(p[1]*p[1]+p[2]*p[2]);
+		for(ispecies=0;ispecies<nspecies;ispecies++){
+			ID=speciesID[ispecies];
+			mass=speciesmass[ispecies];
+			dNbarmax=speciesdNbar[ispecies]*wmax;
+			//if(ID==211 || ID==-211 || ID==111) printf("dNBarmax=%g\n",dNbarmax);
+			chunk->MC_Nbar+=dNbarmax;
+			while(chunk->MC_Nbar>chunk->MC_Ntarget){
+				chunk->MC_Ntarget-=log(randy->ran());
+				//MC_Ntarget+=1.0;
+				randy->generate_boltzmann(mass,T,ptilde);
+				for(alpha=1;alpha<4;alpha++){
+					p[alpha]=0.0;
+					for(beta=1;beta<4;beta++) p[alpha]+=ptilde[beta]*lambda[alpha][beta];
+					p[0]=sqrt(mass*mass+p[1]*p[1]+p[2]*p[2]+p[3]*p[3]);
+				}
+				
+				for(alpha=0;alpha<4;alpha++) ptilde[alpha]=p[alpha];
+				Misc::Boost(u,ptilde,p);
+				pt=sqrt(p[1]*p[1]+p[2]*p[2]);
 
+				pdotu=p[0]*u[0]-p[1]*u[1]-p[2]*u[2];
+				pdotV=p[0]*V0-p[1]*Vx-p[2]*Vy;
+				if(pdotV>0.0){
 					pdotu=p[0]*u[0]-p[1]*u[1]-p[2]*u[2];
-					pdotV=p[0]*V0-p[1]*Vx-p[2]*Vy;
-					if(pdotV>0.0){
-						pdotu=p[0]*u[0]-p[1]*u[1]-p[2]*u[2];
-						weight=(pdotV/pdotu)/wmax;
-						if(weight>1.00000001){
-							printf("Weight too large, weight=%g\n",weight);
-							printf("V0=%g, Vx=%g, Vy=%g\n",V0,Vx,Vy);
-							printf("p=(%g,%g,%g,%g), V2=%g, pdotV=%g, V/udotV=%g\n",p[0],p[1],p[2],p[3],V2,pdotV,(V/udotV));
-							//exit(1);
+					weight=(pdotV/pdotu)/wmax;
+					if(weight>1.00000001){
+						printf("Weight too large, weight=%g\n",weight);
+						printf("V0=%g, Vx=%g, Vy=%g\n",V0,Vx,Vy);
+						printf("p=(%g,%g,%g,%g), V2=%g, pdotV=%g, V/udotV=%g\n",p[0],p[1],p[2],p[3],V2,pdotV,(V/udotV));
+						//exit(1);
+					}
+					if(randy->ran()<weight){
+						chunk->MC_NWrite+=1;
+						chunk->etot+=p[0];
+						nparts+=1;
+						wx=randy->ran();
+						wy=1.0-wx;
+						for(alpha=1;alpha<3;alpha++){
+							x[alpha]=0.5*(wx*x1[alpha]+wx*x2[alpha]+wy*y1[alpha]+wy*y2[alpha]);
+							x[alpha]+=(0.5-randy->ran())*a[alpha];
+						}
+						eta=etamin+randy->ran()*DETA;
+						if(randy->ran()<0.5) eta=-eta;
+						tau=wx*later->tau+wy*earlier->tau;
+						x[0]=tau*cosh(eta);
+						x[3]=tau*sinh(eta);
+						//printf("success: p=(%g,%g,%g,%g), x=(%g,%g,%g,%g), tau=%g, eta=%g\n",p[0],p[1],p[2],p[3],x[0],x[1],x[2],x[3],tau,eta);
+						et=sqrt(mass*mass+p[1]*p[1]+p[2]*p[2]);
+						y=0.5*log((p[0]+p[3])/(p[0]-p[3]));
+						y+=eta;
+						p[0]=et*cosh(y);
+						p[3]=et*sinh(y);
+						if(fabs(p[0]*p[0]-p[1]*p[1]-p[2]*p[2]-p[3]*p[3]-mass*mass)>1.0E-2){
+							printf("invariant mass screwed up, =%g !=%g\n",sqrt(p[0]*p[0]-p[1]*p[1]-p[2]*p[2]-p[3]*p[3]),mass);
+							printf("p=(%g,%g,%g,%g)\n",p[0],p[1],p[2],p[3]);
+							exit(1);
 						}
-						if(randy->ran()<weight){
-							MC_NWrite+=1;
-							etot+=p[0];
-							nparts+=1;
-							wx=randy->ran();
-							wy=1.0-wx;
-							for(alpha=1;alpha<3;alpha++){
-								x[alpha]=0.5*(wx*x1[alpha]+wx*x2[alpha]+wy*y1[alpha]+wy*y2[alpha]);
-								x[alpha]+=(0.5-randy->ran())*a[alpha];
-							}
-							eta=etamin+randy->ran()*DETA;
-							if(randy->ran()<0.5) eta=-eta;
-							tau=wx*later->tau+wy*earlier->tau;
-							x[0]=tau*cosh(eta);
-							x[3]=tau*sinh(eta);
-							//printf("success: p=(%g,%g,%g,%g), x=(%g,%g,%g,%g), tau=%g, eta=%g\n",p[0],p[1],p[2],p[3],x[0],x[1],x[2],x[3],tau,eta);
-							et=sqrt(mass*mass+p[1]*p[1]+p[2]*p[2]);
-							y=0.5*log((p[0]+p[3])/(p[0]-p[3]));
-							y+=eta;
-							p[0]=et*cosh(y);
-							p[3]=et*sinh(y);
-							if(fabs(p[0]*p[0]-p[1]*p[1]-p[2]*p[2]-p[3]*p[3]-mass*mass)>1.0E-2){
-								printf("invariant mass screwed up, =%g !=%g\n",sqrt(p[0]*p[0]-p[1]*p[1]-p[2]*p[2]-p[3]*p[3]),mass);
-								printf("p=(%g,%g,%g,%g)\n",p[0],p[1],p[2],p[3]);
-								exit(1);
-							}
-							
-							if(ID==111 || ID==211 || ID==-211){
-								meanpt+=sqrt(p[1]*p[1]+p[2]*p[2]);
-								//meanu+=(ptilde[1]*u[1]+ptilde[2]*u[2])/sqrt(ptilde[1]*ptilde[1]+ptilde[2]*ptilde[2]);
-								meanu+=(p[1]*u[1]+p[2]*u[2])/pt;
-								//meanu+=sqrt(u[1]*u[1]+u[2]*u[2]);
-								normpt+=1;
-							}
-							
-							iquad=lrint(floor(4*randy->ran()));
-							if(iquad==1 || iquad==2){
-								x[1]=-x[1];
-								p[1]=-p[1];
-							}
-							if(iquad==2 || iquad==3){
-								x[2]=-x[2];
-								p[2]=-p[2];
-							}
-							ipart=int(b3d->PartMap.size());
-							
-							
-							
-							//printf("%d: ID=%d, x=%g, y=%g, tau=%g, eta=%g, px=%g, py=%g, mass=%g, y=%g\n",ipart,ID,x[1],x[2],tau,eta,p[1],p[2],mass,y);
-							if(b3d->DeadPartMap.size()==0){
-								printf("MUST INCREASE NPARTSMAX!!!!\n");
-								exit(1);
-							}
-							b3d->partarray[ipart]->Init(ID,x[1],x[2],tau,eta,p[1],p[2],mass,y);
+						
+						if(ID==111 || ID==211 || ID==-211){
+							chunk->meanpt+=sqrt(p[1]*p[1]+p[2]*p[2]);
+							//meanu+=(ptilde[1]*u[1]+ptilde[2]*u[2])/sqrt(ptilde[1]*ptilde[1]+ptilde[2]*ptilde[2]);
+							chunk->meanu+=(p[1]*u[1]+p[2]*u[2])/pt;
+							//meanu+=sqrt(u[1]*u[1]+u[2]*u[2]);
+							chunk->normpt+=1;
 						}
+						
+						iquad=lrint(floor(4*randy->ran()));
+						if(iquad==1 || iquad==2){
+							x[1]=-x[1];
+							p[1]=-p[1];
+						}
+						if(iquad==2 || iquad==3){
+							x[2]=-x[2];
+							p[2]=-p[2];
+						}
+						//printf("ID=%d, x=%g, y=%g, tau=%g, eta=%g, px=%g, py=%g, mass=%g, y=%g\n",ID,x[1],x[2],tau,eta,p[1],p[2],mass,y);
+						chunk->Add(ID,x[1],x[2],tau,eta,p[1],p[2],mass,y);
 					}
-				//else{
-					//printf("pdotV < 0, =%g\n",pdotV);
-				//}
 				}
+			//else{
+				//printf("pdotV < 0, =%g\n",pdotV);
+			//}
 			}
-			resinfo=resinfo->nextResInfoptr;
 		}
 	}
 	return nparts;
@@ -764,6 +790,34 @@ void CHYDROtoB3D::ReadHeader3D(FILE *fptr){
 	}while(dummystring!="END_OF_HEADER\n");
 }
 
+CHydroChunk::CHydroChunk(){
+	randy=NULL;
+	seed=1;
+	MC_NWrite=normpt=0;
+	MC_Ntarget=MC_Nbar=meanpt=meanu=etot=vtot=0.0;
+}
+
+void CHydroChunk::Start(){
+	if(randy==NULL)
+		randy=new CRandom(seed);
+	else
+		randy->reset(seed);
+	MC_NWrite=normpt=0;
+	MC_Nbar=meanpt=meanu=etot=vtot=0.0;
+	sample.clear();
+	MC_Ntarget=-log(randy->ran());
+}
+
+void CHydroChunk::Add(int ID,double x,double y,double tau,double eta,double px,double py,double mass,double rapidity){
+	CHydroSample newsample;
+	newsample.ID=ID;
+	newsample.x=x; newsample.y=y; newsample.tau=tau; newsample.eta=eta;
+	newsample.px=px; newsample.py=py; newsample.mass=mass; newsample.rapidity=rapidity;
+	sample.push_back(newsample);
+}
+
+// -----------------------------------------------
+
 CRing::CRing(){
 	nphi=72;
 	int iphi,alpha,beta;
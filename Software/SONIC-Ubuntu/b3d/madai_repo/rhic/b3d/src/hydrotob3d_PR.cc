@@ -26,7 +26,6 @@ void CHYDROtoB3D::InitPR(){
 	T=parameter::getD(b3d->parmap,"HYDRO_FOTEMP",150.0);
 	ETAMAX=b3d->ETAMAX;
 	randy=b3d->randy;
-	MC_Ntarget=0.0;
 	MC_Nbar=0.0;
 	MC_NWrite=0;
 	nsample=b3d->NSAMPLE;
@@ -34,7 +33,8 @@ void CHYDROtoB3D::InitPR(){
 	nres=reslist->NResonances;
 	//printf("epsilon_H=%g\n",intrinsic->epsilon);
 	density=new double[nres];
-	prcell=new CPRCell[b3d->NPRCELLSMAX];
+	prcell=NULL;
+	nprcellsalloc=0;
 	epsilon=P=0.0;
 	CResInfo *resinfo=reslist->GfirstResInfoptr;
 	for(ires=0;ires<nres;ires++){
@@ -49,6 +49,8 @@ void CHYDROtoB3D::InitPR(){
 		}
 		resinfo=resinfo->nextResInfoptr;
 	}
+	InitSpecies();
+	NPRCHUNK=parameter::getI(b3d->parmap,"B3D_PR_CHUNKSIZE",64);
 	GetLambdaFact();
 	//TestLambdaFact();
 	CPRCell::T=T;
@@ -71,82 +73,167 @@ void CHYDROtoB3D::ReadInputPR(){
 	//modification by MH --- end
 
 	printf("freezeout info from %s\n",inputfilename.c_str());
-	input=fopen(inputfilename.c_str(),"r");
-	if(input != NULL){
-		nprcells=0;
-		do{
-			prcell[nprcells].Readbulk(input);
-			nprcells+=1;
-		}while(!feof(input));
-		fclose(input);
+	if(!ReadSurfacePR(inputfilename,true)){
+		printf("%s not found! Trying fallback\n",inputfilename.c_str());
+		//try usual freezeout file
+		string minputfilename="output/"+b3d->run_name+"/"+b3d->qualifier+"/freezeout.dat";
+		printf("freezeout info from %s\n",minputfilename.c_str());
+		ReadSurfacePR(minputfilename,false);
 	}
-	else
-	  {	    
-	    printf("%s not found! Trying fallback\n",inputfilename.c_str());
-	    //try usual freezeout file
-	    string minputfilename="output/"+b3d->run_name+"/"+b3d->qualifier+"/freezeout.dat";
-	    printf("freezeout info from %s\n",minputfilename.c_str());
-	    input=fopen(minputfilename.c_str(),"r");
-	    if(input != NULL){
-	      nprcells=0;
-	      do{
-		prcell[nprcells].Read(input);
+}
+
+// reads the cells of a freezeout_bulk.dat (bulk) or freezeout.dat surface into prcell,
+// replacing the previous surface. Returns false if the file can not be opened.
+bool CHYDROtoB3D::ReadSurfacePR(string filename,bool bulk){
+	if(!initialization) InitPR();
+	input=fopen(filename.c_str(),"r");
+	if(input==NULL)
+		return false;
+	nprcells=0;
+	do{
+		if(nprcells>=b3d->NPRCELLSMAX){
+			printf("CHYDROtoB3D::ReadSurfacePR, increase B3D_PR_NPRCELLSMAX, %s has more than %d cells\n",filename.c_str(),nprcells);
+			exit(1);
+		}
+		if(nprcells>=nprcellsalloc)
+			GrowPRCells();
+		if(bulk)
+			prcell[nprcells].Readbulk(input);
+		else
+			prcell[nprcells].Read(input);
 		nprcells+=1;
-	      }while(!feof(input));
-	      fclose(input);
-	    }
-	  }
+	}while(!feof(input));
+	fclose(input);
+	for(int iprcell=0;iprcell<nprcells;iprcell++)
+		prcell[iprcell].Prepare(lambdafact);
+	return true;
+}
+
+// prcell is sized to the surfaces read so far, it doubles when a surface
+// has more cells, but never beyond B3D_PR_NPRCELLSMAX
+void CHYDROtoB3D::GrowPRCells(){
+	int iprcell,nalloc=(nprcellsalloc>0) ? 2*nprcellsalloc : 4096;
+	CPRCell *newprcell;
+	if(nalloc>b3d->NPRCELLSMAX)
+		nalloc=b3d->NPRCELLSMAX;
+	newprcell=new CPRCell[nalloc];
+	for(iprcell=0;iprcell<nprcellsalloc;iprcell++)
+		newprcell[iprcell]=prcell[iprcell];
+	delete [] prcell;
+	prcell=newprcell;
+	nprcellsalloc=nalloc;
 }
 
 int CHYDROtoB3D::MakeEventPR(){
-	meanpt=0.0;
-	meanu=0.0;
-	normpt=0;
-	etot=vtot=0.0;
 	b3d->Reset();
-	int nparts=0,iprcell;
-	MC_NWrite=0;
-	MC_Nbar=0.0;
+	int nparts,iprcell,ichunk;
 	Ncheck=0.0;
-	nparts=0;
-	MC_Ntarget=-log(randy->ran());
-	for(iprcell=0;iprcell<nprcells;iprcell++){
-		nparts+=GenerateParticlesPR(iprcell);
+	// chunks of NPRCHUNK cells, B3D_PR_CHUNKSIZE
+	StartChunks((nprcells+NPRCHUNK-1)/NPRCHUNK);
+#pragma omp parallel for private(iprcell) schedule(dynamic,1)
+	for(ichunk=0;ichunk<nchunks;ichunk++){
+		chunk[ichunk].Start();
+		for(iprcell=ichunk*NPRCHUNK;iprcell<(ichunk+1)*NPRCHUNK && iprcell<nprcells;iprcell++)
+			GenerateParticlesPR(iprcell,&chunk[ichunk]);
 	}
+	nparts=AddChunks();
 	printf("hydrotob3dPR made %d parts\n",nparts);
 	return nparts;
 }
 
-int CHYDROtoB3D::GenerateParticlesPR(int iprcell){
-	CResInfo *resinfo;
+int CHYDROtoB3D::GenerateParticlesPR(int iprcell,CHydroChunk *chunk){
 	CPRCell *cell=&prcell[iprcell];
+	CRandom *randy=chunk->randy;
 	double dNbarmax,gspread=0.2;
-	int ncalls,ID,ipart;
-	int ires,iquad,alpha,beta;
+	int ID,ispecies,alpha,beta;
 	int nparts=0;
-	double V,V2,V0,Vx,Vy,Vmag,g1,g2;
-	double lambda[4][4],u[4]={1.0,0.0,0.0,0.0},pdotV,pdotu,udotV,wmax,gamma;
-	double ptilde[4],p[4],pt,y,et,weight,minv,mass,eta,tau,wx,wy,x[4];
-	//printf("deadpartmap.size=%d, partmap.size=%d, finalpartmap.size=%d,NPARTSMAX=%d\n",
-	//	int(b3d->DeadPartMap.size()),int(b3d->PartMap.size()),int(b3d->FinalPartMap.size()),int(b3d->NPARTSMAX));
+	double g1,g2,*u=cell->u,wmax=cell->wmax;
+	double ptilde[4],p[4],pt,y,et,weight,mass,eta,tau,x[4],pdotV,pdotu;
 	randy->gauss2(&g1,&g2);
 	x[1]=cell->x+gspread*g1;
 	x[2]=cell->y+gspread*g2;
 	x[0]=cell->tau;
 	tau=cell->tau;
-	u[1]=cell->ux;
-	u[2]=cell->uy;
-	u[0]=sqrt(1.0+u[1]*u[1]+u[2]*u[2]);
 	eta=ETAMAX-2.0*randy->ran()*ETAMAX;
+	chunk->vtot+=wmax;
+	for(ispecies=0;ispecies<nspecies;ispecies++){
+		ID=speciesID[ispecies];
+		mass=speciesmass[ispecies];
+		dNbarmax=speciesdNbar[ispecies]*wmax;
+		chunk->MC_Nbar+=dNbarmax;
+		while(chunk->MC_Nbar>chunk->MC_Ntarget){
+			chunk->MC_Ntarget-=log(randy->ran());
+			randy->generate_boltzmann(mass,T,ptilde);
+			for(alpha=1;alpha<4;alpha++){
+				p[alpha]=0.0;
+				for(beta=1;beta<4;beta++) p[alpha]+=ptilde[beta]*cell->lambda[alpha][beta];
+			}
+			p[0]=sqrt(mass*mass+p[1]*p[1]+p[2]*p[2]+p[3]*p[3]);
+
+			for(alpha=0;alpha<4;alpha++) ptilde[alpha]=p[alpha];
+			Misc::Boost(u,ptilde,p);
+			pt=sqrt(p[1]*p[1]+p[2]*p[2]);
 
+			pdotV=p[0]*cell->Omega_0+p[1]*cell->Omega_x+p[2]*cell->Omega_y;
+			if(pdotV>0.0){
+				pdotu=p[0]*u[0]-p[1]*u[1]-p[2]*u[2];
+				weight=(pdotV/pdotu)/wmax;
+				if(weight>1.00000001){
+					printf("Weight too large, weight=%g\n",weight);
+					printf("V0=%g, Vx=%g, Vy=%g\n",cell->Omega_0,-cell->Omega_x,-cell->Omega_y);
+					printf("p=(%g,%g,%g,%g), pdotV=%g\n",p[0],p[1],p[2],p[3],pdotV);
+				}
+				if(randy->ran()<weight){
+					chunk->MC_NWrite+=1;
+					chunk->etot+=p[0];
+					nparts+=1;
+
+					x[0]=tau*cosh(eta);
+					x[3]=tau*sinh(eta);
+					et=sqrt(mass*mass+p[1]*p[1]+p[2]*p[2]);
+					y=0.5*log((p[0]+p[3])/(p[0]-p[3]));
+					y+=eta;
+					p[0]=et*cosh(y);
+					p[3]=et*sinh(y);
+					if(fabs(p[0]*p[0]-p[1]*p[1]-p[2]*p[2]-p[3]*p[3]-mass*mass)>1.0E-2){
+						printf("invariant mass screwed up, =%g !=%g\n",sqrt(p[0]*p[0]-p[1]*p[1]-p[2]*p[2]-p[3]*p[3]),mass);
+						printf("p=(%g,%g,%g,%g)\n",p[0],p[1],p[2],p[3]);
+						exit(1);
+					}
+
+					if(ID==111 || ID==211 || ID==-211){
+						chunk->meanpt+=sqrt(p[1]*p[1]+p[2]*p[2]);
+						chunk->meanu+=(p[1]*u[1]+p[2]*u[2])/pt;
+						chunk->normpt+=1;
+					}
+					chunk->Add(ID,x[1],x[2],tau,eta,p[1],p[2],mass,y);
+				}
+			}
+		}
+	}
+	return nparts;
+}
+
+// Flow velocity, momentum scaling and maximum weight of the cell, which do not change from event to event
+void CPRCell::Prepare(double lambdafact){
+	int alpha,beta;
+	double V,V2,V0,Vx,Vy,Vmag,udotV,gamma;
+	u[1]=ux;
+	u[2]=uy;
+	u[3]=0.0;
+	u[0]=sqrt(1.0+u[1]*u[1]+u[2]*u[2]);
+	for(alpha=0;alpha<4;alpha++){
+		for(beta=0;beta<4;beta++)
+			lambda[alpha][beta]=0.0;
+	}
 	for(alpha=1;alpha<4;alpha++){
 		for(beta=1;beta<4;beta++)
-			lambda[alpha][beta]=(cell->dToverH[alpha][beta])/lambdafact;
+			lambda[alpha][beta]=dToverH[alpha][beta]/lambdafact;
 		lambda[alpha][alpha]+=1.0;
 	}
-	V0=cell->Omega_0;
-	Vx=-cell->Omega_x;
-	Vy=-cell->Omega_y;
+	V0=Omega_0;
+	Vx=-Omega_x;
+	Vy=-Omega_y;
 	V2=V0*V0-Vx*Vx-Vy*Vy;
 	udotV=u[0]*V0-u[1]*Vx-u[2]*Vy;
 	V=sqrt(fabs(V2));
@@ -158,95 +245,12 @@ int CHYDROtoB3D::GenerateParticlesPR(int iprcell){
 		gamma=(u[0]*Vmag-(V0/Vmag)*(Vx*u[1]+Vy*u[2]))/V;
 	}
 	wmax=V*(gamma+sqrt(gamma*gamma-1.0));
-	vtot+=wmax;
-	//printf("Vmag=%g, V=%g, wmax=%g, Omega=(%g,%g,%g), vtot=%g\n",Vmag,V, wmax,V0,Vx,Vy,vtot);
 	if(gamma<1.0){
 		printf("Disaster: gamma =%g, but should be >1\n",gamma);
 		printf("V0=%g, Vx=%g, Vy=%g\n",V0,Vx,Vy);
 		printf("V2=%g, V=%g, gamma=%g, udotV=%g wmax=%g\n",V2,V,gamma,udotV,wmax);
-		printf("fabs(MC_Nbar)=%g\n",fabs(MC_Nbar));
 		exit(1);
 	}
-	resinfo=reslist->GfirstResInfoptr;
-	for(ires=0;ires<nres;ires++){
-		ID=resinfo->code;
-		if(ID!=22){
-			dNbarmax=density[ires]*wmax*double(nsample);
-			//printf("dNbarmax=%g, density[%d]=%g\n",dNbarmax,ires,density[ires]);
-			MC_Nbar+=dNbarmax;
-			while(MC_Nbar>MC_Ntarget){
-				MC_Ntarget-=log(randy->ran());
-				mass=resinfo->mass;
-				randy->generate_boltzmann(mass,T,ptilde);
-				for(alpha=1;alpha<4;alpha++){
-					p[alpha]=0.0;
-					for(beta=1;beta<4;beta++) p[alpha]+=ptilde[beta]*lambda[alpha][beta];
-						p[0]=sqrt(mass*mass+p[1]*p[1]+p[2]*p[2]+p[3]*p[3]);
-				}
-
-				for(alpha=0;alpha<4;alpha++) ptilde[alpha]=p[alpha];
-					Misc::Boost(u,ptilde,p);
-				pt=sqrt(p[1]*p[1]+p[2]*p[2]);
-
-				pdotu=p[0]*u[0]-p[1]*u[1]-p[2]*u[2];
-				pdotV=p[0]*V0-p[1]*Vx-p[2]*Vy;
-				if(pdotV>0.0){
-					pdotu=p[0]*u[0]-p[1]*u[1]-p[2]*u[2];
-					weight=(pdotV/pdotu)/wmax;
-					if(weight>1.00000001){
-						printf("Weight too large, weight=%g\n",weight);
-						printf("V0=%g, Vx=%g, Vy=%g\n",V0,Vx,Vy);
-						printf("p=(%g,%g,%g,%g), V2=%g, pdotV=%g, V/udotV=%g\n",p[0],p[1],p[2],p[3],V2,pdotV,(V/udotV));
-					}
-					if(randy->ran()<weight){
-						MC_NWrite+=1;
-						etot+=p[0];
-						nparts+=1;
-
-
-						x[0]=tau*cosh(eta);
-						x[3]=tau*sinh(eta);
-						et=sqrt(mass*mass+p[1]*p[1]+p[2]*p[2]);
-						y=0.5*log((p[0]+p[3])/(p[0]-p[3]));
-						y+=eta;
-						p[0]=et*cosh(y);
-						p[3]=et*sinh(y);
-						if(fabs(p[0]*p[0]-p[1]*p[1]-p[2]*p[2]-p[3]*p[3]-mass*mass)>1.0E-2){
-							printf("invariant mass screwed up, =%g !=%g\n",sqrt(p[0]*p[0]-p[1]*p[1]-p[2]*p[2]-p[3]*p[3]),mass);
-							printf("p=(%g,%g,%g,%g)\n",p[0],p[1],p[2],p[3]);
-							exit(1);
-						}
-
-						if(ID==111 || ID==211 || ID==-211){
-							meanpt+=sqrt(p[1]*p[1]+p[2]*p[2]);
-							meanu+=(p[1]*u[1]+p[2]*u[2])/pt;
-							normpt+=1;
-						}
-
-						/*
-						iquad=lrint(floor(4*randy->ran()));
-						if(iquad==1 || iquad==2){
-							x[1]=-x[1];
-							p[1]=-p[1];
-						}
-						if(iquad==2 || iquad==3){
-							x[2]=-x[2];
-							p[2]=-p[2];
-						}
-						*/
-						ipart=int(b3d->PartMap.size());
-						if(b3d->DeadPartMap.size()==0){
-							printf("MUST INCREASE NPARTSMAX!!!! NPARTSMAX=%d\n",b3d->NPARTSMAX);
-							exit(1);
-						}
-						b3d->partarray[ipart]->Init(ID,x[1],x[2],tau,eta,p[1],p[2],mass,y);
-					}
-				}
-			}
-		}
-		resinfo=resinfo->nextResInfoptr;
-	}
-	return nparts;
 }
 
 void CPRCell::Read(FILE *fptr){
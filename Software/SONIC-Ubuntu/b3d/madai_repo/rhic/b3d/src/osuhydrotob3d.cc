@@ -284,7 +284,7 @@ int CFreezeoutCell::GenerateParticles(){
 	int alpha,beta,nparts=0;
 	double zsize,pdotV,pdotu,udotV;
 	double ptilde[4],p[4],pt,y,et,weight,minv,mass,eta,tau,x[4];	 
-	int ID,ipart;
+	int ID;
 	nparts=0;
 		// For MC procedure, weights cannot exceed unity. These factors are added into densities and weights
 		// to ensure MC weights do not exceed unity for any p. wmax is calculated so that the maximum weight
@@ -373,13 +373,8 @@ int CFreezeoutCell::GenerateParticles(){
 								x[2]=-x[2];
 								p[2]=-p[2];
 							}
-							ipart=int(b3d->PartMap.size());
 						}
-						if(b3d->DeadPartMap.size()==0){
-							printf("MUST INCREASE NPARTSMAX!!!!\n");
-							exit(1);
-						}
-						b3d->partarray[ipart]->Init(ID,x[1],x[2],tau,eta,p[1],p[2],mass,y);
+						b3d->partpool.Get()->Init(ID,x[1],x[2],tau,eta,p[1],p[2],mass,y);
 					}
 				}
 				//else{
@@ -402,7 +397,7 @@ int CFreezeoutCell::GenerateParticles3D(){
 	int alpha,beta,nparts=0;
 	double zsize,pdotV,pdotu,udotV;
 	double ptilde[4],p[4],pt,y,et,weight,minv,mass,eta,tau,x[4];	 
-	int ID,ipart;
+	int ID;
 	nparts=0;
 		// For MC procedure, weights cannot exceed unity. These factors are added into densities and weights
 		// to ensure MC weights do not exceed unity for any p. wmax is calculated so that the maximum weight
@@ -520,14 +515,9 @@ int CFreezeoutCell::GenerateParticles3D(){
 					 		}
 					 	}
 
-					 	ipart=int(b3d->PartMap.size());
-					 	if(b3d->DeadPartMap.size()==0){
-					 		printf("MUST INCREASE NPARTSMAX!!!!\n");
-					 		exit(1);
-					 	}
 							//printf("ID=%d, x=(%g,%g,%g,%g), pt=(%g,%g), y=%g\n",ID,tau,x[1],x[2],tau*eta,p[1],p[2],y);
 					 	// Since Josh's calcs were in mesh frame, we need to boost by eta
-					 	b3d->partarray[ipart]->Init(ID,x[1],x[2],tau,eta,p[1],p[2],mass,y+eta);
+					 	b3d->partpool.Get()->Init(ID,x[1],x[2],tau,eta,p[1],p[2],mass,y+eta);
 					}
 				}
 			}
@@ -3,15 +3,25 @@
 
 #include "b3d.h"
 using namespace std;
-CB3D *CPart::b3d=NULL;
+__thread CB3D *CPart::b3d=NULL;
 
 CPart::CPart(){
-	p=new double[4];
-	r=new double[4];
+	int alpha;
+	cell=nextcell=NULL;
+	cellpos=-1;
+	currentmap=NULL;
+	nextfree=NULL;
+	resinfo=NULL;
+	active=false;
+	listid=key=actionmother=0;
+	tau_lastint=tauexit=taudecay=0.0;
+	for(alpha=0;alpha<4;alpha++)
+		r[alpha]=p[alpha]=0.0;
+	r[0]=tau0=1.0;
+	p[0]=139.58;
+	y=eta=mass=0.0;
 }
 CPart::~CPart(){
-	delete [] p;
-	delete [] r;
 }
 
 void CPart::Copy(CPart *part){
@@ -142,7 +152,7 @@ void CPart::Print(){
 	printf("p=(%15.9e,%15.9e,%15.9e,%15.9e), y=%g\n",p[0],p[1],p[2],p[3],double(y));
 	string currentmapname="IN CELL";
 	if(currentmap==&(b3d->PartMap)) currentmapname="PartMap";
-	if(currentmap==&(b3d->DeadPartMap)) currentmapname="DeadPartMap";
+	if(currentmap==NULL) currentmapname="NONE (dead)";
 	if(currentmap==&(b3d->FinalPartMap)) currentmapname="FinalPartMap";
 	printf("currentmap=%s\n",currentmapname.c_str());
 	if(cell==NULL) printf("CELL=NULL\n");
@@ -151,43 +161,52 @@ void CPart::Print(){
 	printf("________________________________________________________________________\n");
 }
 
+// particles fresh from b3d->partpool are in no map
 void CPart::ChangeMap(CPartMap *newmap){
-	DeleteFromCurrentMap();
+	if(currentmap!=NULL)
+		DeleteFromCurrentMap();
 	AddToMap(newmap);
 }
 
-CPartMap::iterator CPart::DeleteFromCurrentMap(){
-	CPartMap::iterator neighbor;
-	CPartMap::iterator ppos=GetPos(currentmap);
-	neighbor=ppos;
+// the maps may be shared by the engines of the parallel cascade, hence the critical sections
+// while they run (as in CActionQueue::insert)
+bool CPart::MapsShared(){
+	return b3d->master->ActionMap.shared;
+}
+
+CPartMap::iterator CPart::EraseFromMap(CPartMap *partmap,const char *caller,const char *mapname){
+	CPartMap::iterator ppos=GetPos(partmap);
+	CPartMap::iterator neighbor=ppos;
 	neighbor++;
-	if(ppos==currentmap->end()){
-		printf("FATAL: In CPart::DeleteFromCurrentMap, can't find ppos!!!\n");
+	if(ppos==partmap->end()){
+		printf("FATAL: In CPart::%s, can't find ppos!!!\n",caller);
 		Print();
-		printf("currentmap has length %d\n",int(currentmap->size()));
+		printf("%s has length %d\n",mapname,int(partmap->size()));
 		exit(1);
 	}
-	else currentmap->erase(ppos);
+	else partmap->erase(ppos);
+	return neighbor;
+}
+
+CPartMap::iterator CPart::DeleteFromCurrentMap(){
+	CPartMap::iterator neighbor;
+	if(MapsShared()){
+#pragma omp critical(b3d_partmap)
+		neighbor=EraseFromMap(currentmap,"DeleteFromCurrentMap","currentmap");
+	}
+	else neighbor=EraseFromMap(currentmap,"DeleteFromCurrentMap","currentmap");
 	currentmap=NULL;
 	return neighbor;
 }
 
 CPartMap::iterator CPart::DeleteFromMap(CPartMap *partmap){
-  CPartMap::iterator neighbor;
-  CPartMap::iterator ppos=GetPos(partmap);
-  neighbor=ppos;
-  neighbor++;
-  if(ppos==partmap->end()){
-    printf("FATAL: In CPart::DeleteFromMap, can't find ppos!!!\n");
-    Print();
-    printf("partmap has length %d\n",int(partmap->size()));
-    exit(1);
-  }
-  else{
-    partmap->erase(ppos);
-  }
-  partmap=NULL;
-  return neighbor;
+	CPartMap::iterator neighbor;
+	if(MapsShared()){
+#pragma omp critical(b3d_partmap)
+		neighbor=EraseFromMap(partmap,"DeleteFromMap","partmap");
+	}
+	else neighbor=EraseFromMap(partmap,"DeleteFromMap","partmap");
+	return neighbor;
 }
 /* old, causes segfaults?
 CPartMap::iterator CPart::DeleteFromMap(CPartMap *partmap){
@@ -209,23 +228,40 @@ CPartMap::iterator CPart::DeleteFromMap(CPartMap *partmap){
 	}*/
 
 void CPart::AddToMap(CPartMap *newmap){
-	newmap->insert(CPartPair(key,this));
-	if(newmap==&b3d->PartMap || newmap==&b3d->DeadPartMap || newmap==&b3d->FinalPartMap)
+	if(MapsShared()){
+#pragma omp critical(b3d_partmap)
+		newmap->insert(CPartPair(key,this));
+	}
+	else newmap->insert(CPartPair(key,this));
+	if(newmap==&b3d->PartMap || newmap==&b3d->FinalPartMap)
 		currentmap=newmap;
 }
 
 void CPart::AddToMap(CPartMap::iterator guess,CPartMap *newmap){
-	newmap->insert(guess,CPartPair(key,this));
+	if(MapsShared()){
+#pragma omp critical(b3d_partmap)
+		newmap->insert(guess,CPartPair(key,this));
+	}
+	else newmap->insert(guess,CPartPair(key,this));
 	currentmap=newmap;
 }
 
 void CPart::SubtractAction(CAction *action){
-	CActionMap::iterator epos=action->GetPos(&actionmap);
-	if(epos!=actionmap.end()) actionmap.erase(epos);
+	int iaction;
+	for(iaction=0;iaction<int(actionmap.size());iaction++){
+		if(actionmap[iaction].action==action){
+			actionmap[iaction]=actionmap.back();
+			actionmap.pop_back();
+			return;
+		}
+	}
 }
 
 void CPart::AddAction(CAction *action){
-	actionmap.insert(CActionPair(action->key,action));
+	CActionRef ref;
+	ref.action=action;
+	ref.generation=action->generation;
+	actionmap.push_back(ref);
 }
 
 void CPart::Propagate(double tau){
@@ -276,8 +312,8 @@ CPartMap::iterator CPart::GetPos(CPartMap *pmap){
 void CPart::CheckMap(CPartMap *expectedpartmap){
 	if(currentmap!=expectedpartmap){
 		printf("FATAL: XXXXXXXXX particle not in expected map XXXXXXXXX\n");
-		if(currentmap==&(b3d->DeadPartMap)){
-			printf("particle in DeadPartMap\n");
+		if(currentmap==NULL){
+			printf("particle is dead\n");
 		}
 		if(currentmap==&(b3d->PartMap)){
 			printf("particlein PartMap\n");
@@ -332,14 +368,16 @@ double CPart::GetMT(){
 }
 
 void CPart::KillActions(){
-	CActionMap::iterator ep,epp;
+	int iaction;
+	unsigned int generation;
 	CAction *action;
-	ep=actionmap.begin();
-	while(ep!=actionmap.end()){
-		action=ep->second;
-		epp=ep; ++epp;
-		action->Kill();
-		ep=epp;
+	for(iaction=0;iaction<int(actionmap.size());iaction++){
+		action=actionmap[iaction].action;
+		// a stale reference may point to an action another engine is reusing
+#pragma omp atomic read
+		generation=action->generation;
+		if(actionmap[iaction].generation==generation)
+			action->Kill();
 	}
 	actionmap.clear();
 }
@@ -353,8 +391,8 @@ void CPart::Kill(){
 	DeleteFromCurrentMap();
 	eta=0.0;
 	tau0=tau_lastint=tauexit=-1.0;
-	AddToMap(b3d->DeadPartMap.begin(),&(b3d->DeadPartMap));
 	active=false;
+	b3d->partpool.Put(this);
 }
 
 void CPart::BjorkenTranslate(){
@@ -393,24 +431,13 @@ void CPart::BjorkenUnTranslate(){
 
 void CPart::FindCollisions(){
 	int ix,iy,ieta;
-	double taucoll;
-	CPart *part2,*part1=this;
-	CPartMap::iterator ppos;
 	CB3DCell *cell2;
 	for(ix=0;ix<3;ix++){
 		for(iy=0;iy<3;iy++){
 			for(ieta=0;ieta<3;ieta++){
 				cell2=cell->neighbor[ix][iy][ieta];
-				if(cell2!=NULL){
-					ppos=cell2->partmap.begin();
-					while(ppos!=cell2->partmap.end()){
-						part2=ppos->second;
-						if(part1!=part2 && part1->actionmother!=part2->actionmother){
-							b3d->FindCollision(part1,part2,taucoll);
-						}
-						++ppos;
-					}
-				}
+				if(cell2!=NULL && !cell2->partlist.empty())
+					b3d->FindCollisions(this,cell2);
 			}
 		}
 	}
@@ -438,10 +465,6 @@ CB3DCell *CPart::FindCell(){
 
 void CPart::FindDecay(){
 	CAction *action;
-	if(b3d->DeadActionMap.size()==0){
-		printf("MUST INCREASE NACTIONS_MAX\n");
-		exit(1);
-	}
 	double t,gamma,vz,newt,newz;
 	t=HBARC/resinfo->width;
 	gamma=p[0]/GetMass();
@@ -608,18 +631,8 @@ void CPart::Copy(CPartH5 *parth5){
 }
 
 void CPart::RemoveFromCell(){
-	if(cell!=NULL){
-		CPartMap::iterator ppos=GetPos(&(cell->partmap));
-		if(ppos==cell->partmap.end()){
-			printf("FATAL: In CPart::RemoveFromCell, can't find ppos!!!\n");
-			Print();
-			printf("partmap has length %d\n",int(cell->partmap.size()));
-			exit(1);
-		}
-		else{
-			cell->partmap.erase(ppos);
-		}
-	}
+	if(cell!=NULL)
+		cell->RemovePart(this);
 }
 
 void CPart::ChangeCell(CB3DCell *newcell){
@@ -627,7 +640,7 @@ void CPart::ChangeCell(CB3DCell *newcell){
 		if(cell!=NULL)
 			RemoveFromCell();
 		if(newcell!=NULL){
-			newcell->partmap.insert(CPartPair(key,this));
+			newcell->AddPart(this);
 		}
 		cell=newcell;
 	}
@@ -8,6 +8,7 @@
 #include <cstdio>
 #include <list>
 #include <map>
+#include <vector>
 #include <sys/stat.h>
 #include "H5Cpp.h"
 #ifndef H5_NO_NAMESPACE
@@ -23,6 +24,14 @@ typedef multimap<double,CAction *> CActionMap;
 typedef pair<int,CPart*> CPartPair;
 typedef pair<double,CAction*> CActionPair;
 
+//! A reference from a particle to one of its actions, valid as long as the action's CAction::generation has not moved on
+class CActionRef{
+public:
+	CAction *action;
+	unsigned int generation;
+};
+typedef vector<CActionRef> CActionRefList;
+
 //!A particle in the CB3D model.
 /*!
  \version 1.0
@@ -31,7 +40,7 @@ typedef pair<double,CAction*> CActionPair;
  
  This class generates the particles used in the CB3D model. Note that resonance information (stored in CResInfo objects) is different than the actual particles used; instead, a CPart object contains a pointer to a CResInfo object corresponding to the resonance it represents. In addition, the CPart object contains information about is coordinate and momentum 4 vectors, as well as its rapidity. Finally, it contains methods to add and remove actions (CAction objects) for the particle.
  
- In the CB3D model, the total number of particles is fixed (it is set by the CB3D::NPARTSMAX) parameter. As an attempt to improve performance, all of the particles are allocated in one memory block in the CB3D constructor, and stored in the "dead" particle map (CB3D::DeadPartMap). During model function, particles are intialized by setting their relevant parameters and moving them to the "live" particle map (CB3D::PartMap). Once the particle moves outside the outer boundary of the model space, it is transferred to the output particle map (CB3D::FinalPartMap).
+ In the CB3D model, the particles are allocated in slabs (the first one of CB3D::NPARTSMAX particles) and kept by CB3D::partpool. As an attempt to improve performance, particles are never deleted: "dead" particles wait in the pool's free list. During model function, particles are taken from the pool, intialized by setting their relevant parameters and moved to the "live" particle map (CB3D::PartMap). Once the particle moves outside the outer boundary of the model space, it is transferred to the output particle map (CB3D::FinalPartMap).
  */
 
 class CPart{
@@ -41,7 +50,7 @@ public:
 	CB3DCell *cell,*nextcell;
 	double tau0,tau_lastint,tauexit,taudecay;
 	double y,eta;
-	double *p,*r,mass;
+	double p[4],r[4],mass;
 	int listid;
 	int actionmother; //refers to action from which particle was created
 	CResInfo *resinfo;
@@ -75,13 +84,15 @@ public:
 	void BoostR(double *u);
 	//~CPart();
 
-	// These are the actions involving these particles
-	CActionMap actionmap;
+	// These are the actions involving these particles, along with stale references to actions killed since
+	CActionRefList actionmap;
 
-	CPartMap *currentmap; // PartList for a Cell, or b3d->DeadPartList
+	CPartMap *currentmap; // PartMap or FinalPartMap, NULL for a dead particle
+	CPart *nextfree; // next particle in the free list of b3d->partpool
 	CB3DCell *FindCell();
+	int cellpos; // position in cell->partlist, -1 if not in a cell
 
-	static CB3D *b3d;
+	static __thread CB3D *b3d;	// the engine of the calling thread for the parallel cascade
 	double GetEta(double tau);
 	double GetPseudoRapidity();
 	double GetMT();
@@ -99,6 +110,9 @@ public:
 	void AddToMap(CPartMap *newmap);
 	void AddToMap(CPartMap::iterator guess,CPartMap *newmap);
 	bool active;
+private:
+	static bool MapsShared();
+	CPartMap::iterator EraseFromMap(CPartMap *partmap,const char *caller,const char *mapname);
 };
 
 
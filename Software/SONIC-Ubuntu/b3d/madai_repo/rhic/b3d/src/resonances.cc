@@ -19,6 +19,7 @@ CResList::CResList(parameterMap* parmap_in){
 }
 
 CRandom *CResInfo::ranptr=new CRandom(-1234);
+__thread CRandom *CResInfo::domainranptr=NULL;
 
 CResInfo::CResInfo(){
 	count=0;
@@ -35,27 +36,19 @@ CMerge::CMerge(CResInfo *resinfo_in,double branching_in, int L_in){
 }
 
 void CResInfo::DecayGetResInfoptr(int &nbodies,CResInfo **&daughterresinfoptr){
-	double randy,bsum;
-	int ibody;
+	double randy;
+	int ibody,ibranch,nbranches=int(branchtable.size());
 	CBranchInfo *bptr;
-	bptr=NULL;
-	bsum=0.0;
-	randy=ranptr->ran();
+	randy=(domainranptr!=NULL) ? domainranptr->ran() : ranptr->ran();
 
-	do{
-		if(bptr==NULL){
-			bptr=firstbptr;
-		}
-		else{
-			bptr=bptr->nextbptr;
-		}
-		bsum+=bptr->branching;
-		if(bsum-1.0>1.0E-6){
-			cout << "FATAL: In DecayGetResInfo: bsum too large, = " << bsum << endl;
-			exit(1);
-		}
-
-	}while(bsum<randy);
+	randy*=nbranches;
+	ibranch=int(randy);
+	if(ibranch>=nbranches)
+		ibranch=nbranches-1;
+	if(randy-ibranch<branchprob[ibranch])
+		bptr=branchtable[ibranch];
+	else
+		bptr=branchalias[ibranch];
 
 	nbodies=bptr->nbodies;
 	for(ibody=0;ibody<nbodies;ibody++){
@@ -64,6 +57,54 @@ void CResInfo::DecayGetResInfoptr(int &nbodies,CResInfo **&daughterresinfoptr){
 
 }
 
+void CResInfo::MakeBranchTable(){
+	int ibranch,nbranches=0,ismall,ilarge;
+	double bsum=0.0;
+	CBranchInfo *bptr;
+	vector<double> q;
+	vector<int> small,large;
+	for(bptr=firstbptr;bptr!=NULL;bptr=bptr->nextbptr){
+		nbranches+=1;
+		bsum+=bptr->branching;
+	}
+	if(bsum-1.0>1.0E-6){
+		cout << "FATAL: In MakeBranchTable: bsum too large, = " << bsum << endl;
+		exit(1);
+	}
+	branchtable.resize(nbranches);
+	branchalias.resize(nbranches);
+	branchprob.resize(nbranches);
+	q.resize(nbranches);
+	ibranch=0;
+	for(bptr=firstbptr;bptr!=NULL;bptr=bptr->nextbptr){
+		branchtable[ibranch]=branchalias[ibranch]=bptr;
+		q[ibranch]=nbranches*bptr->branching/bsum;
+		if(q[ibranch]<1.0)
+			small.push_back(ibranch);
+		else
+			large.push_back(ibranch);
+		ibranch+=1;
+	}
+	// each short column is filled up from a long one
+	while(!small.empty() && !large.empty()){
+		ismall=small.back();
+		small.pop_back();
+		ilarge=large.back();
+		branchprob[ismall]=q[ismall];
+		branchalias[ismall]=branchtable[ilarge];
+		q[ilarge]-=1.0-q[ismall];
+		if(q[ilarge]<1.0){
+			large.pop_back();
+			small.push_back(ilarge);
+		}
+	}
+	// what is left is full up to rounding
+	for(ibranch=0;ibranch<int(large.size());ibranch++)
+		branchprob[large[ibranch]]=1.0;
+	for(ibranch=0;ibranch<int(small.size());ibranch++)
+		branchprob[small[ibranch]]=1.0;
+}
+
 bool CResInfo::CheckForDaughters(int codecheck){//checks to see if any decay daughters match code
 	int ibody,nbodies;
 	bool exists=false;
@@ -289,6 +330,24 @@ void CResList::ReadResInfo(){
 		exit(-1);
 	}
 	cout << "Done reading in decay and resonance info, read in " << foobar << " decays." << endl;
+
+	vector<CResInfo *> resinfoarray(NResonances);
+	for(resinfoptr=GfirstResInfoptr;resinfoptr!=NULL;resinfoptr=resinfoptr->nextResInfoptr){
+		resinfoarray[resinfoptr->ires]=resinfoptr;
+		if(resinfoptr->firstbptr!=NULL)
+			resinfoptr->MakeBranchTable();
+	}
+	double jfactor;
+	MergeSigmaBound=new double *[NResonances];
+	for(ires1=0;ires1<NResonances;ires1++){
+		MergeSigmaBound[ires1]=new double[NResonances];
+		for(ires2=0;ires2<NResonances;ires2++){
+			MergeSigmaBound[ires1][ires2]=0.0;
+			jfactor=(2.0*resinfoarray[ires1]->spin+1.0)*(2.0*resinfoarray[ires2]->spin+1.0);
+			for(merge=MergeArray[ires1][ires2];merge!=NULL;merge=merge->next)
+				MergeSigmaBound[ires1][ires2]+=4.0*PI*HBARC*HBARC*merge->branching*(2.0*merge->resinfo->spin+1.0)/jfactor;
+		}
+	}
 }
 
 void CResList::GetResInfoptr(int code,CResInfo *&resinfoptr){
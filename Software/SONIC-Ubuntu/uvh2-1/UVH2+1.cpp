@@ -64,10 +64,13 @@ Permission to copy this code is granted provided you keep this disclaimer.
 #include <stdio.h>
 #include <omp.h>
 #include <math.h>
+#include <vector>
 #include <gsl/gsl_errno.h>
 #include <gsl/gsl_spline.h>
 #include <gsl/gsl_roots.h>
 #include <myspline.h>
+#include "paramfile.h"
+#include "freezeout.h"
 
 //custom defined output
 //Betz-Gyulassy
@@ -77,23 +80,51 @@ Permission to copy this code is granted provided you keep this disclaimer.
 
 using namespace std;
 
+//gauss-jordan elimination procedure
+//provides 
+//int gaussj(double **a, int n,double **b, int m)
+#include "GJE.cpp"
+
 const double fmtoGeV=5.0677;
 
+//initial conditions handed over in memory (see sonic.cpp) instead of
+//input/*.dat: tau [fm] and e, u^x, u^y of the NUMT x NUMT lattice,
+//row sx at [(sx-1)*NUMT+sy-1]; the shear and bulk stresses start at 0
+//as in the files written by initE
+struct hydroinit
+{
+  int numt;
+  double tinit;
+  std::vector<double> e,ux,uy;
+};
+
+//one hydro event: grid, parameters, equation of state and transport
+//coefficient tables all live in the object, so that several events
+//can be evolved at the same time in one process (see main)
+class vh2solver
+{
+ public:
+
+//directory holding input/, data/ and parameters/ of this event
+char RUNDIR[255];
+
 //smoothing to be able to run lumpy initial conditions
 int SMOOTHING=0;
 double SMOOTH=0.01;
 
 double SCAL=1.0;
 
-// these global vars are initialized from parameters file
+// these are initialized from parameters file
 // defaults set here are overridden by that file
 
 int NUMT=8;
 long int STEPS=4000,UPDATE=100,SNAPUPDATE=1000;
 double AT=0.05,EPS=0.001,B=0.0;
+//ADAPTIVE>1 lets the time step grow from EPS up to ADAPTIVE*EPS (see nextStep)
+double ADAPTIVE=0;
 double ETAOS=0.3;
 double TSTART=0.5,TF=0.1,TINIT=1.0;
-double IC;
+double IC=0;
 int PTASIZE,PHIPASIZE;
 
 //controls value of tau_Pi
@@ -105,6 +136,17 @@ double L2COEF=1.0;
 
 //create freeze-out surface
 int FREEZE=1;
+//write the surface in the binary format of freezeout.h
+int BINARYFO=0;
+//0: no snapshots and, when run by sonic, no initial condition and
+//freeze-out files either
+int KEEPFILES=1;
+
+//set by the in-process chain (sonic.cpp), NULL for a standalone run:
+//initial conditions to start from and buffer collecting the records
+//of the freeze-out surface (FREEZE 0 and 2)
+const hydroinit *initial=NULL;
+std::vector<double> *fosink=NULL;
 
 char EOSNAME[255];
 char ETANAME[255];
@@ -149,10 +191,10 @@ double anuc=0.54;
 
 
 //for the equation of state
-double *eoT4,*cs2i,*poT4,*Ti;
+double *eoT4=NULL,*cs2i=NULL,*poT4=NULL,*Ti=NULL;
 
 // these hold the current values
-double ***u,**e,**pixy,**pixx,**piyy,**pib;
+double ***u=NULL,**e,**pixy,**pixx,**piyy,**pib;
 
 // these hold the updated values
 double ***U,**E,**Pixy,**Pixx,**Piyy,**Pib;
@@ -171,6 +213,27 @@ double ****dtmat;
 
 double ****vec;/*bei Pauli rhs*/
 
+//1 if the closed-form solve of dtmat succeeded for a cell, [sx*(NUMT+2)+sy]
+char *solved;
+
+//cells with e below ECOLD times the freeze-out energy density EFO, and 
+//no warmer cell within COLDMARGIN cells, are not evolved (see findBand);
+//off by default, since the frozen cells still enter the eccentricities in ecc.dat
+double ECOLD=0,EFO=0;
+int COLDMARGIN=3;
+//number of steps and cell updates, for the info at the end of the run
+long int bandsteps=0;
+double cellupdates=0;
+
+//active band: row sx is evolved from bandlo[sx] to bandhi[sx];
+//it is cut into ntiles tiles of at most TILE cells of one row
+static const int TILE=16;
+int *bandlo,*bandhi;
+//first and last warm cell of each row, scratch for findBand
+int *hotlo,*hothi;
+int ntiles;
+int *tilex,*tilelo,*tilehi;
+
 //center of lattice 
 int Middle;
 
@@ -186,6 +249,21 @@ double ***thf;
 double ***dtpixx,***dtpixy,***dtpiyy,***dtpi;
 double **mypixt,**mypiyt,**mypitt,**mypiee;
 
+//thermodynamic state of a cell -- depends only on e[sx][sy], 
+//filled once per step by fillThermo() and used in doInc
+struct thermostate
+{
+  double p;        //pressure
+  double cs2;      //speed of sound squared
+  double T;        //temperature*lattice spacing
+  double zetaoeta; //zeta/eta
+  double etataupi; //eta/tau_pi
+  double taupi;    //tau_pi/lattice spacing
+  double l1coeff;  //lambda_1 coefficient
+};
+
+thermostate **thermo;
+
 // output files
 fstream freeze_out;
 fstream meta;
@@ -200,207 +278,162 @@ fstream bgout;
 
 
 //splines -- for fancy freeze-out
-gsl_interp_accel *wac;
-gsl_spline *workspline;
+gsl_interp_accel *wac=NULL;
+gsl_spline *workspline=NULL;
 //splines -- for equation of state
-gsl_spline *pspline,*Tspline,*cs2spline;
+gsl_spline *pspline=NULL,*Tspline=NULL,*cs2spline=NULL;
 //splines -- for eta/s
-gsl_spline *etaspline,*betaspline,*lambdaspline,*zetaspline;
+gsl_spline *etaspline=NULL,*betaspline=NULL,*lambdaspline=NULL,*zetaspline=NULL;
 
 myspline mpspline,mTspline;
 
 //to know where to stop interpolation
 double lowestE,loweta,higheta,lowbeta,highbeta,lowlambda,highlambda,lowzeta,highzeta;
 
-double eos(double mye,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc);
-double T(int sx,int sy,gsl_interp_accel *Tacc);
-double T(int sx,int sy);
-double Tlast(int sx,int sy,gsl_interp_accel *Tacc);
-
-
-// initialize global arrays
-void allocateMemory() {
-
-cout << "==> Allocating memory\n";
-
-
- u = new double**[2];
-
- for (int i=0;i<2;i++) 
-   u[i] = new double*[NUMT+2];
-
- for (int i=0;i<2;i++)
-   for (int j=0;j<NUMT+2;j++) 
-     u[i][j] = new double[NUMT+2];
-
-	 
- e = new double*[NUMT+2];
-
- for (int i=0;i<NUMT+2;i++) 
-    e[i] = new double[NUMT+2];
- 
- pixy = new double*[NUMT+2];
-
- for (int i=0;i<NUMT+2;i++) 
-   pixy[i] = new double[NUMT+2];
-
-
- pixx = new double*[NUMT+2];
-
- for (int i=0;i<NUMT+2;i++) 
-   pixx[i] = new double[NUMT+2];
-
- piyy = new double*[NUMT+2];
-
- for (int i=0;i<NUMT+2;i++) 
-   piyy[i] = new double[NUMT+2];
-
- pib = new double*[NUMT+2];
-
- for (int i=0;i<NUMT+2;i++) 
-   pib[i] = new double[NUMT+2];
-
-//////////////////////
- ulast = new double**[2];
-
- for (int i=0;i<2;i++) 
-   ulast[i] = new double*[NUMT+2];
-
- for (int i=0;i<2;i++)
-   for (int j=0;j<NUMT+2;j++) 
-     ulast[i][j] = new double[NUMT+2];
-
-	 
- elast = new double*[NUMT+2];
-
- for (int i=0;i<NUMT+2;i++) 
-    elast[i] = new double[NUMT+2];
- 
- pixylast = new double*[NUMT+2];
-
- for (int i=0;i<NUMT+2;i++) 
-   pixylast[i] = new double[NUMT+2];
-
-
- pixxlast = new double*[NUMT+2];
-
- for (int i=0;i<NUMT+2;i++) 
-   pixxlast[i] = new double[NUMT+2];
-
- piyylast = new double*[NUMT+2];
-
- for (int i=0;i<NUMT+2;i++) 
-   piyylast[i] = new double[NUMT+2];
-
- pilast = new double*[NUMT+2];
-
- for (int i=0;i<NUMT+2;i++) 
-   pilast[i] = new double[NUMT+2];
-//////////////////////
-
- U = new double**[2];
-
- for (int i=0;i<2;i++) 
-   U[i] = new double*[NUMT+2];
-
- for (int i=0;i<2;i++)
-   for (int j=0;j<NUMT+2;j++) 
-     U[i][j] = new double[NUMT+2];
-
-	 
- E = new double*[NUMT+2];
-
- for (int i=0;i<NUMT+2;i++) 
-   E[i] = new double[NUMT+2];
-
-
- Pixy = new double*[NUMT+2];
+vh2solver()
+{
+  RUNDIR[0]='\0';
+}
 
- for (int i=0;i<NUMT+2;i++) 
-   Pixy[i] = new double[NUMT+2];
+~vh2solver()
+{
+  freeMemory();
+}
 
+//grid of n1 x n2 x n3 doubles in one contiguous block,
+//with the usual pointer-to-pointer access [i][j][k]
+double ***newGrid(int n1,int n2,int n3)
+{
+  double ***p=new double**[n1];
+  p[0]=new double*[n1*n2];
+  p[0][0]=new double[n1*n2*n3]();
+  for (int i=0;i<n1;i++)
+    {
+      p[i]=p[0]+i*n2;
+      for (int j=0;j<n2;j++)
+	p[i][j]=p[0][0]+(i*n2+j)*n3;
+    }
+  return p;
+}
 
- Pixx = new double*[NUMT+2];
+double **newGrid(int n1,int n2)
+{
+  double **p=new double*[n1];
+  p[0]=new double[n1*n2]();
+  for (int i=1;i<n1;i++)
+    p[i]=p[0]+i*n2;
+  return p;
+}
 
- for (int i=0;i<NUMT+2;i++) 
-   Pixx[i] = new double[NUMT+2];
+void deleteGrid(double ***p)
+{
+  delete [] p[0][0];
+  delete [] p[0];
+  delete [] p;
+}
 
+void deleteGrid(double **p)
+{
+  delete [] p[0];
+  delete [] p;
+}
 
- Piyy = new double*[NUMT+2];
+// initialize grid arrays
+void allocateMemory() {
 
- for (int i=0;i<NUMT+2;i++) 
-   Piyy[i] = new double[NUMT+2];
+cout << "==> Allocating memory\n";
 
- Pib = new double*[NUMT+2];
+ int N=NUMT+2;
+
+ u = newGrid(2,N,N);
+ e = newGrid(N,N);
+ pixy = newGrid(N,N);
+ pixx = newGrid(N,N);
+ piyy = newGrid(N,N);
+ pib = newGrid(N,N);
+
+ ulast = newGrid(2,N,N);
+ elast = newGrid(N,N);
+ pixylast = newGrid(N,N);
+ pixxlast = newGrid(N,N);
+ piyylast = newGrid(N,N);
+ pilast = newGrid(N,N);
+
+ U = newGrid(2,N,N);
+ E = newGrid(N,N);
+ Pixy = newGrid(N,N);
+ Pixx = newGrid(N,N);
+ Piyy = newGrid(N,N);
+ Pib = newGrid(N,N);
+
+ upast = newGrid(2,N,N);
+
+ //3x3 matrix and right hand side (3x1, one spare column) of every cell
+ dtmat = new double***[N];
+ vec = new double***[N];
+ dtmat[0] = newGrid(N*N,3,3);
+ vec[0] = newGrid(N*N,3,3);
+ for (int i=1;i<N;i++)
+   {
+     dtmat[i] = dtmat[0]+i*N;
+     vec[i] = vec[0]+i*N;
+   }
 
- for (int i=0;i<NUMT+2;i++) 
-   Pib[i] = new double[NUMT+2];
+ globut = newGrid(N,N);
+ thf = newGrid(N,N,4);
+ dtpixx = newGrid(N,N,4);
+ dtpixy = newGrid(N,N,4);
+ dtpiyy = newGrid(N,N,4);
+ dtpi = newGrid(N,N,4);
+ mypixt = newGrid(N,N);
+ mypiyt = newGrid(N,N);
+ mypitt = newGrid(N,N);
+ mypiee = newGrid(N,N);
+
+ thermo = new thermostate*[N];
+ thermo[0] = new thermostate[N*N];
+ for (int i=1;i<N;i++)
+   thermo[i] = thermo[0]+i*N;
+
+ solved = new char[N*N];
+
+ bandlo = new int[N];
+ bandhi = new int[N];
+ hotlo = new int[N];
+ hothi = new int[N];
+ int maxtiles=N*(N/TILE+1);
+ tilex = new int[maxtiles];
+ tilelo = new int[maxtiles];
+ tilehi = new int[maxtiles];
+}
+
+void freeMemory()
+{
+  if (u==NULL)
+    return;
 
- upast = new double**[2];
+  deleteGrid(u); deleteGrid(e); deleteGrid(pixy); deleteGrid(pixx); deleteGrid(piyy); deleteGrid(pib);
+  deleteGrid(ulast); deleteGrid(elast); deleteGrid(pixylast); deleteGrid(pixxlast); deleteGrid(piyylast); deleteGrid(pilast);
+  deleteGrid(U); deleteGrid(E); deleteGrid(Pixy); deleteGrid(Pixx); deleteGrid(Piyy); deleteGrid(Pib);
+  deleteGrid(upast);
 
- for (int i=0;i<2;i++) 
-   upast[i] = new double*[NUMT+2];
+  deleteGrid(dtmat[0]); delete [] dtmat;
+  deleteGrid(vec[0]); delete [] vec;
 
- for (int i=0;i<2;i++)
-   for (int j=0;j<NUMT+2;j++) 
-     upast[i][j] = new double[NUMT+2];
+  deleteGrid(globut);
+  deleteGrid(thf); deleteGrid(dtpixx); deleteGrid(dtpixy); deleteGrid(dtpiyy); deleteGrid(dtpi);
+  deleteGrid(mypixt); deleteGrid(mypiyt); deleteGrid(mypitt); deleteGrid(mypiee);
 
- dtmat= new double***[NUMT+2];
- vec=new double***[NUMT+2];
+  delete [] thermo[0];
+  delete [] thermo;
 
- for (int i=0;i<NUMT+2;i++)
-   { 
-     dtmat[i]=new double**[NUMT+2];
-     vec[i]=new double**[NUMT+2];
-     for (int j=0;j<NUMT+2;j++) 
-       {
-	 dtmat[i][j]=new double*[3];
-	 vec[i][j]=new double*[3];
-	 
-	 for (int k=0;k<3;k++) 
-	   {
-	     dtmat[i][j][k] = new double[3];
-	     vec[i][j][k] = new double[3];
-	   }
-	 //dtmat = new double*[3];
-	 //for (int i=0;i<3;i++) dtmat[i] = new double[3];
-	 // vec = new double*[3];
-	 //for (int i=0;i<3;i++) vec[i] = new double[1];
-       }}
-  
- globut = new double*[NUMT+2];
- thf = new double**[NUMT+2];
- dtpixx = new double**[NUMT+2];
- dtpixy = new double**[NUMT+2];
- dtpiyy = new double**[NUMT+2];
- dtpi   = new double**[NUMT+2];
- mypixt = new double*[NUMT+2];
- mypiyt = new double*[NUMT+2];
- mypitt = new double*[NUMT+2];
- mypiee = new double*[NUMT+2];
+  delete [] solved;
 
- for (int i=0;i<NUMT+2;i++)
-   { 
-     globut[i] = new double[NUMT+2];
-     mypixt[i] = new double[NUMT+2];
-     mypiyt[i] = new double[NUMT+2];
-     mypitt[i] = new double[NUMT+2];
-     mypiee[i] = new double[NUMT+2];
-     thf[i] = new double*[NUMT+2];
-     dtpixx[i] = new double*[NUMT+2];
-     dtpixy[i] = new double*[NUMT+2];
-     dtpi[i]   = new double*[NUMT+2];
-     dtpiyy[i] = new double*[NUMT+2];
-     for (int j=0;j<NUMT+2;j++) 
-       {
-	 thf[i][j] = new double[4];
-	 dtpixx[i][j] = new double[4];
-	 dtpixy[i][j] = new double[4];
-	 dtpi[i][j] = new double[4];
-	 dtpiyy[i][j] = new double[4];
-       }
-   }
+  delete [] bandlo; delete [] bandhi;
+  delete [] hotlo; delete [] hothi;
+  delete [] tilex; delete [] tilelo; delete [] tilehi;
 
+  u=NULL;
 }
 
 //enforce periodic BoundaryConditions
@@ -690,11 +723,11 @@ void loadeta()
 {
   fstream eosf;
 
-  char eosfile[255];
+  char eosfile[512];
   
   //extern char ETANAME[255];
 
-  sprintf(eosfile,"input/%s.dat",ETANAME);
+  snprintf(eosfile,sizeof(eosfile),"%sinput/%s.dat",RUNDIR,ETANAME);
   double *dummyx;
   double *dummyy;
 
@@ -750,11 +783,11 @@ void loadzeta()
 {
   fstream eosf;
 
-  char eosfile[255];
+  char eosfile[512];
   
   //extern char ETANAME[255];
 
-  sprintf(eosfile,"input/%s.dat",ZETANAME);
+  snprintf(eosfile,sizeof(eosfile),"%sinput/%s.dat",RUNDIR,ZETANAME);
   double *dummyx;
   double *dummyy;
  
@@ -812,9 +845,9 @@ void loadbeta2()
 {
   fstream eosf;
 
-  char eosfile[255];
+  char eosfile[512];
   
-  sprintf(eosfile,"input/%s.dat",BETANAME);
+  snprintf(eosfile,sizeof(eosfile),"%sinput/%s.dat",RUNDIR,BETANAME);
   double *dummyx;
   double *dummyy;
 
@@ -861,9 +894,9 @@ void loadlambda1()
 {
   fstream eosf;
 
-  char eosfile[255];
+  char eosfile[512];
   
-  sprintf(eosfile,"input/%s.dat",LAMBDANAME);
+  snprintf(eosfile,sizeof(eosfile),"%sinput/%s.dat",RUNDIR,LAMBDANAME);
   double *dummyx;
   double *dummyy;
 
@@ -910,10 +943,10 @@ void loadeos()
 {
   fstream eosf;
 
-  char eosfile[255];
+  char eosfile[512];
   
 
-  sprintf(eosfile,"input/%s.dat",EOSNAME);
+  snprintf(eosfile,sizeof(eosfile),"%sinput/%s.dat",RUNDIR,EOSNAME);
   eosf.open(eosfile,ios::in);
 
   if (eosf.is_open())
@@ -983,6 +1016,15 @@ void loadeos()
     }  
   gsl_spline_init (cs2spline,warrx,warry,length);
 
+  //freeze-out energy density in lattice units (TF is in lattice units already)
+  EFO=0;
+  for (int i=0;i<length-1;i++)
+    if ((Ti[i]<=TF/AT)&&(Ti[i+1]>TF/AT))
+      {
+	double x=(TF/AT-Ti[i])/(Ti[i+1]-Ti[i]);
+	EFO=((1-x)*warrx[i]+x*warrx[i+1])*pow(AT,4);
+      }
+
 }
 
 //return interpolated temperature in lattice units
@@ -1080,7 +1122,7 @@ void RungeKutta4(double *y, double x0, double h, int N,
     return;
 }
 
-void dydx(double x, const double *y, double *f)
+static void dydx(double x, const double *y, double *f)
 {
 
 double eta_s, taupi, b;
@@ -1178,17 +1220,38 @@ void setInitialConditions()
   loadbeta2();
   loadlambda1();
 
-  if(int(IC) != -9 ) //all runs except Gubser
+  if ((int(IC) != -9)&&(initial!=NULL))
+    {
+      if (initial->numt!=NUMT)
+	{
+	  printf("Error: initial conditions for NUMT %i, not %i\n",initial->numt,NUMT);
+	  exit(1);
+	}
+      for (int sx=1;sx<=NUMT;sx++)
+	for (int sy=1;sy<=NUMT;sy++)
+	  {
+	    int pos=(sx-1)*NUMT+sy-1;
+	    e[sx][sy]=initial->e[pos]*SCAL;
+	    u[0][sx][sy]=initial->ux[pos];
+	    u[1][sx][sy]=initial->uy[pos];
+	    pixx[sx][sy]=0;
+	    pixy[sx][sy]=0;
+	    piyy[sx][sy]=0;
+	    pib[sx][sy]=0;
+	  }
+      TINIT=initial->tinit;
+    }
+  else if(int(IC) != -9 ) //all runs except Gubser
     {
       fstream inited,initux,inituy,initpixx,initpixy,initpiyy,itime,initpi;
-      itime.open("input/time.dat",ios::in);
-      inited.open("input/inited.dat", ios::in);
-      initux.open("input/initux.dat", ios::in);
-      inituy.open("input/inituy.dat", ios::in);  
-      initpixx.open("input/initpixx.dat", ios::in);
-      initpixy.open("input/initpixy.dat", ios::in);
-      initpiyy.open("input/initpiyy.dat", ios::in);
-      initpi.open("input/initpi.dat", ios::in);
+      itime.open(path("input/time.dat").c_str(),ios::in);
+      inited.open(path("input/inited.dat").c_str(),ios::in);
+      initux.open(path("input/initux.dat").c_str(),ios::in);
+      inituy.open(path("input/inituy.dat").c_str(),ios::in);  
+      initpixx.open(path("input/initpixx.dat").c_str(),ios::in);
+      initpixy.open(path("input/initpixy.dat").c_str(),ios::in);
+      initpiyy.open(path("input/initpiyy.dat").c_str(),ios::in);
+      initpi.open(path("input/initpi.dat").c_str(),ios::in);
   
  
       for (int sx=1;sx<=NUMT;sx++)
@@ -1206,14 +1269,6 @@ void setInitialConditions()
  
       itime >> TINIT;
 
-      //convert fm/c to lattice units
-      t=TINIT*fmtoGeV/AT;
-
-  
-
-      wac=gsl_interp_accel_alloc (); 
-      workspline=gsl_spline_alloc (gsl_interp_cspline, Middle);
-  
       inited.close();
       initux.close();
       inituy.close();
@@ -1222,6 +1277,14 @@ void setInitialConditions()
       initpiyy.close();
       initpi.close();
     }
+  if(int(IC) != -9 )
+    {
+      //convert fm/c to lattice units
+      t=TINIT*fmtoGeV/AT;
+
+      wac=gsl_interp_accel_alloc (); 
+      workspline=gsl_spline_alloc (gsl_interp_cspline, Middle);
+    }
   enforcePBCs();
   //  enforceNBCs();
 
@@ -1319,6 +1382,20 @@ void setInitialConditions()
 	for (int a=0;a<10;a++)
 	smearu(u,e);
     }
+
+  //cells outside the active band (see findBand) are never updated,
+  //so the updated fields start out equal to the initial ones
+  for (int sx=1;sx<=NUMT;sx++)
+    for (int sy=1;sy<=NUMT;sy++)
+      {
+	for (int i=0;i<2;i++) 
+	  U[i][sx][sy]=u[i][sx][sy];
+	E[sx][sy]=e[sx][sy];
+	Pixy[sx][sy]=pixy[sx][sy];
+	Pixx[sx][sy]=pixx[sx][sy];
+	Piyy[sx][sy]=piyy[sx][sy];
+	Pib[sx][sy]=pib[sx][sy];
+      }
 }
 
 //gets index associated with energy density -- internal use only
@@ -1773,7 +1850,7 @@ double T(int sx,int sy,gsl_interp_accel *Tacc)
 //provides Temperature*lattice spacing
 double T(int sx,int sy)
 {
-  gsl_interp_accel *macc;
+  gsl_interp_accel *macc=NULL;
   double res=0;
   res=T(sx,sy,macc);
   gsl_interp_accel_free (macc);
@@ -1807,7 +1884,7 @@ double etaos(double TT)
 
   if ((TT>loweta)&&(TT<higheta))
     {
-      gsl_interp_accel *macc;
+      gsl_interp_accel *macc=NULL;
       result=gsl_spline_eval(etaspline,TT,macc);
       gsl_interp_accel_free (macc);
     }
@@ -1824,7 +1901,7 @@ double zetaoeta(double TT)
 
   if ((TT>lowzeta)&&(TT<highzeta))
     {
-      gsl_interp_accel *macc;
+      gsl_interp_accel *macc=NULL;
       result=gsl_spline_eval(zetaspline,TT,macc)/etaos(TT);
       gsl_interp_accel_free (macc);
     }
@@ -1840,7 +1917,7 @@ double coeff(double TT)
 
   if ((TT>lowbeta)&&(TT<highbeta))
     {
-      gsl_interp_accel *macc;
+      gsl_interp_accel *macc=NULL;
       result=gsl_spline_eval(betaspline,TT,macc);
       gsl_interp_accel_free (macc);
     }
@@ -1856,7 +1933,7 @@ double l1coeff(double TT)
 
   if ((TT>lowlambda)&&(TT<highlambda))
     {
-      gsl_interp_accel *macc;
+      gsl_interp_accel *macc=NULL;
       result=gsl_spline_eval(lambdaspline,TT,macc);
       gsl_interp_accel_free (macc);
     }
@@ -1885,6 +1962,49 @@ double etataupi(int sx,int sy,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc)
   return temp;
 }
 
+//evaluate the equation of state and transport coefficients once for every cell
+//of the active band
+//so that doInc does not have to go through the splines again
+void fillThermo()
+{
+  int sx,sy;
+  gsl_interp_accel *pacc,*Tacc,*cs2acc;
+
+#pragma omp parallel private(sx,sy,pacc,Tacc,cs2acc)
+  {
+    pacc=gsl_interp_accel_alloc (); 
+    Tacc=gsl_interp_accel_alloc (); 
+    cs2acc=gsl_interp_accel_alloc (); 
+
+#pragma omp for schedule(static)
+    for(int tile=0;tile<ntiles;tile++)
+      for(sx=tilex[tile],sy=tilelo[tile];sy<=tilehi[tile];sy++)
+      {
+
+	thermostate &th=thermo[sx][sy];
+	double TT=T(sx,sy,Tacc);
+	double cc=coeff(TT);
+
+	th.p=eos(e[sx][sy],pacc,cs2acc);
+	th.cs2=cs2(sx,sy,pacc,cs2acc);
+	th.T=TT;
+	th.zetaoeta=zetaoeta(TT);
+	th.etataupi=0.5/cc*(e[sx][sy]+th.p);
+	th.taupi=cc*2.0*etaos(TT)/TT;
+	th.l1coeff=l1coeff(TT);
+
+	if (isnan(th.taupi)!=0)
+	  {
+	    cout << "Error in taupi\n";
+	  }
+      }
+
+    gsl_interp_accel_free (pacc);
+    gsl_interp_accel_free (Tacc);
+    gsl_interp_accel_free (cs2acc);
+  }
+}
+
 
 
 
@@ -1946,9 +2066,9 @@ void Dumu(double *a,int mu,int sx,int sy)
 
 
 //this provides \nabla^\mu p
-void Nablap(double *a,int mu,int sx,int sy,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc)
+void Nablap(double *a,int mu,int sx,int sy)
 {
-  double cc2=cs2(sx,sy,pacc,cs2acc);
+  double cc2=thermo[sx][sy].cs2;
 
   //unconventional notation: 0=x, 1=y, 2=tau
   if (mu==0)
@@ -2194,7 +2314,7 @@ double diuj(int i,int j, int sx,int sy)
 
 
 //Omega_{i j}
-double prevor(double *a,int i,int j,int sx,int sy)
+void prevor(double *a,int i,int j,int sx,int sy)
 {
   double bi[4],bj[4];
   Dumu(bi,i,sx,sy);
@@ -2227,7 +2347,7 @@ void vorticityxy(double *a,int sx,int sy)
 
 
 //gives \Omega_{mu,nu}
-double vorticity(double *a,int mu, int nu,int sx,int sy)
+void vorticity(double *a,int mu, int nu,int sx,int sy)
 {
   if ((mu==2)||(nu==2))
     {
@@ -2369,7 +2489,7 @@ void terma(double *a,int i,int alpha, int sx,int sy)
 
 
 //\eta/taupi/u^tau <\nabla^i u^\alpha>
-void termb(double *a,int i,int alpha,int sx,int sy,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc)
+void termb(double *a,int i,int alpha,int sx,int sy)
 {
   a[0]=0;
   a[1]=0;
@@ -2407,25 +2527,25 @@ void termb(double *a,int i,int alpha,int sx,int sy,gsl_interp_accel *pacc,gsl_in
       
       if(ip==0 && alphap==0)
 	{
-	  a[zaehler]+=etataupi(sx,sy,pacc,cs2acc)*grxux[zaehler]/globut[sx][sy];
+	  a[zaehler]+=thermo[sx][sy].etataupi*grxux[zaehler]/globut[sx][sy];
 	  //if (zaehler==0&&(sx==Middle+8)&&sy==Middle)
 	  //  cout << "here tb" << a[zaehler]/e[sx][sy] << endl;
 	}
       if(ip==0 && alphap==1)
 	{
-	  a[zaehler]+=etataupi(sx,sy,pacc,cs2acc)*grxuy[zaehler]/globut[sx][sy];
+	  a[zaehler]+=thermo[sx][sy].etataupi*grxuy[zaehler]/globut[sx][sy];
 	}
       if(ip==1 && alphap==1)
 	{
-	  a[zaehler]+=etataupi(sx,sy,pacc,cs2acc)*gryuy[zaehler]/globut[sx][sy];
+	  a[zaehler]+=thermo[sx][sy].etataupi*gryuy[zaehler]/globut[sx][sy];
 	}
       if(ip==0 && alphap==2)
 	{
-	  a[zaehler]-=etataupi(sx,sy,pacc,cs2acc)*grxut[zaehler]/globut[sx][sy];
+	  a[zaehler]-=thermo[sx][sy].etataupi*grxut[zaehler]/globut[sx][sy];
 	}
       if(ip==1 && alphap==2)
 	{
-	  a[zaehler]-=etataupi(sx,sy,pacc,cs2acc)*gryut[zaehler]/globut[sx][sy];
+	  a[zaehler]-=thermo[sx][sy].etataupi*gryut[zaehler]/globut[sx][sy];
 	}
       //printf("gr %f\n", grxux[3]);    
     }
@@ -2437,10 +2557,10 @@ void termb(double *a,int i,int alpha,int sx,int sy,gsl_interp_accel *pacc,gsl_in
 
 //term c
 //1/(tau_Pi u^tau) Pi^{i alpha}
-double termc(int i,int alpha,int sx,int sy,gsl_interp_accel *Tacc)
+double termc(int i,int alpha,int sx,int sy)
 {
   double temp=0;
-  temp+=pishell(i,alpha,sx,sy)/(taupi(sx,sy,Tacc)*globut[sx][sy]);
+  temp+=pishell(i,alpha,sx,sy)/(thermo[sx][sy].taupi*globut[sx][sy]);
   //printf("tau %f pi %f\n",taupi(sx,sy),pi(i,alpha,sx,sy));
 return temp;
 }
@@ -2488,7 +2608,7 @@ double termf(int i,int alpha,int sx,int sy)
 }
 
 //shear-shear self coupling
-double termg(int i,int alpha, int sx,int sy,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_interp_accel *Tacc)
+double termg(int i,int alpha, int sx,int sy)
 {
   double temp=0;
 
@@ -2502,20 +2622,20 @@ double termg(int i,int alpha, int sx,int sy,gsl_interp_accel *pacc,gsl_interp_ac
   for(int j=0;j<=3;j++)
     temp+=pishell(i,j,sx,sy)*pishell(alpha,j,sx,sy)*gdown(j,j);
     
-  temp*=l1coeff(T(sx,sy,Tacc));
-  temp/=globut[sx][sy]*taupi(sx,sy,Tacc)*(e[sx][sy]+eos(e[sx][sy],pacc,cs2acc));
+  temp*=thermo[sx][sy].l1coeff;
+  temp/=globut[sx][sy]*thermo[sx][sy].taupi*(e[sx][sy]+thermo[sx][sy].p);
   //temp/=4*M_PI*ETAOS*taupi(sx,sy)*(e[sx][sy]+eos(e[sx][sy])); //wrong
 				   
   return temp;
 }
 
 //d_t pi^{i,alpha} summary
-void dtpiialpha(double *a,int i,int alpha,int sx,int sy,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_interp_accel *Tacc)
+void dtpiialpha(double *a,int i,int alpha,int sx,int sy)
 {
   double terd[4];
   termd(terd,i,alpha,sx,sy);
   double terb[4];
-  termb(terb,i,alpha,sx,sy,pacc,cs2acc);
+  termb(terb,i,alpha,sx,sy);
   
   double tera[4];
   terma(tera,i,alpha,sx,sy);
@@ -2529,14 +2649,14 @@ void dtpiialpha(double *a,int i,int alpha,int sx,int sy,gsl_interp_accel *pacc,g
   a[0]=terb[0]-terd[0]+tera[0];
   a[1]=terb[1]-terd[1]+tera[1];
   a[2]=terb[2]-terd[2]+tera[2];
-  a[3]=terb[3]-termf(i,alpha,sx,sy)-terd[3]-termc(i,alpha,sx,sy,Tacc)+tera[3];
-  a[3]-=termg(i,alpha,sx,sy,pacc,cs2acc,Tacc);
+  a[3]=terb[3]-termf(i,alpha,sx,sy)-terd[3]-termc(i,alpha,sx,sy)+tera[3];
+  a[3]-=termg(i,alpha,sx,sy);
 
    if (isnan(a[3])!=0)
     {
       cout << "Problem in dtpiialpha" << endl;
       cout << "More specific: " << terb[3] << "\t" << terd[3] << "\t";
-      cout << termf(i,alpha,sx,sy) << "\t" << termc(i,alpha,sx,sy,Tacc) << endl;
+      cout << termf(i,alpha,sx,sy) << "\t" << termc(i,alpha,sx,sy) << endl;
       printf("sx=%i sy=%i a=%p i=%i alpha=%i globut=%f\n",sx,sy,a,i,alpha,globut[sx][sy]);
     }
 
@@ -2544,7 +2664,7 @@ void dtpiialpha(double *a,int i,int alpha,int sx,int sy,gsl_interp_accel *pacc,g
 }
 
 //\partial_\tau \Pi^{i \alpha}
-void dtpishell(double *a,int i,int alpha,int sx,int sy,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_interp_accel *Tacc)
+void dtpishell(double *a,int i,int alpha,int sx,int sy)
 {
   int phi;
   if (alpha<i)
@@ -2568,7 +2688,7 @@ void dtpishell(double *a,int i,int alpha,int sx,int sy,gsl_interp_accel *pacc,gs
       a[3]=dtpixy[sx][sy][3];
     }
   if ((i==0)&&(alpha==2))
-    dtpiialpha(a,i,alpha,sx,sy,pacc,cs2acc,Tacc);
+    dtpiialpha(a,i,alpha,sx,sy);
   if ((i==1)&&(alpha==1))
     {
       a[0]=dtpiyy[sx][sy][0];
@@ -2577,7 +2697,7 @@ void dtpishell(double *a,int i,int alpha,int sx,int sy,gsl_interp_accel *pacc,gs
       a[3]=dtpiyy[sx][sy][3];
     }
   if ((i==1)&&(alpha==2))
-    dtpiialpha(a,i,alpha,sx,sy,pacc,cs2acc,Tacc);
+    dtpiialpha(a,i,alpha,sx,sy);
 
 }
 
@@ -2591,7 +2711,7 @@ double help(int alpha,int sx,int sy)
 }
 
 //u^j/u^tau \partial_\tau \Pi^{j \alpha}
-void help2(double *a,int alpha,int sx,int sy,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_interp_accel *Tacc)
+void help2(double *a,int alpha,int sx,int sy)
 {
   double dtpiialp[4];
   
@@ -2603,7 +2723,7 @@ void help2(double *a,int alpha,int sx,int sy,gsl_interp_accel *pacc,gsl_interp_a
   
   for(int j=0;j<2;j++)
     {
-      dtpishell(dtpiialp,j,alpha,sx,sy,pacc,cs2acc,Tacc);     
+      dtpishell(dtpiialp,j,alpha,sx,sy);     
       for(int zaehler=0;zaehler<4;zaehler++)
 	a[zaehler]+=umu(j,sx,sy)/globut[sx][sy]*dtpiialp[zaehler];
 	  //printf("dt %f\n",dtpiialp[3]);
@@ -2614,10 +2734,10 @@ void help2(double *a,int alpha,int sx,int sy,gsl_interp_accel *pacc,gsl_interp_a
 }
 
 //\partial_tau \Pi^{\alpha tau} 
-void dtpialphat(double *a,int alpha,int sx,int sy,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_interp_accel *Tacc)
+void dtpialphat(double *a,int alpha,int sx,int sy)
 {
   double hel2[4];
-  help2(hel2,alpha,sx,sy,pacc,cs2acc,Tacc);
+  help2(hel2,alpha,sx,sy);
 
   //qcout << "a[1]" << a[1] << endl;
 
@@ -2633,7 +2753,7 @@ void dtpialphat(double *a,int alpha,int sx,int sy,gsl_interp_accel *pacc,gsl_int
 
 //g_{alpha kappa} \Delta^{\mu \kappa} \partial_\beta \Pi^{\alpha \beta}
 
-void gDeltapi(double *a,int mu,int sx,int sy,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_interp_accel *Tacc)
+void gDeltapi(double *a,int mu,int sx,int sy)
 {
   double temp0=0;
   double temp1=0;
@@ -2641,7 +2761,7 @@ void gDeltapi(double *a,int mu,int sx,int sy,gsl_interp_accel *pacc,gsl_interp_a
   double dtpialpt[4];
   for(int alpha=0;alpha<=3;alpha++)
     {     
-      dtpialphat(dtpialpt,alpha,sx,sy,pacc,cs2acc,Tacc);
+      dtpialphat(dtpialpt,alpha,sx,sy);
       for(int kappa=0;kappa<=3;kappa++) 
 	{
 	  temp0+=gdown(alpha,kappa)*Delta(mu,kappa,sx,sy)*dtpialpt[0];
@@ -2757,14 +2877,179 @@ void pigradu(double *a,int sx,int sy)
 }
 
 
-//gauss-jordan elimination procedure
-//provides 
-//void gaussj(double **a, int n,double **b, int m)
-#include "GJE.cpp"
-#include "diags.cpp"
-#include "bulkvisc.cpp"
+//diagnostics, snapshots and freeze-out, defined in diags.cpp
+double anisospace();
+void allanisomomentum(double& ex,double& ep, double& totpx, double& totpy, double& e1c, double& e1s, double& e2c, double& e2s, double& e3c, double& e3s, double& eps1c, double&eps1s, double& eps2c, double& eps2s, double& eps3c, double& eps3s, double& eps4c, double& eps4s, double& eps5c, double& eps5s, double& eps6c, double& eps6s, double& eps7c, double& eps7s,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc);
+double uphi(int sx,int sy);
+double ur(int sx,int sy);
+int foundit(int sx, int sy,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc);
+void fancyfoundx(double sx, int sy,streambuf* pbuf,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc);
+void fancyfoundy(int sx, double sy,streambuf* pbuf,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc);
+void stupidfreeze(gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_interp_accel *Tacc);
+void blockfound(const double *rec);
+void blockfreeze(gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_interp_accel *Tacc);
+void outputMeasurements(double t,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_interp_accel *Tacc);
+void snapTprofile(double time,gsl_interp_accel *Tacc);
+void snapEDprofile(double time);
+void snapTcontour(double time,gsl_interp_accel *Tacc);
+void snapVcontour(double time);
+void snapFOdata(double time,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc);
+void snapVprofile(double time);
+void snapVxprofile(double time);
+void snapV2profile(double time);
+void snappieeprofile(double time);
+void snappirrprofile(double time);
+void snappibulkprofile(double time);
+void snapuphiprofile(double time);
+#ifdef BG
+void betzgyulassy(double tt,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_interp_accel *Tacc);
+#endif
+#ifdef AMNR
+void amnr(double tt,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_interp_accel *Tacc);
+#endif
+void snapshot(double tt,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_interp_accel *Tacc);
+
+//bulk viscosity diagnostics, defined in bulkvisc.cpp
+double pvap(int sx, int sy, gsl_interp_accel *Tacc);
+double upastt(int sx,int sy);
+double upastmu(int mu, int sx, int sy);
+double Ut(int sx,int sy);
+double Umu(int mu, int sx, int sy);
+double dtu(int mu, int sx, int sy);
+double dxU(int i, int sx, int sy);
+double dyU(int mu,int sx,int sy);
+double dxupast(int i, int sx, int sy);
+double dyupast(int mu,int sx,int sy);
+double dx2u(int mu, int sx, int sy);
+double dy2u(int mu, int sx, int sy);
+double dt2u(int mu, int sx, int sy);
+double dydxu(int i, int sx, int sy);
+double dxdyu(int i, int sx, int sy);
+double DmuUmu(int sx, int sy, double time);
+double dmuUnu(int mu, int nu, int sx, int sy);
+double H60term(int sx, int sy, double time);
+double H61term(int sx, int sy);
+double H62term(int sx, int sy);
+double H63term(int sx, int sy);
+double H6term(int sx, int sy, double time);
+double H7term(int sx, int sy);
+double H8term(int sx, int sy, double time,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc);
+double Xi(int sx, int sy, double time,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc);
+double bulkzeta1st(int sx, int sy, double time, gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_interp_accel *Tacc);
+double bulkzeta2nd(int sx, int sy, double time, gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_interp_accel *Tacc);
+void bulkvisc(double tt,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_interp_accel *Tacc);
+double peff(int sx, int sy, double tt, gsl_interp_accel *pacc, gsl_interp_accel *cs2acc,gsl_interp_accel *Tacc, bool sndorder);
+void peffout(double tt, gsl_interp_accel *pacc, gsl_interp_accel *cs2acc,gsl_interp_accel *Tacc);
+void snapshotBulkvisc(double tt,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_interp_accel *Tacc);
+
+
+//solves dtmat x = vec for the cells lo..hi of the row sx in closed form
+//(Cramer's rule), overwriting vec with x. The loop body has no branches
+//and no pivot bookkeeping. Cells with a nearly singular matrix or a nan 
+//keep their right hand side and get solved[]=0; doInc hands those to gaussj
+void cramer3(int sx,int lo,int hi)
+{
+  const double tol=1e-10; //relative to the Hadamard bound of det
+  const double *A=dtmat[sx][0][0];
+  double *b=vec[sx][0][0];
+  char *ok=solved+sx*(NUMT+2);
+
+  for (int sy=lo;sy<=hi;sy++)
+    {
+      const double *a=A+9*sy;
+      double *r=b+9*sy;
+
+      //cofactors
+      double c00=a[4]*a[8]-a[5]*a[7];
+      double c01=a[5]*a[6]-a[3]*a[8];
+      double c02=a[3]*a[7]-a[4]*a[6];
+      double c10=a[2]*a[7]-a[1]*a[8];
+      double c11=a[0]*a[8]-a[2]*a[6];
+      double c12=a[1]*a[6]-a[0]*a[7];
+      double c20=a[1]*a[5]-a[2]*a[4];
+      double c21=a[2]*a[3]-a[0]*a[5];
+      double c22=a[0]*a[4]-a[1]*a[3];
+
+      double det=a[0]*c00+a[1]*c01+a[2]*c02;
+      //squared Hadamard bound, product of the squared row norms
+      double h2=(a[0]*a[0]+a[1]*a[1]+a[2]*a[2])
+	*(a[3]*a[3]+a[4]*a[4]+a[5]*a[5])
+	*(a[6]*a[6]+a[7]*a[7]+a[8]*a[8]);
+
+      double idet=1.0/det;
+      double x0=(c00*r[0]+c10*r[3]+c20*r[6])*idet;
+      double x1=(c01*r[0]+c11*r[3]+c21*r[6])*idet;
+      double x2=(c02*r[0]+c12*r[3]+c22*r[6])*idet;
+
+      //both comparisons are false for nan
+      double sum=x0+x1+x2;
+      bool good=(det*det>tol*tol*h2)&(sum==sum);
+
+      r[0]=good?x0:r[0];
+      r[3]=good?x1:r[3];
+      r[6]=good?x2:r[6];
+      ok[sy]=good;
+    }
+}
+
+
+
+//find the cells to be evolved: rows are scanned for cells warmer than
+//ECOLD*EFO, the band between the first and last such cell of a row is
+//widened by COLDMARGIN cells in both directions and cut into tiles.
+//Cells outside the band keep their values (U,E,... are not touched, so 
+//they stay equal to u,e,...)
+void findBand()
+{
+  //ECOLD=0 evolves everything
+  double ecold=ECOLD*EFO;
 
+  for (int sx=1;sx<=NUMT;sx++)
+    {
+      hotlo[sx]=NUMT+1;
+      hothi[sx]=0;
+      for (int sy=1;sy<=NUMT;sy++)
+	if ((ecold<=0)||!(e[sx][sy]<ecold))
+	  {
+	    if (hotlo[sx]>NUMT)
+	      hotlo[sx]=sy;
+	    hothi[sx]=sy;
+	  }
+    }
+
+  bandsteps++;
+  ntiles=0;
+  for (int sx=1;sx<=NUMT;sx++)
+    {
+      int lo=NUMT+1,hi=0;
+      for (int i=sx-COLDMARGIN;i<=sx+COLDMARGIN;i++)
+	if ((i>=1)&&(i<=NUMT))
+	  {
+	    if (hotlo[i]<lo) lo=hotlo[i];
+	    if (hothi[i]>hi) hi=hothi[i];
+	  }
+      if (lo<=hi)
+	{
+	  lo-=COLDMARGIN;
+	  hi+=COLDMARGIN;
+	  if (lo<1) lo=1;
+	  if (hi>NUMT) hi=NUMT;
+	}
+      bandlo[sx]=lo;
+      bandhi[sx]=hi;
+
+      if (hi>=lo)
+	cellupdates+=hi-lo+1;
 
+      for (int sy=lo;sy<=hi;sy+=TILE)
+	{
+	  tilex[ntiles]=sx;
+	  tilelo[ntiles]=sy;
+	  tilehi[ntiles]=(sy+TILE-1<hi)?sy+TILE-1:hi;
+	  ntiles++;
+	}
+    }
+}
 
 //main update routine
 inline void doInc(double eps) 
@@ -2778,13 +3063,16 @@ inline void doInc(double eps)
   int debug=0;
 
   int sx,sy;
-  long int position;
   int nthreads, tid;
-  int chunk=1;
   gsl_interp_accel *pacc,*Tacc,*cs2acc;
 
+  //cells that are evolved in this step
+  findBand();
+
+  //p, cs2, T and transport coefficients of these cells
+  fillThermo();
 
-#pragma omp parallel shared(nthreads,chunk,u,e,pixy,pib,pixx,piyy,U,E,Pixy,Pixx,Piyy,Pib,t,globut,thf,dtpixx,mypixt,mypiyt,mypitt,mypiee,position,Middle,lowestE) private(sx,sy,tid,pacc,Tacc,cs2acc)
+#pragma omp parallel shared(nthreads) private(sx,sy,tid,pacc,Tacc,cs2acc)
   {
 
     double Dumx[4],Dumy[4],Nabpx[4],Nabpy[4],gDeltpix[4],gDeltpiy[4],Des[4],nablau[4],pigru[4];
@@ -2801,12 +3089,10 @@ inline void doInc(double eps)
       }
     //printf("===> Info: Thread %d starting...\n",tid);
 
-    #pragma omp for schedule(dynamic,chunk)
-    for(position=0;position<NUMT*NUMT;position++)
+    #pragma omp for schedule(static)
+    for(int tile=0;tile<ntiles;tile++)
+      for(sx=tilex[tile],sy=tilelo[tile];sy<=tilehi[tile];sy++)
       {
-	sx=position%NUMT+1;
-	sy=position/NUMT+1;
-
 	//printf("position =%i sx=%i sy=%i thread=%i\n",position,sx,sy,tid);
 	//for (sx=1;sx<=NUMT;sx++)
 	//for (sy=1;sy<=NUMT;sy++)
@@ -2829,18 +3115,18 @@ inline void doInc(double eps)
 	mypitt[sx][sy]=pi(2,2,sx,sy);
 	mypiee[sx][sy]=pi(3,3,sx,sy);
 	
-	dtpiialpha(dtpixx[sx][sy],0,0,sx,sy,pacc,cs2acc,Tacc);
-	dtpiialpha(dtpixy[sx][sy],0,1,sx,sy,pacc,cs2acc,Tacc);
-	dtpiialpha(dtpiyy[sx][sy],1,1,sx,sy,pacc,cs2acc,Tacc);
+	dtpiialpha(dtpixx[sx][sy],0,0,sx,sy);
+	dtpiialpha(dtpixy[sx][sy],0,1,sx,sy);
+	dtpiialpha(dtpiyy[sx][sy],1,1,sx,sy);
 
 	
 
 	Dumu(Dumx,0,sx,sy); 
 	Dumu(Dumy,1,sx,sy);
-	Nablap(Nabpx,0,sx,sy,pacc,cs2acc);
-	Nablap(Nabpy,1,sx,sy,pacc,cs2acc);
-	gDeltapi(gDeltpix,0,sx,sy,pacc,cs2acc,Tacc);
-	gDeltapi(gDeltpiy,1,sx,sy,pacc,cs2acc,Tacc);
+	Nablap(Nabpx,0,sx,sy);
+	Nablap(Nabpy,1,sx,sy);
+	gDeltapi(gDeltpix,0,sx,sy);
+	gDeltapi(gDeltpiy,1,sx,sy);
 	De(Des,sx,sy);	
 	nablamuumu(nablau,sx,sy);
 	pigradu(pigru,sx,sy);
@@ -2852,42 +3138,59 @@ inline void doInc(double eps)
 	
 
 	
-	dtmat[sx][sy][0][0]=(e[sx][sy]+eos(e[sx][sy],pacc,cs2acc)-pib[sx][sy])*Dumx[0]-Nabpx[0]
+	dtmat[sx][sy][0][0]=(e[sx][sy]+thermo[sx][sy].p-pib[sx][sy])*Dumx[0]-Nabpx[0]
 	  //+gDeltagamma(0,sx,sy)
-	  +gDeltpix[0]-u[0][sx][sy]*nablau[0]*zetaoeta(T(sx,sy,Tacc))*etataupi(sx,sy,pacc,cs2acc);
-	dtmat[sx][sy][0][1]=(e[sx][sy]+eos(e[sx][sy],pacc,cs2acc)-pib[sx][sy])*Dumx[1]-Nabpx[1]
+	  +gDeltpix[0]-u[0][sx][sy]*nablau[0]*thermo[sx][sy].zetaoeta*thermo[sx][sy].etataupi;
+	dtmat[sx][sy][0][1]=(e[sx][sy]+thermo[sx][sy].p-pib[sx][sy])*Dumx[1]-Nabpx[1]
 	  //+gDeltagamma(0,sx,sy)
-	  +gDeltpix[1]-u[0][sx][sy]*nablau[1]*zetaoeta(T(sx,sy,Tacc))*etataupi(sx,sy,pacc,cs2acc);
-	dtmat[sx][sy][0][2]=(e[sx][sy]+eos(e[sx][sy],pacc,cs2acc)-pib[sx][sy])*Dumx[2]-Nabpx[2]//+gDeltagamma(0,sx,sy)
+	  +gDeltpix[1]-u[0][sx][sy]*nablau[1]*thermo[sx][sy].zetaoeta*thermo[sx][sy].etataupi;
+	dtmat[sx][sy][0][2]=(e[sx][sy]+thermo[sx][sy].p-pib[sx][sy])*Dumx[2]-Nabpx[2]//+gDeltagamma(0,sx,sy)
 	  +gDeltpix[2];
-	dtmat[sx][sy][1][0]=(e[sx][sy]+eos(e[sx][sy],pacc,cs2acc)-pib[sx][sy])*Dumy[0]-Nabpy[0]//+gDeltagamma(1,sx,sy)
-	  +gDeltpiy[0]-u[1][sx][sy]*nablau[0]*zetaoeta(T(sx,sy,Tacc))*etataupi(sx,sy,pacc,cs2acc);
-	dtmat[sx][sy][1][1]=(e[sx][sy]+eos(e[sx][sy],pacc,cs2acc)-pib[sx][sy])*Dumy[1]-Nabpy[1]//+gDeltagamma(1,sx,sy)
-	  +gDeltpiy[1]-u[1][sx][sy]*nablau[1]*zetaoeta(T(sx,sy,Tacc))*etataupi(sx,sy,pacc,cs2acc);
-	dtmat[sx][sy][1][2]=(e[sx][sy]+eos(e[sx][sy],pacc,cs2acc)-pib[sx][sy])*Dumy[2]-Nabpy[2]//+gDeltagamma(1,sx,sy)
+	dtmat[sx][sy][1][0]=(e[sx][sy]+thermo[sx][sy].p-pib[sx][sy])*Dumy[0]-Nabpy[0]//+gDeltagamma(1,sx,sy)
+	  +gDeltpiy[0]-u[1][sx][sy]*nablau[0]*thermo[sx][sy].zetaoeta*thermo[sx][sy].etataupi;
+	dtmat[sx][sy][1][1]=(e[sx][sy]+thermo[sx][sy].p-pib[sx][sy])*Dumy[1]-Nabpy[1]//+gDeltagamma(1,sx,sy)
+	  +gDeltpiy[1]-u[1][sx][sy]*nablau[1]*thermo[sx][sy].zetaoeta*thermo[sx][sy].etataupi;
+	dtmat[sx][sy][1][2]=(e[sx][sy]+thermo[sx][sy].p-pib[sx][sy])*Dumy[2]-Nabpy[2]//+gDeltagamma(1,sx,sy)
 	  +gDeltpiy[2];
-	dtmat[sx][sy][2][0]=Des[0]+(e[sx][sy]+eos(e[sx][sy],pacc,cs2acc)-pib[sx][sy])*nablau[0]-pigru[0];
-	dtmat[sx][sy][2][1]=Des[1]+(e[sx][sy]+eos(e[sx][sy],pacc,cs2acc)-pib[sx][sy])*nablau[1]-pigru[1];
-	dtmat[sx][sy][2][2]=Des[2]+(e[sx][sy]+eos(e[sx][sy],pacc,cs2acc)-pib[sx][sy])*nablau[2]-pigru[2];
+	dtmat[sx][sy][2][0]=Des[0]+(e[sx][sy]+thermo[sx][sy].p-pib[sx][sy])*nablau[0]-pigru[0];
+	dtmat[sx][sy][2][1]=Des[1]+(e[sx][sy]+thermo[sx][sy].p-pib[sx][sy])*nablau[1]-pigru[1];
+	dtmat[sx][sy][2][2]=Des[2]+(e[sx][sy]+thermo[sx][sy].p-pib[sx][sy])*nablau[2]-pigru[2];
 	
 
 	//Vector (written like a 3*0 Matrix)
-	vec[sx][sy][0][0]=Nabpx[3]-(e[sx][sy]+eos(e[sx][sy],pacc,cs2acc)-pib[sx][sy])*Dumx[3]-gDeltagamma(0,sx,sy)-gDeltpix[3]+u[0][sx][sy]*nablau[3]*zetaoeta(T(sx,sy,Tacc))*etataupi(sx,sy,pacc,cs2acc)-u[0][sx][sy]*pib[sx][sy]/taupi(sx,sy,Tacc)+dxpi(sx,sy);
+	vec[sx][sy][0][0]=Nabpx[3]-(e[sx][sy]+thermo[sx][sy].p-pib[sx][sy])*Dumx[3]-gDeltagamma(0,sx,sy)-gDeltpix[3]+u[0][sx][sy]*nablau[3]*thermo[sx][sy].zetaoeta*thermo[sx][sy].etataupi-u[0][sx][sy]*pib[sx][sy]/thermo[sx][sy].taupi+dxpi(sx,sy);
 
 	if (isnan(vec[sx][sy][0][0])!=0)
 	  {
 	    cout << "Problem in v00" << endl;
 	    cout << "More specific 1 : " << Nabpx[3] << "\t";
-	    cout << "2 : " << (e[sx][sy]+eos(e[sx][sy],pacc,cs2acc))*Dumx[3] << "\t";
+	    cout << "2 : " << (e[sx][sy]+thermo[sx][sy].p)*Dumx[3] << "\t";
 	    cout << "3 : " << gDeltagamma(0,sx,sy) << "\t";
 	    cout << "4 : " << gDeltpix[3] << endl;
 	  }
-	vec[sx][sy][1][0]=Nabpy[3]-(e[sx][sy]+eos(e[sx][sy],pacc,cs2acc)-pib[sx][sy])*Dumy[3]-gDeltagamma(1,sx,sy)-gDeltpiy[3]+u[1][sx][sy]*nablau[3]*zetaoeta(T(sx,sy,Tacc))*etataupi(sx,sy,pacc,cs2acc)-u[1][sx][sy]*pib[sx][sy]/taupi(sx,sy,Tacc)+dypi(sx,sy);
-	vec[sx][sy][2][0]=(Des[3]+(e[sx][sy]+eos(e[sx][sy],pacc,cs2acc)-pib[sx][sy])*nablau[3])*(-1.0)+pigru[3];
-	
-	int check;
-	check=gaussj(dtmat[sx][sy],3,vec[sx][sy],1);
-		//printf("cs %f\n",cs2(sx,sy));  
+	vec[sx][sy][1][0]=Nabpy[3]-(e[sx][sy]+thermo[sx][sy].p-pib[sx][sy])*Dumy[3]-gDeltagamma(1,sx,sy)-gDeltpiy[3]+u[1][sx][sy]*nablau[3]*thermo[sx][sy].zetaoeta*thermo[sx][sy].etataupi-u[1][sx][sy]*pib[sx][sy]/thermo[sx][sy].taupi+dypi(sx,sy);
+	vec[sx][sy][2][0]=(Des[3]+(e[sx][sy]+thermo[sx][sy].p-pib[sx][sy])*nablau[3])*(-1.0)+pigru[3];
+
+	dtpi[sx][sy][0]=nablau[0]*thermo[sx][sy].zetaoeta*thermo[sx][sy].etataupi;
+	dtpi[sx][sy][1]=nablau[1]*thermo[sx][sy].zetaoeta*thermo[sx][sy].etataupi;
+	dtpi[sx][sy][3]=nablau[3]*thermo[sx][sy].zetaoeta*thermo[sx][sy].etataupi;
+	dtpi[sx][sy][3]-=u[0][sx][sy]*dxpi(sx,sy)+u[1][sx][sy]*dypi(sx,sy);
+	dtpi[sx][sy][3]-=pib[sx][sy]/thermo[sx][sy].taupi;
+      }
+
+    //solve the 3x3 systems
+    #pragma omp for schedule(static)
+    for(int tile=0;tile<ntiles;tile++)
+      cramer3(tilex[tile],tilelo[tile],tilehi[tile]);
+
+    #pragma omp for schedule(static)
+    for(int tile=0;tile<ntiles;tile++)
+      for(sx=tilex[tile],sy=tilelo[tile];sy<=tilehi[tile];sy++)
+      {
+	int check=0;
+	//ill-conditioned cells: Gauss-Jordan with full pivoting
+	if (solved[sx*(NUMT+2)+sy]==0)
+	  check=gaussj(dtmat[sx][sy],3,vec[sx][sy],1);
 	
 	if (check==0)
 	  {
@@ -2912,14 +3215,6 @@ inline void doInc(double eps)
 	    Pixy[sx][sy]=pixy[sx][sy]+eps*(dtpixy[sx][sy][0]*vec[sx][sy][0][0]+dtpixy[sx][sy][1]*vec[sx][sy][1][0]+dtpixy[sx][sy][2]*vec[sx][sy][2][0]+dtpixy[sx][sy][3]);
 	    
 	    Piyy[sx][sy]=piyy[sx][sy]+eps*(dtpiyy[sx][sy][0]*vec[sx][sy][0][0]+dtpiyy[sx][sy][1]*vec[sx][sy][1][0]+dtpiyy[sx][sy][2]*vec[sx][sy][2][0]+dtpiyy[sx][sy][3]);
-	    
-	    dtpi[sx][sy][0]=nablau[0]*zetaoeta(T(sx,sy,Tacc))*etataupi(sx,sy,pacc,cs2acc);
-	    dtpi[sx][sy][1]=nablau[1]*zetaoeta(T(sx,sy,Tacc))*etataupi(sx,sy,pacc,cs2acc);
-	    dtpi[sx][sy][3]=nablau[3]*zetaoeta(T(sx,sy,Tacc))*etataupi(sx,sy,pacc,cs2acc);
-	    dtpi[sx][sy][3]-=u[0][sx][sy]*dxpi(sx,sy)+u[1][sx][sy]*dypi(sx,sy);
-	    dtpi[sx][sy][3]-=pib[sx][sy]/taupi(sx,sy,Tacc);
-
-
 	      
 	    Pib[sx][sy]=pib[sx][sy]+eps*(dtpi[sx][sy][0]*vec[sx][sy][0][0]+dtpi[sx][sy][1]*vec[sx][sy][1][0]+dtpi[sx][sy][3])/globut[sx][sy];
 
@@ -2944,6 +3239,53 @@ inline void doInc(double eps)
 }
 
 
+//min(t,tau_pi) at the start of the run, see stepLimit
+double steplimit0=0;
+
+//largest step allowed by the fields of the last doInc.
+//EPS is taken to be right for the start of the run, where the expansion
+//rate 1/t and the relaxation rate 1/tau_pi of the hottest cell are largest;
+//the step grows with min(t,tau_pi) up to ADAPTIVE*EPS and is kept below
+//half the time a signal (flow and sound velocity) needs to cross a cell
+double stepLimit()
+{
+  double taumin=1.e10,vmax=0;
+
+#pragma omp parallel for schedule(static) reduction(min:taumin) reduction(max:vmax)
+  for(int tile=0;tile<ntiles;tile++)
+    for(int sx=tilex[tile],sy=tilelo[tile];sy<=tilehi[tile];sy++)
+      {
+	double v=sqrt(u[0][sx][sy]*u[0][sx][sy]+u[1][sx][sy]*u[1][sx][sy])/globut[sx][sy];
+	double cs=sqrt(thermo[sx][sy].cs2);
+	double vs=(v+cs)/(1+v*cs);
+	if (thermo[sx][sy].taupi<taumin) taumin=thermo[sx][sy].taupi;
+	if (vs>vmax) vmax=vs;
+      }
+
+  double tlim=(t<taumin)?t:taumin;
+  if (steplimit0==0)
+    steplimit0=tlim;
+
+  double step=EPS*tlim/steplimit0;
+  if (step>ADAPTIVE*EPS) step=ADAPTIVE*EPS;
+  if (step<EPS) step=EPS;
+  if ((vmax>0)&&(step>0.5/vmax)) step=0.5/vmax;
+  return step;
+}
+
+//size of the next step with ADAPTIVE>1: at most limit, and cut so that
+//the evolution lands on the next measurement (every UPDATE*EPS) and
+//snapshot time (every SNAPUPDATE*EPS), as with fixed steps
+double nextStep(double limit,double tupdate,double tsnap)
+{
+  double step=limit;
+  if (t+step>tupdate-1.e-3*EPS)
+    step=tupdate-t;
+  if (t+step>tsnap-1.e-3*EPS)
+    step=tsnap-t;
+  return step;
+}
+
 //main driver routine
 void Evolve() 
 {
@@ -2952,6 +3294,10 @@ void Evolve()
   //setting step sizes to maximum step size
   double eps = EPS;
   long int i=0;
+  //with ADAPTIVE>1: whether this step starts at a measurement or snapshot
+  //time, the next such times and the largest allowed step
+  int update=1,snap=1;
+  double tstart=t,tupdate=t+UPDATE*EPS,tsnap=t+SNAPUPDATE*EPS,limit=EPS;
   //for (long int i=1;i<=STEPS;i++) 
   //{
   while((reachedTf==0)&&(wflag==0)) 
@@ -2960,6 +3306,14 @@ void Evolve()
       // evolve fields eps forward in time storing updated fields in captial vars
 	  
 	  doInc(eps); 
+
+	  if (ADAPTIVE>1)
+	    limit=stepLimit();
+	  else
+	    {
+	      update=((i-1)%UPDATE==0);
+	      snap=((i-1)%SNAPUPDATE==0);
+	    }
       
 	  gsl_interp_accel *pacc,*cs2acc,*Tacc;
 	  pacc=gsl_interp_accel_alloc (); 
@@ -2970,7 +3324,7 @@ void Evolve()
 	  // measurements and data dump
 	  //if ( (i>1 && (i-1)%UPDATE==0)) 
 	  //{
-	  if ((i-1)%UPDATE==0) 
+	  if (update) 
 	    {
 	      outputMeasurements(t,pacc,cs2acc,Tacc);
 	      
@@ -2981,7 +3335,7 @@ void Evolve()
 		}
 	      
 	    }
-	  if ((i-1)%SNAPUPDATE==0) 
+	  if (snap&&KEEPFILES) 
 	    {      
 	      snapshot(t,pacc,cs2acc,Tacc); 
 	      //snapshotBulkvisc(t,pacc,cs2acc,Tacc); //mh
@@ -3004,11 +3358,31 @@ void Evolve()
 	  
 	  // increment time
 	  t += eps;
+
+	  if (ADAPTIVE>1)
+	    {
+	      update=(t>tupdate-1.e-3*EPS);
+	      if (update)
+		{
+		  t=tupdate;
+		  tupdate+=UPDATE*EPS;
+		}
+	      snap=(t>tsnap-1.e-3*EPS);
+	      if (snap)
+		{
+		  t=tsnap;
+		  tsnap+=SNAPUPDATE*EPS;
+		}
+	      eps=nextStep(limit,tupdate,tsnap);
+	    }
 					       
 	  if (bflag==1)
 	    break;
 
 	  }
+
+  if (ADAPTIVE>1)
+    printf("===> Info: %li time steps, %.2f EPS on average\n",i,(t-tstart)/EPS/i);
 }
 
 
@@ -3027,10 +3401,25 @@ void cleanup()
   gsl_interp_accel_free (wac);
   gsl_spline_free (pspline);
   gsl_spline_free (etaspline);
+  gsl_spline_free (zetaspline);
   gsl_spline_free (betaspline);
   gsl_spline_free (lambdaspline);
   gsl_spline_free (Tspline);
   gsl_spline_free (cs2spline);
+  workspline=NULL; wac=NULL; pspline=NULL; etaspline=NULL; zetaspline=NULL;
+  betaspline=NULL; lambdaspline=NULL; Tspline=NULL; cs2spline=NULL;
+
+  delete [] eoT4;
+  delete [] cs2i;
+  delete [] poT4;
+  delete [] Ti;
+  eoT4=cs2i=poT4=Ti=NULL;
+}
+
+//file name relative to the run directory of this event
+string path(const char *name)
+{
+  return string(RUNDIR)+name;
 }
 
 void generatehadronparameters()
@@ -3038,7 +3427,7 @@ void generatehadronparameters()
   FILE * pFile;
   
 
-  pFile = fopen ("parameters/default/fixed.param","w");
+  pFile = fopen (path("parameters/default/fixed.param").c_str(),"w");
   
   if (pFile!=NULL)
     {
@@ -3091,17 +3480,89 @@ void generatehadronparameters()
   //dparams.close();
 }
 
-int main() 
+// this workhorse examines a key to see if corresponds to a parameter we are setting
+// and then attempts to set it by converting value to the
+// appropriate type.  lots of hardcoding here
+void setParameter(char *key, char *value) 
+{
+  if (strcmp(key,"NUMT")==0) NUMT=atoi(value);
+  if (strcmp(key,"B")==0) B=atof(value);
+  if (strcmp(key,"L1COEF")==0) L1COEF=atof(value);
+  if (strcmp(key,"L2COEF")==0) L2COEF=atof(value);
+  if (strcmp(key,"TINIT")==0) TINIT=atof(value);
+  if (strcmp(key,"STEPS")==0) STEPS=atoi(value);
+  if (strcmp(key,"B3DEVENTS")==0) B3DEVENTS=atoi(value);
+  if (strcmp(key,"UPDATE")==0) UPDATE=atoi(value);
+  if (strcmp(key,"SNAPUPDATE")==0) SNAPUPDATE=atoi(value);
+  if (strcmp(key,"AT")==0) AT=atof(value);
+  if (strcmp(key,"EPS")==0) EPS=atof(value);
+  if (strcmp(key,"ADAPTIVE")==0) ADAPTIVE=atof(value);
+  if (strcmp(key,"ETAOS")==0) ETAOS=atof(value);
+  if (strcmp(key,"COEFF")==0) COEFF=atof(value);
+  if (strcmp(key,"TF")==0) TF=atof(value);
+  if (strcmp(key,"TSTART")==0) TSTART=atof(value);
+  if (strcmp(key,"IC")==0) IC=atof(value);
+  if (strcmp(key,"PTASIZE")==0) PTASIZE=atoi(value);
+  if (strcmp(key,"PHIPASIZE")==0) PHIPASIZE=atoi(value);
+  if (strcmp(key,"FREEZE")==0) FREEZE=atoi(value);
+  if (strcmp(key,"BINARYFO")==0) BINARYFO=atoi(value);
+  if (strcmp(key,"KEEPFILES")==0) KEEPFILES=atoi(value);
+  if (strcmp(key,"EOSNAME")==0) strcpy(EOSNAME,value);
+  if (strcmp(key,"ETANAME")==0) strcpy(ETANAME,value);
+  if (strcmp(key,"ZETANAME")==0) strcpy(ZETANAME,value);
+  if (strcmp(key,"BETANAME")==0) strcpy(BETANAME,value);
+  if (strcmp(key,"LAMBDANAME")==0) strcpy(LAMBDANAME,value);
+  if (strcmp(key,"PTMAX")==0) PTMAX=atof(value);
+  if (strcmp(key,"MONOEPS")==0) MONOEPS=atof(value);
+  if (strcmp(key,"MONOANGLE")==0) MONOANGLE=atof(value);
+  if (strcmp(key,"BIEPS")==0) BIEPS=atof(value);
+  if (strcmp(key,"BIANGLE")==0) BIANGLE=atof(value);
+  if (strcmp(key,"TRIEPS")==0) TRIEPS=atof(value);
+  if (strcmp(key,"TRIANGLE")==0) TRIANGLE=atof(value);
+  if (strcmp(key,"QUADEPS")==0) QUADEPS=atof(value);
+  if (strcmp(key,"QUADANGLE")==0) QUADANGLE=atof(value);
+  if (strcmp(key,"QUINTEPS")==0) QUINTEPS=atof(value);
+  if (strcmp(key,"QUINTANGLE")==0) QUINTANGLE=atof(value);
+  if (strcmp(key,"SEXEPS")==0) SEXEPS=atof(value);
+  if (strcmp(key,"SEXANGLE")==0) SEXANGLE=atof(value);
+  if (strcmp(key,"SEPTEPS")==0) SEPTEPS=atof(value);
+  if (strcmp(key,"SEPTANGLE")==0) SEPTANGLE=atof(value);
+  if (strcmp(key,"FULL")==0) FULL=atoi(value);
+  if (strcmp(key,"PCE")==0) PCE=atoi(value);
+  if (strcmp(key,"NS")==0) NS=atoi(value);
+  if (strcmp(key,"IFLOW")==0) IFLOW=atoi(value);
+  if (strcmp(key,"RNUC")==0) RNUC=atof(value);
+  if (strcmp(key,"ANUC")==0) ANUC=atof(value);
+  if (strcmp(key,"SIGMANN")==0) SIGMANN=atof(value);
+  if (strcmp(key,"TANORM")==0) TANORM=atof(value);
+  if (strcmp(key,"SMOOTHING")==0) SMOOTHING=atoi(value);
+  if (strcmp(key,"SMOOTH")==0) SMOOTH=atof(value);
+  if (strcmp(key,"SCAL")==0) SCAL=atof(value);
+  if (strcmp(key,"preeqflow")==0) preeqflow=atoi(value);
+  if (strcmp(key,"ECOLD")==0) ECOLD=atof(value);
+  if (strcmp(key,"COLDMARGIN")==0) COLDMARGIN=atoi(value);
+}
+
+void readParameters(const char *filename) 
+{
+  ifstream paramFile(filename);
+  char key[32],value[32];
+	
+  while(nextParameter(paramFile,key,value)) 
+    {
+      setParameter(key,value);
+      cout << key << " = " << value << endl;
+    }
+}
+
+//runs one event in RUNDIR; returns 0 on success and 3 if a nan was encountered
+int run()
 {
- 
-  
-  extern void readParameters(const char*);
-  
   printDivider();
 
   printf("This is VH2-2.1\n");
   
-  readParameters("data/params.txt");
+  readParameters(path("data/params.txt").c_str());
   
 
   printDivider();
@@ -3115,22 +3576,39 @@ int main()
   //generate paramter file for hadronic afterburner
   generatehadronparameters();
   
-  freeze_out.open("data/freezeout_bulk.dat", ios::out);
-  Tzetaos.open("data/Tzetaos_bulk.dat", ios::out);
+  //in the in-process chain the surface goes to fosink and the file is 
+  //only a copy kept with KEEPFILES; a surface convert cannot read with
+  //the same FREEZE (such as FREEZE 1) exists only as a file
+  bool fileonly=(writesBlockFO(FREEZE)!=readsBlockFO(FREEZE));
+  if ((fosink!=NULL)&&fileonly)
+    printf("===> Info: FREEZE %i surface is only written to %s\n",FREEZE,
+	   BINARYFO ? "data/freezeout_bulk.bin" : "data/freezeout_bulk.dat");
+  if ((fosink==NULL)||fileonly||KEEPFILES)
+    {
+      if (BINARYFO)
+	{
+	  freeze_out.open(path("data/freezeout_bulk.bin").c_str(),ios::out|ios::binary);
+	  foheader head=makeFOHeader(writesBlockFO(FREEZE));
+	  freeze_out.write((const char*)&head,sizeof(head));
+	}
+      else
+	freeze_out.open(path("data/freezeout_bulk.dat").c_str(),ios::out);
+    }
+  Tzetaos.open(path("data/Tzetaos_bulk.dat").c_str(),ios::out);
 
 
 #ifdef BG
   printf("Opening custom file for Betz/Gyulassy\n");
-  bgout.open("data/betzgyulassy.dat",ios::out);
+  bgout.open(path("data/betzgyulassy.dat").c_str(),ios::out);
   bgout << "#t [fm/c] \t x [fm] \t y [fm] \t T [GeV] \t u^x \t u^y \t e [GeV^4]\n";
 #endif
 
 
 
-  meta.open("data/meta.dat", ios::out);
+  meta.open(path("data/meta.dat").c_str(),ios::out);
   meta << "# tau [fm]\t" << "T [GeV]\t" << "epsilon [GeV4]\t" << "Phi[GeV4]\t" << "\n";
 
-  ecces.open("data/ecc.dat", ios::out);
+  ecces.open(path("data/ecc.dat").c_str(),ios::out);
   ecces << "#1-tau\t2-e_x\t3-e_p\t4-totalptx\t5-totalpty\t"
 	<<  "6-mome1c\t7-mome1s\t8-mome2c\t9-mome2s\t10-mome3c\t11-mome3s\t"
 	<<  "12-eps1c\t13-eps1s\t14-eps2c\t15-eps2s\t16-eps3c\t17-eps3s\t"
@@ -3146,6 +3624,9 @@ int main()
   gsl_interp_accel_free (Tacc);*/
 
   Evolve();
+
+  if (bandsteps>0)
+    printf("===> Info: evolved %.1f%% of the cells on average\n",100.*cellupdates/bandsteps/NUMT/NUMT);
  
   freeze_out.close();
   Tzetaos.close();
@@ -3185,3 +3666,48 @@ int main()
 
   //return stat;
 }
+
+};
+
+#include "diags.cpp"
+#include "bulkvisc.cpp"
+
+
+//usage: vh2 [rundir1 rundir2 ...]
+//without arguments one event is run in the current directory.
+//Otherwise every argument is the run directory (holding data/, input/ 
+//and parameters/default/) of one event. The events are evolved 
+//concurrently, the available threads are split evenly among them.
+int main(int argc, char *argv[]) 
+{
+  if (argc<2)
+    {
+      vh2solver hydro;
+      return hydro.run();
+    }
+
+  int nevents=argc-1;
+  int nthreads=omp_get_max_threads();
+  int concurrent=(nevents<nthreads)?nevents:nthreads;
+  int inner=nthreads/concurrent;
+  int status=0;
+
+  printf("===> Info: running %i events, %i at a time with %i threads each\n",nevents,concurrent,inner);
+  omp_set_max_active_levels(2);
+
+#pragma omp parallel for schedule(dynamic,1) num_threads(concurrent) reduction(max:status)
+  for (int i=0;i<nevents;i++)
+    {
+      omp_set_num_threads(inner);
+
+      vh2solver hydro;
+      snprintf(hydro.RUNDIR,sizeof(hydro.RUNDIR),"%s/",argv[i+1]);
+      int result=hydro.run();
+      if (result!=0)
+	printf("UVH2+1 failed for %s\n",argv[i+1]);
+      if (result>status)
+	status=result;
+    }
+
+  return status;
+}
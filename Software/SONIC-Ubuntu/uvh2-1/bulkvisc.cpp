@@ -1,5 +1,5 @@
 //vapour pressure
-double pvap(int sx, int sy, gsl_interp_accel *Tacc)
+double vh2solver::pvap(int sx, int sy, gsl_interp_accel *Tacc)
 {
 	double temp=0.0; 
 	// temp=0.0143941 *T(sx,sy,Tacc) - 0.0018451 ; //no influence, deactivated
@@ -8,7 +8,7 @@ double pvap(int sx, int sy, gsl_interp_accel *Tacc)
 }
 
 
-double upastt(int sx,int sy)
+double vh2solver::upastt(int sx,int sy)
 {
   double temp=1.;
   temp+=upast[0][sx][sy]*upast[0][sx][sy]; 
@@ -17,7 +17,7 @@ double upastt(int sx,int sy)
 }
 
 
-double upastmu(int mu, int sx, int sy)
+double vh2solver::upastmu(int mu, int sx, int sy)
 {
   if(mu==2)
     return upastt(sx,sy);
@@ -26,7 +26,7 @@ double upastmu(int mu, int sx, int sy)
 }
 
 
-double Ut(int sx,int sy)
+double vh2solver::Ut(int sx,int sy)
 {
   double temp=1.;
   temp+=U[0][sx][sy]*U[0][sx][sy]; 
@@ -35,7 +35,7 @@ double Ut(int sx,int sy)
 }
 
 
-double Umu(int mu, int sx, int sy)
+double vh2solver::Umu(int mu, int sx, int sy)
 {
   if(mu==2)
     return Ut(sx,sy);
@@ -48,7 +48,7 @@ double Umu(int mu, int sx, int sy)
 // 1st order derivatives
 //
 
-double dtu(int mu, int sx, int sy)
+double vh2solver::dtu(int mu, int sx, int sy)
 {
   double temp=0;
   temp=(Umu(mu,sx,sy)-upastmu(mu,sx,sy))/2.0/EPS;
@@ -56,7 +56,7 @@ double dtu(int mu, int sx, int sy)
 }
 
 //this provides dx U[i]
-double dxU(int i, int sx, int sy)
+double vh2solver::dxU(int i, int sx, int sy)
 {
   double temp=0;
   if(sx==1)
@@ -69,7 +69,7 @@ double dxU(int i, int sx, int sy)
 }
 
 //this provides dy U[i]
-double dyU(int mu,int sx,int sy)
+double vh2solver::dyU(int mu,int sx,int sy)
 {
   double temp=0;
   if(sy==1)
@@ -87,7 +87,7 @@ double dyU(int mu,int sx,int sy)
 //this provides dx upast[i]
 
 
-double dxupast(int i, int sx, int sy)
+double vh2solver::dxupast(int i, int sx, int sy)
 {
   double temp=0;
   if(sx==1)
@@ -100,7 +100,7 @@ double dxupast(int i, int sx, int sy)
 }
 
 //this provides dy upast[i]
-double dyupast(int mu,int sx,int sy)
+double vh2solver::dyupast(int mu,int sx,int sy)
 {
   double temp=0;
   if(sy==1)
@@ -120,7 +120,7 @@ double dyupast(int mu,int sx,int sy)
 //
 
 
-double dx2u(int mu, int sx, int sy)
+double vh2solver::dx2u(int mu, int sx, int sy)
 {
   double temp=0;
   if(sx==1)
@@ -132,7 +132,7 @@ double dx2u(int mu, int sx, int sy)
   return temp;
 }
 
-double dy2u(int mu, int sx, int sy)
+double vh2solver::dy2u(int mu, int sx, int sy)
 {
   double temp=0;
   if(sy==1)
@@ -144,7 +144,7 @@ double dy2u(int mu, int sx, int sy)
   return temp;
 }
 
-double dt2u(int mu, int sx, int sy)
+double vh2solver::dt2u(int mu, int sx, int sy)
 {
   double temp=0;
   temp=(upastmu(mu,sx,sy) - 2.0*umu(mu,sx,sy) + Umu(mu,sx,sy))/EPS/EPS;
@@ -153,7 +153,7 @@ double dt2u(int mu, int sx, int sy)
 
 
 //this provides dydx u[i]
-double dydxu(int i, int sx, int sy)
+double vh2solver::dydxu(int i, int sx, int sy)
 {
   double temp=0;
   if(sy==1)
@@ -166,7 +166,7 @@ double dydxu(int i, int sx, int sy)
 }
 
 //this provides dydx u[i]
-double dxdyu(int i, int sx, int sy)
+double vh2solver::dxdyu(int i, int sx, int sy)
 {
   double temp=0;
   if(sx==1)
@@ -178,7 +178,7 @@ double dxdyu(int i, int sx, int sy)
   return temp;
 }
 
-double DmuUmu(int sx, int sy, double time) //summed components
+double vh2solver::DmuUmu(int sx, int sy, double time) //summed components
 {
   double temp=0;
   temp =dxu(0,sx,sy) + dyu(1,sx,sy) + dtu(2,sx,sy) + umu(2,sx, sy)/time;
@@ -186,7 +186,7 @@ double DmuUmu(int sx, int sy, double time) //summed components
 }
 
 // this provides d_mu u^nu; all 1st order partial derivatives; not summed, though!
-double dmuUnu(int mu, int nu, int sx, int sy)
+double vh2solver::dmuUnu(int mu, int nu, int sx, int sy)
 {
   double temp=0;
   if(mu==0) //d_x
@@ -205,7 +205,7 @@ double dmuUnu(int mu, int nu, int sx, int sy)
 //
 
 
-double H60term(int sx, int sy, double time)
+double vh2solver::H60term(int sx, int sy, double time)
 {
   double temp=0;
 
@@ -220,7 +220,7 @@ double H60term(int sx, int sy, double time)
 }
 
 
-double H61term(int sx, int sy)
+double vh2solver::H61term(int sx, int sy)
 {
   double temp=0;
   temp+= umu(0,sx,sy) * (dxU(2,sx,sy) - dxupast(2,sx,sy))/2.0/EPS; //ux * dt * dx ut
@@ -228,7 +228,7 @@ double H61term(int sx, int sy)
   return temp;
 }
 
-double H62term(int sx, int sy)
+double vh2solver::H62term(int sx, int sy)
 {
   double temp=0;
   temp+= umu(1,sx,sy) * (dyU(2,sx,sy) - dyupast(2,sx,sy))/2.0/EPS; //uy * dt * dy ut
@@ -236,7 +236,7 @@ double H62term(int sx, int sy)
   return temp;
 }
 
-double H63term(int sx, int sy)
+double vh2solver::H63term(int sx, int sy)
 {
   double temp=0;
   temp+= umu(2,sx,sy) * (dxU(0,sx,sy)-dxupast(0,sx,sy))/2.0/EPS; //ut * dt * dx ux
@@ -245,7 +245,7 @@ double H63term(int sx, int sy)
 }
 
 
-double H6term(int sx, int sy, double time)
+double vh2solver::H6term(int sx, int sy, double time)
 {
   double temp=0;
   temp+=H60term(sx,sy,time);
@@ -257,7 +257,7 @@ double H6term(int sx, int sy, double time)
 }
 
 
-double H7term(int sx, int sy)
+double vh2solver::H7term(int sx, int sy)
 {
 	double temp=0.;
 	for(int mu=0;mu<4;mu++)
@@ -277,7 +277,7 @@ double H7term(int sx, int sy)
 	return temp;	
 }
 
-double H8term(int sx, int sy, double time,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc)
+double vh2solver::H8term(int sx, int sy, double time,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc)
 {
   double temp=0.;
   temp = (4.0-log(4.0))*cs2(sx,sy,pacc,cs2acc)*DmuUmu(sx,sy,time)*DmuUmu(sx,sy,time);
@@ -287,7 +287,7 @@ double H8term(int sx, int sy, double time,gsl_interp_accel *pacc,gsl_interp_acce
 //building coefficients using relation between eta & zeta in arXiv:0906.4787v2 
 // zeta/s stays linear
 // Xi term, 2nd order gradient
-double Xi(int sx, int sy, double time,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc)
+double vh2solver::Xi(int sx, int sy, double time,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc)
 {
 	double temp=0.0;
 	temp+=H6term(sx,sy,time);
@@ -297,7 +297,7 @@ double Xi(int sx, int sy, double time,gsl_interp_accel *pacc,gsl_interp_accel *c
 }
 
 
-double bulkzeta1st(int sx, int sy, double time, gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_interp_accel *Tacc)
+double vh2solver::bulkzeta1st(int sx, int sy, double time, gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_interp_accel *Tacc)
 {
   double temp=0;
   temp = (eos(e[sx][sy],pacc,cs2acc)-pvap(sx, sy,Tacc)) * T(sx, sy,Tacc);
@@ -307,7 +307,7 @@ double bulkzeta1st(int sx, int sy, double time, gsl_interp_accel *pacc,gsl_inter
 }
 
 
-double bulkzeta2nd(int sx, int sy, double time, gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_interp_accel *Tacc)
+double vh2solver::bulkzeta2nd(int sx, int sy, double time, gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_interp_accel *Tacc)
 {
   double temp=0;
   temp = (eos(e[sx][sy],pacc,cs2acc)-pvap(sx, sy,Tacc)) * T(sx, sy,Tacc);
@@ -317,7 +317,7 @@ double bulkzeta2nd(int sx, int sy, double time, gsl_interp_accel *pacc,gsl_inter
 }
   
 
-void bulkvisc(double tt,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_interp_accel *Tacc)
+void vh2solver::bulkvisc(double tt,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_interp_accel *Tacc)
 {
   string tab="\t";
   int sy=Middle;  
@@ -332,7 +332,7 @@ void bulkvisc(double tt,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_inte
 }
 
 //routine to calculate the effective pressure (averaged components of the EMT)
-double peff(int sx, int sy, double tt, gsl_interp_accel *pacc, gsl_interp_accel *cs2acc,gsl_interp_accel *Tacc, bool sndorder)
+double vh2solver::peff(int sx, int sy, double tt, gsl_interp_accel *pacc, gsl_interp_accel *cs2acc,gsl_interp_accel *Tacc, bool sndorder)
 {
   double temp=0;
   double zetaos=0;
@@ -349,12 +349,12 @@ double peff(int sx, int sy, double tt, gsl_interp_accel *pacc, gsl_interp_accel
 }
 
 
-void peffout(double tt, gsl_interp_accel *pacc, gsl_interp_accel *cs2acc,gsl_interp_accel *Tacc)
+void vh2solver::peffout(double tt, gsl_interp_accel *pacc, gsl_interp_accel *cs2acc,gsl_interp_accel *Tacc)
 {
   string tab="\t";
   fstream out;
-  char fname[255];
-  sprintf(fname,"data/snapshot/Peff_%.2f.dat",tt/fmtoGeV*AT);
+  char fname[512];
+  snprintf(fname,sizeof(fname),"%sdata/snapshot/Peff_%.2f.dat",RUNDIR,tt/fmtoGeV*AT);
   out.open(fname, ios::out);
   /*
     if ( ZETANAME != zetaoverS-zero.dat )
@@ -383,7 +383,7 @@ void peffout(double tt, gsl_interp_accel *pacc, gsl_interp_accel *cs2acc,gsl_int
   out.close();
 }
 
-void snapshotBulkvisc(double tt,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_interp_accel *Tacc)
+void vh2solver::snapshotBulkvisc(double tt,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_interp_accel *Tacc)
 {
   bulkvisc(tt, pacc, cs2acc, Tacc); 
   peffout(tt,pacc,cs2acc,Tacc);
@@ -13,6 +13,8 @@
 #include <gsl/gsl_integration.h>
 #include <gsl/gsl_sf_bessel.h>
 #include <gsl/gsl_multifit.h>
+#include "freezeout.h"
+#include <omp.h>
 
 
 int probon=0;
@@ -136,6 +138,27 @@ struct dummy_params
 
 gsl_integration_workspace * w = gsl_integration_workspace_alloc (INTSPACE);
 
+//workspace of ointegrate1/2; gsl errors are left to the return codes
+//while quietgsl is set (see gslhandler)
+gsl_integration_workspace * threadw=NULL;
+int quietgsl=0;
+
+//the accelerators of the surface splines, the tau spline of prepareint and
+//the workspace change with every integration, so every thread of
+//generatetab has its own (see beginThread). The splines are shared.
+#pragma omp threadprivate(xacc,yacc,uxacc,uyacc,pixxacc,pixyacc,piyyacc,dtxacc,dtyacc)
+#pragma omp threadprivate(tacc,ouxacc,ouyacc,opixxacc,opixyacc,opiyyacc,dxtacc)
+#pragma omp threadprivate(tsspline,tsacc,threadw,quietgsl)
+
+void gslhandler(const char *reason,const char *file,int line,int gsl_errno)
+{
+  if (quietgsl)
+    return;
+  fprintf(stderr,"gsl: %s:%d: ERROR: %s\n",file,line,reason);
+  fprintf(stderr,"Default GSL error handler invoked.\n");
+  abort();
+}
+
 //const int LIMITS=1024;
 const int LIMITS=5200;
 const int MAXL=1024;
@@ -159,8 +182,78 @@ int switcherpercent=80;
 // double PTMAX=4.2;
 
 
+gsl_interp_accel ** allocAccels(int n)
+{
+  gsl_interp_accel **acc=new gsl_interp_accel*[n];
+  for (int i=0;i<n;i++)
+    acc[i]=gsl_interp_accel_alloc ();
+  return acc;
+}
+
+void freeAccels(gsl_interp_accel **acc,int n)
+{
+  for (int i=0;i<n;i++)
+    gsl_interp_accel_free (acc[i]);
+  delete [] acc;
+}
+
+//called by every thread that integrates over the isochronous surface;
+//thread 0 keeps the accelerators and tau spline of allocMem and interpolate
+void beginThread()
+{
+  threadw=gsl_integration_workspace_alloc (INTSPACE);
+  if (omp_get_thread_num()==0)
+    return;
+  xacc=allocAccels(totalnum);
+  yacc=allocAccels(totalnum);
+  uxacc=allocAccels(totalnum);
+  uyacc=allocAccels(totalnum);
+  pixxacc=allocAccels(totalnum);
+  pixyacc=allocAccels(totalnum);
+  piyyacc=allocAccels(totalnum);
+  dtxacc=allocAccels(totalnum);
+  dtyacc=allocAccels(totalnum);
+  tacc=allocAccels(numpoints);
+  ouxacc=allocAccels(numpoints);
+  ouyacc=allocAccels(numpoints);
+  opixxacc=allocAccels(numpoints);
+  opixyacc=allocAccels(numpoints);
+  opiyyacc=allocAccels(numpoints);
+  dxtacc=allocAccels(numpoints);
+  tsspline=gsl_spline_alloc (gsl_interp_cspline, switcher-1);
+  tsacc=gsl_interp_accel_alloc ();
+}
+
+void endThread()
+{
+  gsl_integration_workspace_free (threadw);
+  threadw=NULL;
+  if (omp_get_thread_num()==0)
+    return;
+  freeAccels(xacc,totalnum);
+  freeAccels(yacc,totalnum);
+  freeAccels(uxacc,totalnum);
+  freeAccels(uyacc,totalnum);
+  freeAccels(pixxacc,totalnum);
+  freeAccels(pixyacc,totalnum);
+  freeAccels(piyyacc,totalnum);
+  freeAccels(dtxacc,totalnum);
+  freeAccels(dtyacc,totalnum);
+  freeAccels(tacc,numpoints);
+  freeAccels(ouxacc,numpoints);
+  freeAccels(ouyacc,numpoints);
+  freeAccels(opixxacc,numpoints);
+  freeAccels(opixyacc,numpoints);
+  freeAccels(opiyyacc,numpoints);
+  freeAccels(dxtacc,numpoints);
+  gsl_spline_free (tsspline);
+  gsl_interp_accel_free (tsacc);
+}
+
 // input files
 fstream freeze_out,dummy;
+//binary surface (data/freezeout.bin), used instead of the text file unless that is newer
+fosurface fosurf;
 
 fstream massfile,namesfile,gsfile;
 
@@ -175,6 +268,25 @@ void countsets()
   totalnum=0;
   subnum=-1;
   //determine how many sets
+  if (fosurf.records>=0)
+    {
+      subnum=fosurf.records;
+      //isochronous surface: a set is a run of records with the same tau
+      if (!fosurf.head.block)
+	for (long int i=0;i<subnum;i++)
+	  if ((i==subnum-1)||(fosurf.field(i+1,FO_TAU)!=fosurf.field(i,FO_TAU)))
+	    {
+	      if (totalnum>=LIMITS)
+		{
+		  printf("More than LIMITS sets. Aborting\n");
+		  break;
+		}
+	      //same numbering as the TIME lines of the text file
+	      numset[totalnum]=i+1+totalnum;
+	      totalnum++;
+	    }
+    }
+  else
   while (!freeze_out.eof())
     {
       freeze_out.getline(buffer,1024,'\n');
@@ -361,7 +473,25 @@ void freeMem()
   gsl_spline_free(tsspline);
   gsl_interp_accel_free(tsacc);
 
+  //main allocates a new one for the next surface (sonic.cpp)
   gsl_integration_workspace_free (w);
+  w=NULL;
+}
+
+void blockfreeMem()
+{
+  delete [] xp;
+  delete [] yp;
+  delete [] phi;
+  delete [] ux;
+  delete [] uy;
+  delete [] pixx;
+  delete [] pixy;
+  delete [] piyy;
+  delete [] taup;
+  delete [] direction;
+  delete [] Tp;
+  delete [] taus;
 }
 
 //Get data
@@ -378,6 +508,26 @@ int readsets()
 
   char obda;
 
+  if (fosurf.records>=0)
+    {
+      for (pos=0;pos<subnum;pos++)
+	{
+	  xp[pos]=fosurf.field(pos,FO_X);
+	  yp[pos]=fosurf.field(pos,FO_Y);
+	  phi[pos]=atan2(yp[pos],xp[pos]);
+	  if (phi[pos]<0) phi[pos]+=2*M_PI;
+	  ux[pos]=fosurf.field(pos,FO_UX);
+	  uy[pos]=fosurf.field(pos,FO_UY);
+	  pixx[pos]=fosurf.field(pos,FO_PIXX);
+	  pixy[pos]=fosurf.field(pos,FO_PIXY);
+	  piyy[pos]=fosurf.field(pos,FO_PIYY);
+	}
+      for (setpos=0;setpos<totalnum;setpos++)
+	taus[setpos]=fosurf.field(numset[setpos]-setpos-1,FO_TAU);
+      fosurf.close();
+      return 0;
+    }
+
   while((!dummy.eof())&&(setpos<totalnum))
     {
       if (pos!=(numset[setpos]-setpos))
@@ -431,6 +581,24 @@ int readsets()
 int blockreadsets()
 {
   long int pos=0;
+  if (fosurf.records>=0)
+    {
+      for (pos=0;pos<subnum;pos++)
+	{
+	  xp[pos]=fosurf.field(pos,FO_X);
+	  yp[pos]=fosurf.field(pos,FO_Y);
+	  taup[pos]=fosurf.field(pos,FO_TAU);
+	  direction[pos]=(int)fosurf.field(pos,FO_DIR);
+	  ux[pos]=fosurf.field(pos,FO_UX);
+	  uy[pos]=fosurf.field(pos,FO_UY);
+	  pixx[pos]=fosurf.field(pos,FO_PIXX);
+	  pixy[pos]=fosurf.field(pos,FO_PIXY);
+	  piyy[pos]=fosurf.field(pos,FO_PIYY);
+	  Tp[pos]=fosurf.field(pos,FO_T);
+	}
+      fosurf.close();
+      return 0;
+    }
   while((!dummy.eof()))
   {
     dummy >> xp[pos];
@@ -478,6 +646,11 @@ double xinv(double T2, double T3, double y)
 //this integrates the off-equilibrium distribution function over the (block-wise) freeze out surface
 double blockintegrate(double m0,double pt, double phip)
 {
+  //own accelerators, generatetab calls this from several threads
+  gsl_interp_accel *beacc=gsl_interp_accel_alloc ();
+  gsl_interp_accel *bpacc=gsl_interp_accel_alloc ();
+  gsl_interp_accel *balphaacc=gsl_interp_accel_alloc ();
+
   double sum = 0.0;
   double px=pt*cos(phip);
   double py=pt*sin(phip);
@@ -507,9 +680,9 @@ double blockintegrate(double m0,double pt, double phip)
     else
     {
       //if not using quadratic ansatz for viscous correction, do the rapidity integral numerically
-      e = gsl_spline_eval(espline,T,eacc);
-      p = gsl_spline_eval(pspline,T,pacc);
-      c = gsl_spline_eval(alphaspline,T,alphaacc);
+      e = gsl_spline_eval(espline,T,beacc);
+      p = gsl_spline_eval(pspline,T,bpacc);
+      c = gsl_spline_eval(alphaspline,T,balphaacc);
       
       //multiply by coefficient and remove factor of enthalpy
       mpixx=c*(e+p)*pixx[pos];
@@ -699,6 +872,10 @@ double blockintegrate(double m0,double pt, double phip)
   sum*=2;
   sum*=fmtoGeV;
 
+  gsl_interp_accel_free (beacc);
+  gsl_interp_accel_free (bpacc);
+  gsl_interp_accel_free (balphaacc);
+
   return sum;
 }
 
@@ -2518,23 +2695,22 @@ double ointegrate1(double T,double m0,double pt, double phip, int thisset)
   
   
 
-  gsl_error_handler_t * new_handler;
-
-  new_handler=gsl_set_error_handler_off();
+  //roundoff errors are handled below
+  quietgsl=1;
     
 
   int bad=3;
 
   
 
-  int code=gsl_integration_qag(&F,0,2*M_PI,1e-10,INTACC,INTSPACE,3,w,&result,&error);
+  int code=gsl_integration_qag(&F,0,2*M_PI,1e-10,INTACC,INTSPACE,3,threadw,&result,&error);
 
 
   while(code==GSL_EROUND)
     {
       bad++;
       //printf("Roundoff error, badness %i, set %i\n",bad-1,thisset);
-      code=gsl_integration_qag(&F,0,2*M_PI,1e-10,INTACC,INTSPACE,bad,w,&result,&error);
+      code=gsl_integration_qag(&F,0,2*M_PI,1e-10,INTACC,INTSPACE,bad,threadw,&result,&error);
       
       if (bad==7)
 	{
@@ -2545,8 +2721,7 @@ double ointegrate1(double T,double m0,double pt, double phip, int thisset)
     }
 
 
-  /* restore original handler */
-  gsl_set_error_handler (new_handler);
+  quietgsl=0;
 
   /*
   F.function = &firstintegrand;
@@ -2599,9 +2774,8 @@ double ointegrate2(double T,double m0,double pt, double phip, int thisset)
 	}*/
 
 
-  gsl_error_handler_t * new_handler;
-
-  new_handler=gsl_set_error_handler_off();
+  //roundoff errors are handled below
+  quietgsl=1;
     
 
   int bad=3;
@@ -2611,13 +2785,13 @@ double ointegrate2(double T,double m0,double pt, double phip, int thisset)
 
   //printf("low %f high %f\n",low,high);
 
-  int code=gsl_integration_qag(&F,low,high,1e-10,INTACC,INTSPACE,3,w,&result,&error);
+  int code=gsl_integration_qag(&F,low,high,1e-10,INTACC,INTSPACE,3,threadw,&result,&error);
 
   while(code==GSL_EROUND)
     {
       bad++;
       //printf("Roundoff error, badness %i, set %i\n",bad-1,thisset);
-      code=gsl_integration_qag(&F,low,high,1e-10,INTACC,INTSPACE,bad,w,&result,&error);
+      code=gsl_integration_qag(&F,low,high,1e-10,INTACC,INTSPACE,bad,threadw,&result,&error);
       
       if (bad==7)
 	{
@@ -2628,8 +2802,7 @@ double ointegrate2(double T,double m0,double pt, double phip, int thisset)
     }
 
 
-  /* restore original handler */
-  gsl_set_error_handler (new_handler);
+  quietgsl=0;
 
   if (isnan(result)!=0)
     printf("Problem here %i\n",thisset);
@@ -3028,29 +3201,32 @@ void generatetab()
 	  printf("Generating table for %s with mass %f and spin gs=%f\n",buffer,tempmass,gsfact);
 	  if (tempmass!=oldmass)
 	    {
-	      int j=0;
-	      //phip-table
-	      for (double pt=0.01;pt<PTMAX;pt+=PTMAX/PTASIZE)
-		{
-		  for(int k=0;k<PHIPASIZE;k++)
-		    {
-		      //prepareint(TF,tempmass,pt,phipbuff[k]);
-		      
-		      ptbuff[j]=pt;
-		      //resbuff[j][k]=doint();
-		      //printf("pt = %f phi =% f\n",pt,phipbuff[k]);
-		      //get integral times spin degeneracy factor
-		      if (FREEZE < 2) resbuff[j][k]=gsfact*prepareint(TF,tempmass,pt,phipbuff[k]);
-		      else resbuff[j][k]=gsfact*blockintegrate(tempmass,pt,phipbuff[k]);
-
-		      if (isnan(resbuff[j][k])!=0)
-			  printf("Problem at %f %f\n",pt,phipbuff[k]);
-
-		      //printf("result =%f\n",resbuff[j][k]);
-		      //printf("pt = %f phi =% f res=%f\n",pt,phipbuff[k],resbuff[j][k]);
-		    }
-		  j++;
-		}
+	      int npt=0;
+	      for (double pt=0.01;(pt<PTMAX)&&(npt<PTASIZE);pt+=PTMAX/PTASIZE)
+		ptbuff[npt++]=pt;
+
+	      //phip-table: every point is integrated by one thread,
+	      //so the table does not depend on the number of threads
+#pragma omp parallel
+	      {
+		if (FREEZE < 2) beginThread();
+
+#pragma omp for schedule(dynamic)
+		for (int jk=0;jk<npt*PHIPASIZE;jk++)
+		  {
+		    int j=jk/PHIPASIZE;
+		    int k=jk%PHIPASIZE;
+		    double pt=ptbuff[j];
+		    //get integral times spin degeneracy factor
+		    if (FREEZE < 2) resbuff[j][k]=gsfact*prepareint(TF,tempmass,pt,phipbuff[k]);
+		    else resbuff[j][k]=gsfact*blockintegrate(tempmass,pt,phipbuff[k]);
+
+		    if (isnan(resbuff[j][k])!=0)
+		      printf("Problem at %f %f\n",pt,phipbuff[k]);
+		  }
+
+		if (FREEZE < 2) endThread();
+	      }
 	    }
 	  else
 	    {
@@ -3103,6 +3279,7 @@ void generatetab()
 
 void singlept(double mass)
 {
+  beginThread();
   
   double tempmass=mass;
   double oldmass=0;
@@ -3153,7 +3330,7 @@ void singlept(double mass)
     }
   
   printf("Done!\n");
-  
+  endThread();
 }
 
 
@@ -3166,9 +3343,30 @@ int main (void)
 
   readParameters("data/params.txt");
 
-  //open data file
+  if (w==NULL)
+    w=gsl_integration_workspace_alloc (INTSPACE);
+
+  //errors inside the integrations are handled by their return codes
+  gsl_set_error_handler (&gslhandler);
 
-  freeze_out.open("data/freezeout.dat", ios::in);
+  //open data file, the binary surface written with BINARYFO 1 if there is one
+  //that is not older than the text file,
+  //unless the surface was handed over in memory (sonic.cpp)
+
+  if (fosurf.records>=0)
+    printf("Using the freeze-out surface of the in-process chain\n");
+  else if (fosurf.openIfNewer("data/freezeout.bin","data/freezeout.dat"))
+    printf("Reading binary surface data/freezeout.bin\n");
+  else
+    {
+      printf("Reading text surface data/freezeout.dat\n");
+      freeze_out.open("data/freezeout.dat", ios::in);
+    }
+  if ((fosurf.records>=0)&&(fosurf.head.block!=readsBlockFO(FREEZE)))
+    {
+      printf("Error: the %s freeze-out surface cannot be read with FREEZE %i\n",fosurf.head.block ? "block" : "isochronous",FREEZE);
+      exit(1);
+    }
 
   countsets();
   
@@ -3220,6 +3418,7 @@ int main (void)
 
 
   if (FREEZE < 2) freeMem();
+  else blockfreeMem();
 
   ptfile.close();
   pttab.close();
@@ -22,6 +22,8 @@ and check that the results are similar.
 #include <gsl/gsl_integration.h>
 #include <gsl/gsl_sf_bessel.h>
 #include <gsl/gsl_multifit.h>
+#include "freezeout.h"
+#include <omp.h>
 
 
 int probon=0;
@@ -108,6 +110,26 @@ struct dummy_params
 
 gsl_integration_workspace * w = gsl_integration_workspace_alloc (INTSPACE);
 
+//workspace of ointegrate1/2; gsl errors are left to the return codes
+//while quietgsl is set (see gslhandler)
+gsl_integration_workspace * threadw=NULL;
+int quietgsl=0;
+
+//the accelerators of the surface splines, the tau spline of prepareint and
+//the workspace change with every integration, so every thread of
+//generatetab has its own (see beginThread). The splines are shared.
+#pragma omp threadprivate(xacc,yacc,uxacc,uyacc,pixxacc,pixyacc,piyyacc,dtxacc,dtyacc)
+#pragma omp threadprivate(tsspline,tsacc,threadw,quietgsl)
+
+void gslhandler(const char *reason,const char *file,int line,int gsl_errno)
+{
+  if (quietgsl)
+    return;
+  fprintf(stderr,"gsl: %s:%d: ERROR: %s\n",file,line,reason);
+  fprintf(stderr,"Default GSL error handler invoked.\n");
+  abort();
+}
+
 //const int LIMITS=1024;
 const int LIMITS=5200;
 const int MAXL=1024;
@@ -128,8 +150,64 @@ int * counterarr;
 double *boundarr;
 
 
+gsl_interp_accel ** allocAccels(int n)
+{
+  gsl_interp_accel **acc=new gsl_interp_accel*[n];
+  for (int i=0;i<n;i++)
+    acc[i]=gsl_interp_accel_alloc ();
+  return acc;
+}
+
+void freeAccels(gsl_interp_accel **acc,int n)
+{
+  for (int i=0;i<n;i++)
+    gsl_interp_accel_free (acc[i]);
+  delete [] acc;
+}
+
+//called by every thread that integrates over the isochronous surface;
+//thread 0 keeps the accelerators and tau spline of allocMem and interpolate
+void beginThread()
+{
+  threadw=gsl_integration_workspace_alloc (INTSPACE);
+  if (omp_get_thread_num()==0)
+    return;
+  xacc=allocAccels(totalnum);
+  yacc=allocAccels(totalnum);
+  uxacc=allocAccels(totalnum);
+  uyacc=allocAccels(totalnum);
+  pixxacc=allocAccels(totalnum);
+  pixyacc=allocAccels(totalnum);
+  piyyacc=allocAccels(totalnum);
+  dtxacc=allocAccels(totalnum);
+  dtyacc=allocAccels(totalnum);
+  tsspline=gsl_spline_alloc (gsl_interp_cspline, totalnum-1);
+  tsacc=gsl_interp_accel_alloc ();
+}
+
+void endThread()
+{
+  gsl_integration_workspace_free (threadw);
+  threadw=NULL;
+  if (omp_get_thread_num()==0)
+    return;
+  freeAccels(xacc,totalnum);
+  freeAccels(yacc,totalnum);
+  freeAccels(uxacc,totalnum);
+  freeAccels(uyacc,totalnum);
+  freeAccels(pixxacc,totalnum);
+  freeAccels(pixyacc,totalnum);
+  freeAccels(piyyacc,totalnum);
+  freeAccels(dtxacc,totalnum);
+  freeAccels(dtyacc,totalnum);
+  gsl_spline_free (tsspline);
+  gsl_interp_accel_free (tsacc);
+}
+
 // input files
 fstream freeze_out,dummy;
+//binary surface (data/freezeout.bin), used instead of the text file unless that is newer
+fosurface fosurf;
 
 fstream massfile,namesfile,gsfile;
 
@@ -144,6 +222,25 @@ void countsets()
   totalnum=0;
   subnum=-1;
   //determine how many sets
+  if (fosurf.records>=0)
+    {
+      subnum=fosurf.records;
+      //isochronous surface: a set is a run of records with the same tau
+      if (!fosurf.head.block)
+	for (long int i=0;i<subnum;i++)
+	  if ((i==subnum-1)||(fosurf.field(i+1,FO_TAU)!=fosurf.field(i,FO_TAU)))
+	    {
+	      if (totalnum>=LIMITS)
+		{
+		  printf("More than LIMITS sets. Aborting\n");
+		  break;
+		}
+	      //same numbering as the TIME lines of the text file
+	      numset[totalnum]=i+1+totalnum;
+	      totalnum++;
+	    }
+    }
+  else
   while (!freeze_out.eof())
     {
       freeze_out.getline(buffer,1024,'\n');
@@ -322,6 +419,26 @@ int readsets()
 
   char obda;
 
+  if (fosurf.records>=0)
+    {
+      for (pos=0;pos<subnum;pos++)
+	{
+	  xp[pos]=fosurf.field(pos,FO_X);
+	  yp[pos]=fosurf.field(pos,FO_Y);
+	  phi[pos]=atan2(yp[pos],xp[pos]);
+	  if (phi[pos]<0) phi[pos]+=2*M_PI;
+	  ux[pos]=fosurf.field(pos,FO_UX);
+	  uy[pos]=fosurf.field(pos,FO_UY);
+	  pixx[pos]=fosurf.field(pos,FO_PIXX);
+	  pixy[pos]=fosurf.field(pos,FO_PIXY);
+	  piyy[pos]=fosurf.field(pos,FO_PIYY);
+	}
+      for (setpos=0;setpos<totalnum;setpos++)
+	taus[setpos]=fosurf.field(numset[setpos]-setpos-1,FO_TAU);
+      fosurf.close();
+      return 0;
+    }
+
   while((!dummy.eof())&&(setpos<totalnum))
     {
       if (pos!=(numset[setpos]-setpos))
@@ -961,23 +1078,22 @@ double ointegrate1(double T,double m0,double pt, double phip, int thisset)
   
   
 
-  gsl_error_handler_t * new_handler;
-
-  new_handler=gsl_set_error_handler_off();
+  //roundoff errors are handled below
+  quietgsl=1;
     
 
   int bad=3;
 
   
 
-  int code=gsl_integration_qag(&F,0,2*M_PI,1e-10,INTACC,INTSPACE,3,w,&result,&error);
+  int code=gsl_integration_qag(&F,0,2*M_PI,1e-10,INTACC,INTSPACE,3,threadw,&result,&error);
 
 
   while(code==GSL_EROUND)
     {
       bad++;
       //printf("Roundoff error, badness %i, set %i\n",bad-1,thisset);
-      code=gsl_integration_qag(&F,0,2*M_PI,1e-10,INTACC,INTSPACE,bad,w,&result,&error);
+      code=gsl_integration_qag(&F,0,2*M_PI,1e-10,INTACC,INTSPACE,bad,threadw,&result,&error);
       
       if (bad==7)
 	{
@@ -988,8 +1104,7 @@ double ointegrate1(double T,double m0,double pt, double phip, int thisset)
     }
 
 
-  /* restore original handler */
-  gsl_set_error_handler (new_handler);
+  quietgsl=0;
 
   /*
   F.function = &firstintegrand;
@@ -1314,17 +1429,22 @@ void generatetab()
 	  printf("Generating table for %s with mass %f and spin gs=%f\n",buffer,tempmass,gsfact);
 	  if (tempmass!=oldmass)
 	    {
-	      int j=0;
-	      //phip-table
-	      for (double pt=0.01;pt<PTMAX;pt+=PTMAX/PTASIZE)
-		{
-		  for(int k=0;k<PHIPASIZE;k++)
+	      int npt=0;
+	      for (double pt=0.01;(pt<PTMAX)&&(npt<PTASIZE);pt+=PTMAX/PTASIZE)
+		ptbuff[npt++]=pt;
+
+	      //phip-table: every point is integrated by one thread,
+	      //so the table does not depend on the number of threads
+#pragma omp parallel
+	      {
+		beginThread();
+
+#pragma omp for schedule(dynamic)
+		for (int jk=0;jk<npt*PHIPASIZE;jk++)
 		    {
-		      //prepareint(TF,tempmass,pt,phipbuff[k]);
-		      
-		      ptbuff[j]=pt;
-		      //printf("pt = %f phi =% f\n",pt,phipbuff[k]);
-		      
+		      int j=jk/PHIPASIZE;
+		      int k=jk%PHIPASIZE;
+		      double pt=ptbuff[j];
 		      
 		      //get integral times spin degeneracy factor
 		      resbuff[j][k]=gsfact*prepareint(TF,tempmass,pt,phipbuff[k]);
@@ -1341,12 +1461,10 @@ void generatetab()
 		      
 		      if (isnan(resbuff[j][k])!=0)
 			  printf("Problem at %f %f\n",pt,phipbuff[k]);
-
-		      //printf("result =%f\n",resbuff[j][k]);
-		      //printf("pt = %f phi =% f res=%f\n",pt,phipbuff[k],resbuff[j][k]);
 		    }
-		  j++;
-		}
+
+		endThread();
+	      }
 	    }
 	  else
 	    {
@@ -1389,6 +1507,7 @@ void generatetab()
 
 void singlept(double mass)
 {
+  beginThread();
   
   double tempmass=mass;
   double oldmass=0;
@@ -1439,7 +1558,7 @@ void singlept(double mass)
     }
   
   printf("Done!\n");
-  
+  endThread();
 }
 
 
@@ -1452,9 +1571,26 @@ int main (void)
 
   readParameters("data/params.txt");
 
-  //open data file
+  //errors inside the integrations are handled by their return codes
+  gsl_set_error_handler (&gslhandler);
 
-  freeze_out.open("data/freezeout.dat", ios::in);
+  //open data file, the binary surface written with BINARYFO 1 if there is one
+  //that is not older than the text file
+
+  if (fosurf.openIfNewer("data/freezeout.bin","data/freezeout.dat"))
+    {
+      printf("Reading binary surface data/freezeout.bin\n");
+      if (fosurf.head.block)
+	{
+	  printf("Error: convertnew needs an isochronous surface (FREEZE 0)\n");
+	  exit(1);
+	}
+    }
+  else
+    {
+      printf("Reading text surface data/freezeout.dat\n");
+      freeze_out.open("data/freezeout.dat", ios::in);
+    }
 
   countsets();
   
@@ -1,4 +1,4 @@
-double anisospace()
+double vh2solver::anisospace()
 {
   double diff=0,sum=0;
   
@@ -31,7 +31,7 @@ double anisomomentum(gsl_interp_accel *pacc,gsl_interp_accel *cs2acc)
 }
 */
 
-void allanisomomentum(double& ex,double& ep, double& totpx, double& totpy, double& e1c, double& e1s, double& e2c, double& e2s, double& e3c, double& e3s, double& eps1c, double&eps1s, double& eps2c, double& eps2s, double& eps3c, double& eps3s, double& eps4c, double& eps4s, double& eps5c, double& eps5s, double& eps6c, double& eps6s, double& eps7c, double& eps7s,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc)
+void vh2solver::allanisomomentum(double& ex,double& ep, double& totpx, double& totpy, double& e1c, double& e1s, double& e2c, double& e2s, double& e3c, double& e3s, double& eps1c, double&eps1s, double& eps2c, double& eps2s, double& eps3c, double& eps3s, double& eps4c, double& eps4s, double& eps5c, double& eps5s, double& eps6c, double& eps6s, double& eps7c, double& eps7s,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc)
 {
     double diffp=0,sump=0;
     double diffx=0,sumx=0;
@@ -200,19 +200,19 @@ double totalmomentumy(gsl_interp_accel *pacc,gsl_interp_accel *cs2acc)
 
 
 
-double uphi(int sx,int sy)
+double vh2solver::uphi(int sx,int sy)
 {
   double temp=(u[1][sx][sy]*sx-u[0][sx][sy]*sy)/sqrt(sx*sx+sy*sy);
   return temp;
 }
 
-double ur(int sx,int sy)
+double vh2solver::ur(int sx,int sy)
 {
   double temp=(u[0][sx][sy]*sx+u[1][sx][sy]*sy)/sqrt(sx*sx+sy*sy);
   return temp;
 }
 
-int foundit(int sx, int sy,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc)
+int vh2solver::foundit(int sx, int sy,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc)
 {
   globali=geti(e[sx][sy]);
   globalx=getx(globali,e[sx][sy]);
@@ -227,7 +227,7 @@ int foundit(int sx, int sy,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc)
   return 0;
 }
 
-void fancyfoundx(double sx, int sy,streambuf* pbuf,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc)
+void vh2solver::fancyfoundx(double sx, int sy,streambuf* pbuf,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc)
 {
 
   //fstream str;
@@ -317,7 +317,7 @@ void fancyfoundx(double sx, int sy,streambuf* pbuf,gsl_interp_accel *pacc,gsl_in
 
 }
 
-void fancyfoundy(int sx, double sy,streambuf* pbuf,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc)
+void vh2solver::fancyfoundy(int sx, double sy,streambuf* pbuf,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc)
 {
 
   streambuf* important;
@@ -395,11 +395,13 @@ void fancyfoundy(int sx, double sy,streambuf* pbuf,gsl_interp_accel *pacc,gsl_in
 }
 
 
-double rootfunction(double x,void *params)
+//params is the solver
+static double rootfunction(double x,void *params)
 {
+  vh2solver *s=(vh2solver *)params;
   double temp;
-  temp=gsl_spline_eval (workspline, x, wac);
-  return (temp-TF);
+  temp=gsl_spline_eval (s->workspline, x, s->wac);
+  return (temp-s->TF);
 }
 /*
 //fancy freeze-out with interpolation
@@ -435,7 +437,7 @@ void fancyfreeze(gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_interp_acce
       double dummy=0;
 
       F.function=&rootfunction;
-      F.params=&dummy;
+      F.params=this;
 
       TT = gsl_root_fsolver_brent;
       ss = gsl_root_fsolver_alloc (TT);
@@ -663,7 +665,7 @@ void fancyfreeze(gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_interp_acce
 }
 */
 
-void stupidfreeze(gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_interp_accel *Tacc)
+void vh2solver::stupidfreeze(gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_interp_accel *Tacc)
 {
 
   if (T(Middle,Middle,Tacc)<TF)
@@ -673,25 +675,56 @@ void stupidfreeze(gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_interp_acc
       for (int sx=1;sx<=NUMT;sx++)
 	for (int sy=1;sy<=NUMT;sy++)
 	  {
-	    freeze_out << (sx-Middle)/fmtoGeV*AT << "\t";
-	    freeze_out << (sy-Middle)/fmtoGeV*AT << "\t";
-	    freeze_out << u[0][sx][sy] << "\t";
-	    freeze_out << u[1][sx][sy] << "\t";
-	    freeze_out << pixx[sx][sy]/(e[sx][sy]+eos(e[sx][sy],pacc,cs2acc)) << "\t";
-	    freeze_out << pixy[sx][sy]/(e[sx][sy]+eos(e[sx][sy],pacc,cs2acc)) << "\t";
-	    freeze_out << piyy[sx][sy]/(e[sx][sy]+eos(e[sx][sy],pacc,cs2acc)) << "\t";
-	    freeze_out << T(sx,sy,Tacc)/AT << "\n";
+	    double ep=e[sx][sy]+eos(e[sx][sy],pacc,cs2acc);
+	    double rec[FO_FIELDS]={(sx-Middle)/fmtoGeV*AT,(sy-Middle)/fmtoGeV*AT,t/fmtoGeV*AT,0,
+				   u[0][sx][sy],u[1][sx][sy],pixx[sx][sy]/ep,pixy[sx][sy]/ep,piyy[sx][sy]/ep,
+				   pib[sx][sy]/ep,T(sx,sy,Tacc)/AT};
+	    if (fosink!=NULL)
+	      fosink->insert(fosink->end(),rec,rec+FO_FIELDS);
+	    if (!freeze_out.is_open())
+	      continue;
+	    if (BINARYFO)
+	      freeze_out.write((const char*)rec,sizeof(rec));
+	    else
+	      {
+		freeze_out << rec[FO_X] << "\t";
+		freeze_out << rec[FO_Y] << "\t";
+		freeze_out << rec[FO_UX] << "\t";
+		freeze_out << rec[FO_UY] << "\t";
+		freeze_out << rec[FO_PIXX] << "\t";
+		freeze_out << rec[FO_PIXY] << "\t";
+		freeze_out << rec[FO_PIYY] << "\t";
+		freeze_out << rec[FO_T] << "\n";
+	      }
 	  }
-      freeze_out << "TIME \t" << t/fmtoGeV*AT << endl;
+      //the binary records carry tau themselves
+      if ((!BINARYFO)&&freeze_out.is_open())
+	freeze_out << "TIME \t" << t/fmtoGeV*AT << endl;
     }
 }
 
 
 
+//one element of the block freeze-out surface, as a line of text or 
+//as a binary record (BINARYFO, see freezeout.h) and, in the in-process
+//chain, appended to fosink
+void vh2solver::blockfound(const double *rec)
+{
+  if (fosink!=NULL)
+    fosink->insert(fosink->end(),rec,rec+FO_FIELDS);
+  if (!freeze_out.is_open())
+    return;
+  if (BINARYFO)
+    freeze_out.write((const char*)rec,FO_FIELDS*sizeof(double));
+  else
+    for (int i=0;i<FO_FIELDS;i++)
+      freeze_out << rec[i] << ((i<FO_FIELDS-1) ? "\t" : "\n");
+}
+
 //freeze-out that doesn't assume a monotonically 
 //decreasing temperature from the center out
 //written by Matthew Luzum
-void blockfreeze(gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_interp_accel *Tacc)
+void vh2solver::blockfreeze(gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_interp_accel *Tacc)
 {
 
 
@@ -713,21 +746,19 @@ void blockfreeze(gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_interp_acce
 	  reachedTf = 0;
 	  int direction = 2;
 	  if ((T(sx,sy,Tacc) <= TF) && (T(sx,sy+1,Tacc) > TF)) direction = -2;
-	  freeze_out << (sx-Middle)/fmtoGeV*AT << "\t";
-	  freeze_out << (sy-Middle+0.5)/fmtoGeV*AT << "\t";
-	  freeze_out << t/fmtoGeV*AT << "\t";
-	  freeze_out << direction << "\t";
-	  freeze_out << 0.5 * (u[0][sx][sy] + u[0][sx][sy+1]) << "\t";
-	  freeze_out << 0.5 * (u[1][sx][sy] + u[1][sx][sy+1]) << "\t";
-	  freeze_out << 0.5 * (pixx[sx][sy]/(e[sx][sy]+eos(e[sx][sy],pacc,cs2acc)) 
-			      + pixx[sx][sy+1]/(e[sx][sy+1]+eos(e[sx][sy+1],pacc,cs2acc))) << "\t";
-	  freeze_out << 0.5 * (pixy[sx][sy]/(e[sx][sy]+eos(e[sx][sy],pacc,cs2acc)) 
-			      + pixy[sx][sy+1]/(e[sx][sy+1]+eos(e[sx][sy+1],pacc,cs2acc)) ) << "\t";
-	  freeze_out << 0.5 * (piyy[sx][sy]/(e[sx][sy]+eos(e[sx][sy],pacc,cs2acc))
-			      + piyy[sx][sy+1]/(e[sx][sy+1]+eos(e[sx][sy+1],pacc,cs2acc)))<< "\t";
-	  freeze_out << 0.5 * (pib[sx][sy]/(e[sx][sy]+eos(e[sx][sy],pacc,cs2acc)) 
-			      + pib[sx][sy+1]/(e[sx][sy+1]+eos(e[sx][sy+1],pacc,cs2acc)) ) << "\t";
-	  freeze_out << 0.5 * (T(sx,sy,Tacc) + T(sx,sy+1,Tacc))/AT << "\n";
+	  double rec[FO_FIELDS]={(sx-Middle)/fmtoGeV*AT,(sy-Middle+0.5)/fmtoGeV*AT,t/fmtoGeV*AT,(double)direction,
+				 0.5 * (u[0][sx][sy] + u[0][sx][sy+1]),
+				 0.5 * (u[1][sx][sy] + u[1][sx][sy+1]),
+				 0.5 * (pixx[sx][sy]/(e[sx][sy]+eos(e[sx][sy],pacc,cs2acc)) 
+					+ pixx[sx][sy+1]/(e[sx][sy+1]+eos(e[sx][sy+1],pacc,cs2acc))),
+				 0.5 * (pixy[sx][sy]/(e[sx][sy]+eos(e[sx][sy],pacc,cs2acc)) 
+					+ pixy[sx][sy+1]/(e[sx][sy+1]+eos(e[sx][sy+1],pacc,cs2acc))),
+				 0.5 * (piyy[sx][sy]/(e[sx][sy]+eos(e[sx][sy],pacc,cs2acc))
+					+ piyy[sx][sy+1]/(e[sx][sy+1]+eos(e[sx][sy+1],pacc,cs2acc))),
+				 0.5 * (pib[sx][sy]/(e[sx][sy]+eos(e[sx][sy],pacc,cs2acc)) 
+					+ pib[sx][sy+1]/(e[sx][sy+1]+eos(e[sx][sy+1],pacc,cs2acc))),
+				 0.5 * (T(sx,sy,Tacc) + T(sx,sy+1,Tacc))/AT};
+	  blockfound(rec);
 	}
       }
       if (sx != NUMT)
@@ -737,21 +768,19 @@ void blockfreeze(gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_interp_acce
 	  reachedTf = 0;
 	  int direction = 1;
 	  if ((T(sx,sy,Tacc) <= TF) && (T(sx+1,sy,Tacc) > TF)) direction = -1;
-	  freeze_out << (sx-Middle+0.5)/fmtoGeV*AT << "\t";
-	  freeze_out << (sy-Middle)/fmtoGeV*AT << "\t";
-	  freeze_out << t/fmtoGeV*AT << "\t";
-	  freeze_out << direction << "\t";
-	  freeze_out << 0.5 * (u[0][sx][sy] + u[0][sx+1][sy]) << "\t";
-	  freeze_out << 0.5 * (u[1][sx][sy] + u[1][sx+1][sy]) << "\t";
-	  freeze_out << 0.5 * (pixx[sx][sy]/(e[sx][sy]+eos(e[sx][sy],pacc,cs2acc)) 
-			      + pixx[sx+1][sy]/(e[sx+1][sy]+eos(e[sx+1][sy],pacc,cs2acc))) << "\t";
-	  freeze_out << 0.5 * (pixy[sx][sy]/(e[sx][sy]+eos(e[sx][sy],pacc,cs2acc)) 
-			      + pixy[sx+1][sy]/(e[sx+1][sy]+eos(e[sx+1][sy],pacc,cs2acc)) ) << "\t";
-	  freeze_out << 0.5 * (piyy[sx][sy]/(e[sx][sy]+eos(e[sx][sy],pacc,cs2acc))
-			      + piyy[sx+1][sy]/(e[sx+1][sy]+eos(e[sx+1][sy],pacc,cs2acc)))<< "\t";
-	  freeze_out << 0.5 * (pib[sx][sy]/(e[sx][sy]+eos(e[sx][sy],pacc,cs2acc))
-			      + pib[sx+1][sy]/(e[sx+1][sy]+eos(e[sx+1][sy],pacc,cs2acc)))<< "\t";
-	  freeze_out << 0.5 * (T(sx,sy,Tacc) + T(sx+1,sy,Tacc))/AT << "\n";
+	  double rec[FO_FIELDS]={(sx-Middle+0.5)/fmtoGeV*AT,(sy-Middle)/fmtoGeV*AT,t/fmtoGeV*AT,(double)direction,
+				 0.5 * (u[0][sx][sy] + u[0][sx+1][sy]),
+				 0.5 * (u[1][sx][sy] + u[1][sx+1][sy]),
+				 0.5 * (pixx[sx][sy]/(e[sx][sy]+eos(e[sx][sy],pacc,cs2acc)) 
+					+ pixx[sx+1][sy]/(e[sx+1][sy]+eos(e[sx+1][sy],pacc,cs2acc))),
+				 0.5 * (pixy[sx][sy]/(e[sx][sy]+eos(e[sx][sy],pacc,cs2acc)) 
+					+ pixy[sx+1][sy]/(e[sx+1][sy]+eos(e[sx+1][sy],pacc,cs2acc))),
+				 0.5 * (piyy[sx][sy]/(e[sx][sy]+eos(e[sx][sy],pacc,cs2acc))
+					+ piyy[sx+1][sy]/(e[sx+1][sy]+eos(e[sx+1][sy],pacc,cs2acc))),
+				 0.5 * (pib[sx][sy]/(e[sx][sy]+eos(e[sx][sy],pacc,cs2acc))
+					+ pib[sx+1][sy]/(e[sx+1][sy]+eos(e[sx+1][sy],pacc,cs2acc))),
+				 0.5 * (T(sx,sy,Tacc) + T(sx+1,sy,Tacc))/AT};
+	  blockfound(rec);
 	}
       }
 
@@ -761,28 +790,26 @@ void blockfreeze(gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_interp_acce
 	{
 	  int direction = 3;
 	  if ((T(sx,sy,Tacc) > TF) && (Tlast(sx,sy,Tacc) <= TF)) direction = -3;
-	  freeze_out << (sx-Middle)/fmtoGeV*AT << "\t";
-	  freeze_out << (sy-Middle)/fmtoGeV*AT << "\t";
-	  freeze_out << t/fmtoGeV*AT - 0.5 * UPDATE*EPS*AT/fmtoGeV << "\t";
-	  freeze_out << direction << "\t";
-	  freeze_out << 0.5 * (u[0][sx][sy] + ulast[0][sx][sy]) << "\t";
-	  freeze_out << 0.5 * (u[1][sx][sy] + ulast[1][sx][sy]) << "\t";
-	  freeze_out << 0.5 * (pixx[sx][sy]/(e[sx][sy]+eos(e[sx][sy],pacc,cs2acc)) 	
-			      + pixxlast[sx][sy]/(elast[sx][sy]+eos(elast[sx][sy],pacc,cs2acc))) << "\t";
-	  freeze_out << 0.5 * (pixy[sx][sy]/(e[sx][sy]+eos(e[sx][sy],pacc,cs2acc)) 
-			      + pixylast[sx][sy]/(elast[sx][sy]+eos(elast[sx][sy],pacc,cs2acc)) ) << "\t";
-	  freeze_out << 0.5 * (piyy[sx][sy]/(e[sx][sy]+eos(e[sx][sy],pacc,cs2acc))
-			      + piyylast[sx][sy]/(elast[sx][sy]+eos(elast[sx][sy],pacc,cs2acc)))<< "\t";
-	  freeze_out << 0.5 * (pib[sx][sy]/(e[sx][sy]+eos(e[sx][sy],pacc,cs2acc))
-			      + pilast[sx][sy]/(elast[sx][sy]+eos(elast[sx][sy],pacc,cs2acc)))<< "\t";
-	  freeze_out << 0.5 * (T(sx,sy,Tacc) + Tlast(sx,sy,Tacc))/AT << "\n";
+	  double rec[FO_FIELDS]={(sx-Middle)/fmtoGeV*AT,(sy-Middle)/fmtoGeV*AT,t/fmtoGeV*AT - 0.5 * UPDATE*EPS*AT/fmtoGeV,(double)direction,
+				 0.5 * (u[0][sx][sy] + ulast[0][sx][sy]),
+				 0.5 * (u[1][sx][sy] + ulast[1][sx][sy]),
+				 0.5 * (pixx[sx][sy]/(e[sx][sy]+eos(e[sx][sy],pacc,cs2acc)) 	
+					+ pixxlast[sx][sy]/(elast[sx][sy]+eos(elast[sx][sy],pacc,cs2acc))),
+				 0.5 * (pixy[sx][sy]/(e[sx][sy]+eos(e[sx][sy],pacc,cs2acc)) 
+					+ pixylast[sx][sy]/(elast[sx][sy]+eos(elast[sx][sy],pacc,cs2acc))),
+				 0.5 * (piyy[sx][sy]/(e[sx][sy]+eos(e[sx][sy],pacc,cs2acc))
+					+ piyylast[sx][sy]/(elast[sx][sy]+eos(elast[sx][sy],pacc,cs2acc))),
+				 0.5 * (pib[sx][sy]/(e[sx][sy]+eos(e[sx][sy],pacc,cs2acc))
+					+ pilast[sx][sy]/(elast[sx][sy]+eos(elast[sx][sy],pacc,cs2acc))),
+				 0.5 * (T(sx,sy,Tacc) + Tlast(sx,sy,Tacc))/AT};
+	  blockfound(rec);
 	}
       }
     }
   }
 }
 
-void outputMeasurements(double t,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_interp_accel *Tacc) 
+void vh2solver::outputMeasurements(double t,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_interp_accel *Tacc) 
 {
   cout.precision(5);
   int dwidth = 13;
@@ -860,11 +887,11 @@ void outputMeasurements(double t,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc
   }
 }
 
-void snapTprofile(double time,gsl_interp_accel *Tacc)
+void vh2solver::snapTprofile(double time,gsl_interp_accel *Tacc)
 {
   fstream out;
-  char fname[255];
-  sprintf(fname,"data/snapshot/Tprofile_%.2f.dat",time/fmtoGeV*AT);
+  char fname[512];
+  snprintf(fname,sizeof(fname),"%sdata/snapshot/Tprofile_%.2f.dat",RUNDIR,time/fmtoGeV*AT);
   out.open(fname, ios::out);
   for (int s=Middle;s<=NUMT;s++)
   {
@@ -876,11 +903,11 @@ void snapTprofile(double time,gsl_interp_accel *Tacc)
   out.close();
 }
 
-void snapEDprofile(double time)
+void vh2solver::snapEDprofile(double time)
 {
   fstream out;
-  char fname[255];
-  sprintf(fname,"data/snapshot/EDprofile_%.2f.dat",time/fmtoGeV*AT);
+  char fname[512];
+  snprintf(fname,sizeof(fname),"%sdata/snapshot/EDprofile_%.2f.dat",RUNDIR,time/fmtoGeV*AT);
   out.open(fname, ios::out);
   for (int s=Middle;s<=NUMT;s++)
   {
@@ -891,11 +918,11 @@ void snapEDprofile(double time)
   out.close();
 }
 
-void snapTcontour(double time,gsl_interp_accel *Tacc)
+void vh2solver::snapTcontour(double time,gsl_interp_accel *Tacc)
 {
   fstream out;
-  char fname[255];
-  sprintf(fname,"data/snapshot/Tcontour_%.3f.dat",time/fmtoGeV*AT);
+  char fname[512];
+  snprintf(fname,sizeof(fname),"%sdata/snapshot/Tcontour_%.3f.dat",RUNDIR,time/fmtoGeV*AT);
   out.open(fname, ios::out);
 
    out << "#x [fm] \t y [fm] \t T [GeV] \n";
@@ -916,11 +943,11 @@ void snapTcontour(double time,gsl_interp_accel *Tacc)
   out.close();
 }
 
-void snapVcontour(double time)
+void vh2solver::snapVcontour(double time)
 {
   fstream out;
-  char fname[255];
-  sprintf(fname,"data/snapshot/Vcontour_%.3f.dat",time/fmtoGeV*AT);
+  char fname[512];
+  snprintf(fname,sizeof(fname),"%sdata/snapshot/Vcontour_%.3f.dat",RUNDIR,time/fmtoGeV*AT);
   out.open(fname, ios::out);
   out << "#x [fm] \t y [fm] \t ux \t uy \t gamma \n";
   for (int sy=1;sy<=NUMT;sy++)
@@ -939,11 +966,11 @@ void snapVcontour(double time)
   out.close();
 }
 
-void snapFOdata(double time,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc)
+void vh2solver::snapFOdata(double time,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc)
 {
   fstream out;
-  char fname[255];
-  sprintf(fname,"data/snapshot/FOdata_%.3f.dat",time/fmtoGeV*AT);
+  char fname[512];
+  snprintf(fname,sizeof(fname),"%sdata/snapshot/FOdata_%.3f.dat",RUNDIR,time/fmtoGeV*AT);
   out.open(fname, ios::out);
   for (int sy=1;sy<=NUMT;sy++)
     {
@@ -964,11 +991,11 @@ void snapFOdata(double time,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc)
   meta << fname << "\n";
 }
 
-void snapVprofile(double time)
+void vh2solver::snapVprofile(double time)
 {
   fstream out;
-  char fname[255];
-  sprintf(fname,"data/snapshot/Vprofile_%.2f.dat",time/fmtoGeV*AT);
+  char fname[512];
+  snprintf(fname,sizeof(fname),"%sdata/snapshot/Vprofile_%.2f.dat",RUNDIR,time/fmtoGeV*AT);
   out.open(fname, ios::out);
   for (int s=Middle;s<=NUMT;s++)
   {
@@ -980,11 +1007,11 @@ void snapVprofile(double time)
   out.close();
 }
 
-void snapVxprofile(double time)
+void vh2solver::snapVxprofile(double time)
 {
   fstream out;
-  char fname[255];
-  sprintf(fname,"data/snapshot/Vxprofile_%.2f.dat",time/fmtoGeV*AT);
+  char fname[512];
+  snprintf(fname,sizeof(fname),"%sdata/snapshot/Vxprofile_%.2f.dat",RUNDIR,time/fmtoGeV*AT);
   out.open(fname, ios::out);
   for (int s=Middle;s<=NUMT;s++)
   {
@@ -996,11 +1023,11 @@ void snapVxprofile(double time)
   out.close();
 }
 
-void snapV2profile(double time)
+void vh2solver::snapV2profile(double time)
 {
   fstream out;
-  char fname[255];
-  sprintf(fname,"data/snapshot/V2profile_%.2f.dat",time/fmtoGeV*AT);
+  char fname[512];
+  snprintf(fname,sizeof(fname),"%sdata/snapshot/V2profile_%.2f.dat",RUNDIR,time/fmtoGeV*AT);
   out.open(fname, ios::out);
   for (int s=0;s<NUMT/2./sqrt(2.);s++)
   {
@@ -1012,12 +1039,12 @@ void snapV2profile(double time)
   out.close();
 }
 
-void snappieeprofile(double time)
+void vh2solver::snappieeprofile(double time)
 {
   fstream out;
-  char fname[255];
+  char fname[512];
   double vr=0;
-  sprintf(fname,"data/snapshot/Piprofile_%.2f.dat",time/fmtoGeV*AT);
+  snprintf(fname,sizeof(fname),"%sdata/snapshot/Piprofile_%.2f.dat",RUNDIR,time/fmtoGeV*AT);
   out.open(fname, ios::out);
   for (int s=Middle;s<=NUMT;s++)
   {
@@ -1029,12 +1056,12 @@ void snappieeprofile(double time)
   out.close();
 }
 
-void snappirrprofile(double time)
+void vh2solver::snappirrprofile(double time)
 {
   fstream out;
-  char fname[255];
+  char fname[512];
   double vr=0;
-  sprintf(fname,"data/snapshot/PiRprofile_%.2f.dat",time/fmtoGeV*AT);
+  snprintf(fname,sizeof(fname),"%sdata/snapshot/PiRprofile_%.2f.dat",RUNDIR,time/fmtoGeV*AT);
   out.open(fname, ios::out);
   for (int s=Middle;s<=NUMT;s++)
   {
@@ -1046,12 +1073,12 @@ void snappirrprofile(double time)
   out.close();
 }
 
-void snappibulkprofile(double time)
+void vh2solver::snappibulkprofile(double time)
 {
   fstream out;
-  char fname[255];
+  char fname[512];
   double vr=0;
-  sprintf(fname,"data/snapshot/PiBulkprofile_%.2f.dat",time/fmtoGeV*AT);
+  snprintf(fname,sizeof(fname),"%sdata/snapshot/PiBulkprofile_%.2f.dat",RUNDIR,time/fmtoGeV*AT);
   out.open(fname, ios::out);
   for (int s=Middle;s<=NUMT;s++)
   {
@@ -1064,11 +1091,11 @@ void snappibulkprofile(double time)
 }
 
 
-void snapuphiprofile(double time)
+void vh2solver::snapuphiprofile(double time)
 {
   fstream out;
-  char fname[255];
-  sprintf(fname,"data/snapshot/uphiprofile_%.2f.dat",time/fmtoGeV*AT);
+  char fname[512];
+  snprintf(fname,sizeof(fname),"%sdata/snapshot/uphiprofile_%.2f.dat",RUNDIR,time/fmtoGeV*AT);
   out.open(fname, ios::out);
   for (int s=Middle;s<=NUMT;s++)
   {
@@ -1082,7 +1109,7 @@ void snapuphiprofile(double time)
 
 
 #ifdef BG
-void betzgyulassy(double tt,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_interp_accel *Tacc)
+void vh2solver::betzgyulassy(double tt,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_interp_accel *Tacc)
 {
   for (int sy=1;sy<=NUMT;sy++)
     {
@@ -1110,11 +1137,11 @@ void betzgyulassy(double tt,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_
 #endif
 
 #ifdef AMNR
-void amnr(double tt,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_interp_accel *Tacc)
+void vh2solver::amnr(double tt,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_interp_accel *Tacc)
 {
   fstream out;
-  char fname[255];
-  sprintf(fname,"data/snapshot/Tdata_%05.2f.dat",tt/fmtoGeV*AT);
+  char fname[512];
+  snprintf(fname,sizeof(fname),"%sdata/snapshot/Tdata_%05.2f.dat",RUNDIR,tt/fmtoGeV*AT);
   out.open(fname, ios::out);
 
   for (int sy=1;sy<=NUMT;sy++)
@@ -1130,7 +1157,7 @@ void amnr(double tt,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_interp_a
   out.close();
 
   fstream fout;
-  sprintf(fname,"data/snapshot/FOdata_%05.2f.dat",tt/fmtoGeV*AT);
+  snprintf(fname,sizeof(fname),"%sdata/snapshot/FOdata_%05.2f.dat",RUNDIR,tt/fmtoGeV*AT);
   fout.open(fname, ios::out);
 
   for (int sy=1;sy<=NUMT;sy++)
@@ -1151,7 +1178,7 @@ void amnr(double tt,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_interp_a
 #endif
 
 
-void snapshot(double tt,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_interp_accel *Tacc)
+void vh2solver::snapshot(double tt,gsl_interp_accel *pacc,gsl_interp_accel *cs2acc,gsl_interp_accel *Tacc)
 {
   double hel2[4];
   double dt[4];
@@ -8,6 +8,7 @@
 #include <gsl/gsl_spline.h>
 #include <gsl/gsl_fft_real.h>
 #include <gsl/gsl_fft_halfcomplex.h>
+#include "harmonics.h"
 
 using namespace std;
 
@@ -101,15 +102,19 @@ void doall()
   double resbuff[PTASIZE][4*PHIPASIZE];
   double CHbuff[PTASIZE][4*PHIPASIZE];
 
-  double workhorsearr[4*PHIPASIZE+1];
-  double workhorse[4*PHIPASIZE+1];
+  double harmbuff[PTASIZE][4*PHIPASIZE];
 
-  gsl_fft_real_wavetable * real;
-  gsl_fft_halfcomplex_wavetable * hc;
-  gsl_fft_real_workspace * work;
-
-  gsl_spline * workspline1=gsl_spline_alloc (gsl_interp_cspline_periodic, 4*PHIPASIZE+1);
-  gsl_interp_accel * workacc1=gsl_interp_accel_alloc ();
+  //angles of the spectra mirrored into the full period (see below)
+  double phinodes[4*PHIPASIZE];
+  for (int k=0;k<PHIPASIZE;k++)
+    {
+      phinodes[k]=phiparray[k];
+      phinodes[2*PHIPASIZE-k-1]=M_PI-phiparray[k];
+      phinodes[2*PHIPASIZE+k]=M_PI+phiparray[k];
+      phinodes[4*PHIPASIZE-k-1]=-phiparray[k]+2*M_PI;
+    }
+  //spline+FFT of the spectra, tabulated once for all species
+  harmonics phikernel(phinodes,4*PHIPASIZE);
 
   //pions
 
@@ -117,7 +122,6 @@ void doall()
   for (int k=0;k<PHIPASIZE;k++)
     for (int j=0;j<PTASIZE;j++)
       {
-	workhorsearr[k]=phiparray[k];
 	pispec >> resbuff[j][k];
 	CHbuff[j][k]=resbuff[j][k];
 	//cout << "rb: " << resbuff[j][k] << endl;
@@ -126,65 +130,28 @@ void doall()
   for (int j=0;j<PTASIZE;j++)
     for (int k=0;k<PHIPASIZE;k++)
       {
-	workhorsearr[4*PHIPASIZE-k-1]=-phiparray[k]+2*M_PI;
 	resbuff[j][4*PHIPASIZE-k-1]=resbuff[j][k];
       }
   for (int j=0;j<PTASIZE;j++)
     for (int k=0;k<PHIPASIZE;k++)
       {
-	workhorsearr[2*PHIPASIZE-k-1]=M_PI-phiparray[k];
 	resbuff[j][2*PHIPASIZE-k-1]=resbuff[j][k];
 	resbuff[j][2*PHIPASIZE+k]=resbuff[j][4*PHIPASIZE-k-1];
-	workhorsearr[2*PHIPASIZE+k]=M_PI+phiparray[k];
       }
 
   
 
-  work = gsl_fft_real_workspace_alloc (4*PHIPASIZE);
-  real = gsl_fft_real_wavetable_alloc (4*PHIPASIZE);
-  hc = gsl_fft_halfcomplex_wavetable_alloc (4*PHIPASIZE);    
   //first set
   
   
 
+#pragma omp parallel for
   for (int j=0;j<PTASIZE;j++)
-    {
-      for (int k=0;k<4*PHIPASIZE;k++)
-	{
-	  //workhorse[k]=10*cos(2*(2*M_PI/4/PHIPASIZE*k-M_PI));
-	  //workhorse[k]=10;
-	  //workhorsearr[k]=2*M_PI/4/PHIPASIZE*k-M_PI;
-	  workhorse[k]=resbuff[j][k];
-	}
+    phikernel.apply(resbuff[j],harmbuff[j]);
 
-      
-      workhorsearr[4*PHIPASIZE]=phiparray[0]+2*M_PI;
-      workhorse[4*PHIPASIZE]=workhorse[0];
-      
-      
-      gsl_spline_init (workspline1, workhorsearr, workhorse, 4*PHIPASIZE+1);
-
-      if (j==0)
-       for (int k=0;k<4*PHIPASIZE;k++)
-	{
-	  //printf("{%f,%f},",workhorsearr[k],workhorse[k]);
-	  //printf("{%f,%f},",workhorsearr[k],gsl_spline_eval(workspline1,workhorsearr[k],workacc1));
-	}
-
-      for (int k=0;k<4*PHIPASIZE;k++)
-	{
-	  double xx=2*M_PI/4/PHIPASIZE*k;
-	  if (xx<workhorsearr[0])
-	    xx+=2*M_PI;
-	  workhorse[k]=gsl_spline_eval(workspline1,xx,workacc1);
-	  if (j==0)
-	  {
-	    //printf("%f wh %f\n",2*M_PI/4/PHIPASIZE*k-M_PI,workhorse[k]);
-	    //printf("{%f,%f},",2*M_PI/4/PHIPASIZE*k,workhorse[k]);
-	  }
-	}
-      //printf("pt %f wh %f\n",ptarray[j],workhorse[0]);
-      gsl_fft_real_transform (workhorse,1 ,4*PHIPASIZE, real, work);
+  for (int j=0;j<PTASIZE;j++)
+    {
+      const double *workhorse=harmbuff[j];
       
 
       respiv0 << ptarray[j] << "\t";
@@ -204,7 +171,6 @@ void doall()
   for (int k=0;k<PHIPASIZE;k++)
     for (int j=0;j<PTASIZE;j++)
       {
-	workhorsearr[k]=phiparray[k];
 	Kspec >> resbuff[j][k];
 	CHbuff[j][k]+=resbuff[j][k];
       }
@@ -212,41 +178,24 @@ void doall()
   for (int j=0;j<PTASIZE;j++)
     for (int k=0;k<PHIPASIZE;k++)
       {
-	workhorsearr[4*PHIPASIZE-k-1]=-phiparray[k]+2*M_PI;
 	resbuff[j][4*PHIPASIZE-k-1]=resbuff[j][k];
       }
   for (int j=0;j<PTASIZE;j++)
     for (int k=0;k<PHIPASIZE;k++)
       {
-	workhorsearr[2*PHIPASIZE-k-1]=M_PI-phiparray[k];
 	resbuff[j][2*PHIPASIZE-k-1]=resbuff[j][k];
 	resbuff[j][2*PHIPASIZE+k]=resbuff[j][4*PHIPASIZE-k-1];
-	workhorsearr[2*PHIPASIZE+k]=M_PI+phiparray[k];
       }
 
   
 
+#pragma omp parallel for
   for (int j=0;j<PTASIZE;j++)
-    {
-      for (int k=0;k<4*PHIPASIZE;k++)
-	workhorse[k]=resbuff[j][k];
-      
-      workhorsearr[4*PHIPASIZE]=phiparray[0]+2*M_PI;
-      workhorse[4*PHIPASIZE]=workhorse[0];
-      
-      
-      gsl_spline_init (workspline1, workhorsearr, workhorse, 4*PHIPASIZE+1);
-
-      for (int k=0;k<4*PHIPASIZE;k++)
-	{
-	 double xx=2*M_PI/4/PHIPASIZE*k;
-	  if (xx<workhorsearr[0])
-	    xx+=2*M_PI; 
-	  workhorse[k]=gsl_spline_eval(workspline1,xx,workacc1);
-	}
-
+    phikernel.apply(resbuff[j],harmbuff[j]);
 
-      gsl_fft_real_transform (workhorse,1 ,4*PHIPASIZE, real, work);
+  for (int j=0;j<PTASIZE;j++)
+    {
+      const double *workhorse=harmbuff[j];
       
       for (int k=0;k<4*PHIPASIZE;k++)
 	{
@@ -272,7 +221,6 @@ void doall()
   for (int k=0;k<PHIPASIZE;k++)
     for (int j=0;j<PTASIZE;j++)
       {
-	workhorsearr[k]=phiparray[k];
 	pspec >> resbuff[j][k];
 	CHbuff[j][k]+=resbuff[j][k];
       }
@@ -280,41 +228,24 @@ void doall()
   for (int j=0;j<PTASIZE;j++)
     for (int k=0;k<PHIPASIZE;k++)
       {
-	workhorsearr[4*PHIPASIZE-k-1]=-phiparray[k]+2*M_PI;
 	resbuff[j][4*PHIPASIZE-k-1]=resbuff[j][k];
       }
   for (int j=0;j<PTASIZE;j++)
     for (int k=0;k<PHIPASIZE;k++)
       {
-	workhorsearr[2*PHIPASIZE-k-1]=M_PI-phiparray[k];
 	resbuff[j][2*PHIPASIZE-k-1]=resbuff[j][k];
 	resbuff[j][2*PHIPASIZE+k]=resbuff[j][4*PHIPASIZE-k-1];
-	workhorsearr[2*PHIPASIZE+k]=M_PI+phiparray[k];
       }
 
   
 
+#pragma omp parallel for
   for (int j=0;j<PTASIZE;j++)
-    {
-      for (int k=0;k<4*PHIPASIZE;k++)
-	workhorse[k]=resbuff[j][k];
-      
-      workhorsearr[4*PHIPASIZE]=phiparray[0]+2*M_PI;
-      workhorse[4*PHIPASIZE]=workhorse[0];
-      
-      
-      gsl_spline_init (workspline1, workhorsearr, workhorse, 4*PHIPASIZE+1);
+    phikernel.apply(resbuff[j],harmbuff[j]);
 
-      for (int k=0;k<4*PHIPASIZE;k++)
-	{
-	  double xx=2*M_PI/4/PHIPASIZE*k;
-	  if (xx<workhorsearr[0])
-	    xx+=2*M_PI;
-	  workhorse[k]=gsl_spline_eval(workspline1,xx,workacc1);
-	}
-
-
-      gsl_fft_real_transform (workhorse,1 ,4*PHIPASIZE, real, work);
+  for (int j=0;j<PTASIZE;j++)
+    {
+      const double *workhorse=harmbuff[j];
       
       respv0 << ptarray[j] << "\t";
       respv0 << workhorse[0]/4/PHIPASIZE;
@@ -335,41 +266,24 @@ void doall()
   for (int j=0;j<PTASIZE;j++)
     for (int k=0;k<PHIPASIZE;k++)
       {
-	workhorsearr[4*PHIPASIZE-k-1]=-phiparray[k]+2*M_PI;
 	CHbuff[j][4*PHIPASIZE-k-1]=CHbuff[j][k];
       }
   for (int j=0;j<PTASIZE;j++)
     for (int k=0;k<PHIPASIZE;k++)
       {
-	workhorsearr[2*PHIPASIZE-k-1]=M_PI-phiparray[k];
 	CHbuff[j][2*PHIPASIZE-k-1]=CHbuff[j][k];
 	CHbuff[j][2*PHIPASIZE+k]=CHbuff[j][4*PHIPASIZE-k-1];
-	workhorsearr[2*PHIPASIZE+k]=M_PI+phiparray[k];
       }
 
   
 
+#pragma omp parallel for
   for (int j=0;j<PTASIZE;j++)
-    {
-      for (int k=0;k<4*PHIPASIZE;k++)
-	workhorse[k]=CHbuff[j][k];
-      
-      workhorsearr[4*PHIPASIZE]=phiparray[0]+2*M_PI;
-      workhorse[4*PHIPASIZE]=workhorse[0];
-      
-      
-      gsl_spline_init (workspline1, workhorsearr, workhorse, 4*PHIPASIZE+1);
-
-      for (int k=0;k<4*PHIPASIZE;k++)
-	{
-	  double xx=2*M_PI/4/PHIPASIZE*k;
-	  if (xx<workhorsearr[0])
-	    xx+=2*M_PI;
-	  workhorse[k]=gsl_spline_eval(workspline1,xx,workacc1);
-	}
+    phikernel.apply(CHbuff[j],harmbuff[j]);
 
-
-      gsl_fft_real_transform (workhorse,1 ,4*PHIPASIZE, real, work);
+  for (int j=0;j<PTASIZE;j++)
+    {
+      const double *workhorse=harmbuff[j];
       
       for (int k=0;k<4*PHIPASIZE;k++)
 	{
@@ -391,15 +305,6 @@ void doall()
 
 
 
-
-  gsl_spline_free (workspline1);
-  gsl_interp_accel_free (workacc1);
-  
-
-  gsl_fft_halfcomplex_wavetable_free (hc);
-  gsl_fft_real_wavetable_free (real);
-  gsl_fft_real_workspace_free (work);
-
   
 }
 
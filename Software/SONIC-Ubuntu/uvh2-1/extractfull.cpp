@@ -8,6 +8,7 @@
 #include <gsl/gsl_spline.h>
 #include <gsl/gsl_fft_real.h>
 #include <gsl/gsl_fft_halfcomplex.h>
+#include "harmonics.h"
 
 using namespace std;
 
@@ -91,17 +92,13 @@ void doall()
   double resbuff[PTASIZE][4*PHIPASIZE];
   double CHbuff[PTASIZE][4*PHIPASIZE];
 
-  double workhorsearr[4*PHIPASIZE+1];
-  double workhorse[4*PHIPASIZE+1];
+  double harmbuff[PTASIZE][4*PHIPASIZE];
 //   double workhorseangle[4*PHIPASIZE+1];
 //   double workhorsequadangle[4*PHIPASIZE+1];
 
-  gsl_fft_real_wavetable * real;
-  gsl_fft_halfcomplex_wavetable * hc;
-  gsl_fft_real_workspace * work;
-
-  gsl_spline * workspline1=gsl_spline_alloc (gsl_interp_cspline_periodic, 4*PHIPASIZE+1);
-  gsl_interp_accel * workacc1=gsl_interp_accel_alloc ();
+  //spline+FFT of the spectra, tabulated once; pions are not rotated
+  harmonics phikernel(phiparray,4*PHIPASIZE);
+  harmonics trikernel(phiparray,4*PHIPASIZE,TRIANGLE);
 
   //pions
 
@@ -109,7 +106,6 @@ void doall()
   for (int k=0;k<4*PHIPASIZE;k++)
     for (int j=0;j<PTASIZE;j++)
       {
-	workhorsearr[k]=phiparray[k];
 	if(FULL || k<PHIPASIZE)
 	{
 	  pispec >> resbuff[j][k];
@@ -141,57 +137,17 @@ if(!FULL)
 
   
 
-  work = gsl_fft_real_workspace_alloc (4*PHIPASIZE);
-  real = gsl_fft_real_wavetable_alloc (4*PHIPASIZE);
-  hc = gsl_fft_halfcomplex_wavetable_alloc (4*PHIPASIZE);    
   //first set
   
   
 
+#pragma omp parallel for
   for (int j=0;j<PTASIZE;j++)
-    {
-      for (int k=0;k<4*PHIPASIZE;k++)
-	{
-	  //workhorse[k]=10*cos(2*(2*M_PI/4/PHIPASIZE*k-M_PI));
-	  //workhorse[k]=10;
-	  //workhorsearr[k]=2*M_PI/4/PHIPASIZE*k-M_PI;
-	  workhorse[k]=resbuff[j][k];
-	}
+    phikernel.apply(resbuff[j],harmbuff[j]);
 
-      
-      workhorsearr[4*PHIPASIZE]=phiparray[0]+2*M_PI;
-      workhorse[4*PHIPASIZE]=workhorse[0];
-      
-      
-      gsl_spline_init (workspline1, workhorsearr, workhorse, 4*PHIPASIZE+1);
-      
-
-      if (j==0)
-       for (int k=0;k<4*PHIPASIZE;k++)
-	{
-	  //printf("{%f,%f},",workhorsearr[k],workhorse[k]);
-	  //printf("{%f,%f},",workhorsearr[k],gsl_spline_eval(workspline1,workhorsearr[k],workacc1));
-	}
-
-      for (int k=0;k<4*PHIPASIZE;k++)
-      {
-// 	double angle = 2*M_PI/4/PHIPASIZE*k + TRIANGLE;
-// 	double ang;
-// 	if (angle < 2*M_PI) ang = angle;
-// 	else ang = angle - 2*M_PI;
-// 	double angle4 = 2*M_PI/4/PHIPASIZE*k + QUADANGLE;
-// 	double ang4;
-// 	if (angle4 < 2*M_PI) ang4 = angle4;
-// 	else ang4 = angle4 - 2*M_PI;
-	workhorse[k]=gsl_spline_eval(workspline1,2*M_PI/4/PHIPASIZE*k,workacc1);
-// 	workhorseangle[k]=gsl_spline_eval(workspline1,ang,workacc1);
-// 	workhorsequadangle[k]=gsl_spline_eval(workspline1,ang4,workacc1);
-      }
-
-      //printf("pt %f wh %f\n",ptarray[j],workhorse[0]);
-      gsl_fft_real_transform (workhorse,1 ,4*PHIPASIZE, real, work);
-//       gsl_fft_real_transform (workhorseangle,1 ,4*PHIPASIZE, real, work);
-//       gsl_fft_real_transform (workhorsequadangle,1 ,4*PHIPASIZE, real, work);
+  for (int j=0;j<PTASIZE;j++)
+    {
+      const double *workhorse=harmbuff[j];
       
 
       respiv0 << ptarray[j] << "\t";
@@ -236,7 +192,6 @@ if(!FULL)
   for (int k=0;k<4*PHIPASIZE;k++)
     for (int j=0;j<PTASIZE;j++)
       {
-	workhorsearr[k]=phiparray[k];
 	if(FULL || k<PHIPASIZE)
 	{
 	  Kspec >> resbuff[j][k];
@@ -266,27 +221,13 @@ if(!FULL)
 
   
 
+#pragma omp parallel for
   for (int j=0;j<PTASIZE;j++)
-    {
-      for (int k=0;k<4*PHIPASIZE;k++)
-	workhorse[k]=resbuff[j][k];
-      
-      workhorsearr[4*PHIPASIZE]=phiparray[0]+2*M_PI;
-      workhorse[4*PHIPASIZE]=workhorse[0];
-      
-      
-      gsl_spline_init (workspline1, workhorsearr, workhorse, 4*PHIPASIZE+1);
+    trikernel.apply(resbuff[j],harmbuff[j]);
 
-      for (int k=0;k<4*PHIPASIZE;k++)
-      {
-	double angle = 2*M_PI/4/PHIPASIZE*k + TRIANGLE;
-	double ang;
-	if (angle < 2*M_PI) ang = angle;
-	else ang = angle - 2*M_PI;
-	workhorse[k]=gsl_spline_eval(workspline1,ang,workacc1);
-      }
-
-      gsl_fft_real_transform (workhorse,1 ,4*PHIPASIZE, real, work);
+  for (int j=0;j<PTASIZE;j++)
+    {
+      const double *workhorse=harmbuff[j];
       
       for (int k=0;k<4*PHIPASIZE;k++)
 	{
@@ -327,7 +268,6 @@ if(!FULL)
   for (int k=0;k<4*PHIPASIZE;k++)
     for (int j=0;j<PTASIZE;j++)
       {
-	workhorsearr[k]=phiparray[k];
 	if(FULL || k<PHIPASIZE)
 	{
 	  pspec >> resbuff[j][k];
@@ -357,28 +297,13 @@ if(!FULL)
 
   
 
+#pragma omp parallel for
   for (int j=0;j<PTASIZE;j++)
-    {
-      for (int k=0;k<4*PHIPASIZE;k++)
-	workhorse[k]=resbuff[j][k];
-      
-      workhorsearr[4*PHIPASIZE]=phiparray[0]+2*M_PI;
-      workhorse[4*PHIPASIZE]=workhorse[0];
-      
-      
-      gsl_spline_init (workspline1, workhorsearr, workhorse, 4*PHIPASIZE+1);
+    trikernel.apply(resbuff[j],harmbuff[j]);
 
-      for (int k=0;k<4*PHIPASIZE;k++)
-      {
-	double angle = 2*M_PI/4/PHIPASIZE*k + TRIANGLE;
-	double ang;
-	if (angle < 2*M_PI) ang = angle;
-	else ang = angle - 2*M_PI;
-	workhorse[k]=gsl_spline_eval(workspline1,ang,workacc1);
-      }
-
-
-      gsl_fft_real_transform (workhorse,1 ,4*PHIPASIZE, real, work);
+  for (int j=0;j<PTASIZE;j++)
+    {
+      const double *workhorse=harmbuff[j];
       
       respv0 << ptarray[j] << "\t";
       respv0 << workhorse[0]/4/PHIPASIZE;
@@ -429,28 +354,13 @@ if(!FULL)
 
   
 
+#pragma omp parallel for
   for (int j=0;j<PTASIZE;j++)
-    {
-      for (int k=0;k<4*PHIPASIZE;k++)
-	workhorse[k]=CHbuff[j][k];
-      
-      workhorsearr[4*PHIPASIZE]=phiparray[0]+2*M_PI;
-      workhorse[4*PHIPASIZE]=workhorse[0];
-      
-      
-      gsl_spline_init (workspline1, workhorsearr, workhorse, 4*PHIPASIZE+1);
-
-      for (int k=0;k<4*PHIPASIZE;k++)
-      {
-	double angle = 2*M_PI/4/PHIPASIZE*k + TRIANGLE;
-	double ang;
-	if (angle < 2*M_PI) ang = angle;
-	else ang = angle - 2*M_PI;
-	workhorse[k]=gsl_spline_eval(workspline1,ang,workacc1);
-      }
+    trikernel.apply(CHbuff[j],harmbuff[j]);
 
-
-      gsl_fft_real_transform (workhorse,1 ,4*PHIPASIZE, real, work);
+  for (int j=0;j<PTASIZE;j++)
+    {
+      const double *workhorse=harmbuff[j];
       
       for (int k=0;k<4*PHIPASIZE;k++)
 	{
@@ -488,15 +398,6 @@ if(!FULL)
 
 
 
-
-  gsl_spline_free (workspline1);
-  gsl_interp_accel_free (workacc1);
-  
-
-  gsl_fft_halfcomplex_wavetable_free (hc);
-  gsl_fft_real_wavetable_free (real);
-  gsl_fft_real_workspace_free (work);
-
   
 }
 
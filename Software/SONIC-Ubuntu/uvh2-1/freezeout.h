@@ -0,0 +1,159 @@
+#ifndef FREEZEOUT_H
+#define FREEZEOUT_H
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+//
+// Binary freeze-out surface, written by vh2 with BINARYFO 1
+// (data/freezeout_bulk.bin) and read by the convert routines
+// (data/freezeout.bin) instead of the text file, unless the text file
+// is newer. The in-process chain (sonic.cpp) hands the same records
+// over in memory.
+//
+// The file is a foheader followed by records of 'fields' doubles,
+// one record per element of the surface. The first FO_FIELDS entries
+// of a record are, in this order:
+//
+// x [fm], y [fm], tau [fm], direction, u^x, u^y,
+// pi^xx/(e+p), pi^xy/(e+p), pi^yy/(e+p), Pi/(e+p), T [GeV]
+//
+// as in the lines of the text surface of the block freeze-out. Records
+// of the isochronous freeze-out (FREEZE 0, block=0) have direction 0;
+// each set of the text file is a run of records with the same tau.
+//
+enum {FO_X,FO_Y,FO_TAU,FO_DIR,FO_UX,FO_UY,FO_PIXX,FO_PIXY,FO_PIYY,FO_PIB,FO_T,FO_FIELDS};
+
+const char FO_MAGIC[8]={'V','H','2','F','O','U','T','\0'};
+const int FO_VERSION=1;
+
+struct foheader
+{
+  char magic[8];
+  int version;
+  int fields;   //doubles per record
+  int block;    //1 for the block freeze-out surface (blockfreeze)
+  int reserved;
+};
+
+//vh2 writes the block surface for every FREEZE but 0 (see diags.cpp),
+//the convert routines read it as such for FREEZE 2 and larger
+inline int writesBlockFO(int freeze) { return freeze!=0; }
+inline int readsBlockFO(int freeze) { return freeze>1; }
+
+inline foheader makeFOHeader(int block)
+{
+  foheader head;
+  memcpy(head.magic,FO_MAGIC,sizeof(head.magic));
+  head.version=FO_VERSION;
+  head.fields=FO_FIELDS;
+  head.block=block;
+  head.reserved=0;
+  return head;
+}
+
+//read-only view of a binary surface; the file is memory-mapped and
+//read into memory only if mmap is not available
+class fosurface
+{
+ public:
+  foheader head;
+  long int records;  //-1 if no surface is open
+
+  fosurface() : records(-1), base(NULL), length(0), mapped(false) {}
+  ~fosurface() { close(); }
+
+  //returns false if the file does not exist; aborts if it is not a surface
+  bool open(const char *name)
+  {
+    close();
+    int fd=::open(name,O_RDONLY);
+    if (fd<0)
+      return false;
+
+    struct stat st;
+    if ((fstat(fd,&st)!=0)||(st.st_size<(off_t)sizeof(foheader)))
+      {
+	printf("Error: %s is not a binary freeze-out surface\n",name);
+	exit(1);
+      }
+    length=st.st_size;
+    base=mmap(NULL,length,PROT_READ,MAP_PRIVATE,fd,0);
+    mapped=(base!=MAP_FAILED);
+    if (mapped)
+      madvise(base,length,MADV_SEQUENTIAL);
+    else
+      {
+	base=malloc(length);
+	size_t got=0;
+	while (got<length)
+	  {
+	    ssize_t n=read(fd,(char*)base+got,length-got);
+	    if (n<=0) break;
+	    got+=n;
+	  }
+	length=got;
+      }
+    ::close(fd);
+
+    memcpy(&head,base,sizeof(foheader));
+    if ((memcmp(head.magic,FO_MAGIC,sizeof(head.magic))!=0)||(head.version!=FO_VERSION)||(head.fields<FO_FIELDS))
+      {
+	printf("Error: %s is not a binary freeze-out surface (version %i)\n",name,FO_VERSION);
+	exit(1);
+      }
+    //a run that was cut short may have left an incomplete last record
+    records=(length-sizeof(foheader))/(head.fields*sizeof(double));
+    rec=(const double*)((const char*)base+sizeof(foheader));
+    return true;
+  }
+
+  //opens the binary surface name unless the text surface text is newer,
+  //a binary file left over from an earlier run is not used
+  bool openIfNewer(const char *name,const char *text)
+  {
+    struct stat sb,st;
+    if ((stat(name,&sb)==0)&&(stat(text,&st)==0)&&(sb.st_mtime<st.st_mtime))
+      {
+	printf("Ignoring %s, it is older than %s\n",name,text);
+	return false;
+      }
+    return open(name);
+  }
+
+  //view of n records held by the caller, who keeps them alive
+  void attach(const double *data,long int n,int block)
+  {
+    close();
+    head=makeFOHeader(block);
+    records=n;
+    rec=data;
+  }
+
+  void close()
+  {
+    if (base!=NULL)
+      {
+	if (mapped) munmap(base,length);
+	else free(base);
+      }
+    base=NULL;
+    length=0;
+    records=-1;
+  }
+
+  double field(long int i,int f) const { return rec[i*head.fields+f]; }
+
+ private:
+  const double *rec;
+  void *base;
+  size_t length;
+  bool mapped;
+};
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef HARMONICS_H
+#define HARMONICS_H
+
+#include <math.h>
+#include <gsl/gsl_spline.h>
+#include <gsl/gsl_fft_real.h>
+
+//
+// Fourier coefficients of a spectrum dN/dphi_p known at n angles
+// phi_0 < phi_1 < ... < phi_{n-1} < phi_0+2 pi, as computed by the
+// extract and prereso routines: a periodic cubic spline through the
+// points is evaluated at 2 pi k/n + shift (k=0..n-1, mapped back into
+// the period) and transformed with gsl_fft_real_transform.
+//
+// Every step is linear in the spectrum, so the map is tabulated once
+// from the n unit spectra; transforming one pt bin is then a single
+// matrix-vector product. apply() does not change the table and may be
+// called by several threads at once.
+//
+class harmonics
+{
+ public:
+  harmonics(const double *phi,int size,double shift=0) : n(size)
+  {
+    kernel=new double[n*n];
+
+    double *x=new double[n+1];
+    double *y=new double[n+1];
+    double *coef=new double[n];
+    for (int k=0;k<n;k++)
+      x[k]=phi[k];
+    x[n]=phi[0]+2*M_PI;
+
+    gsl_spline *spline=gsl_spline_alloc (gsl_interp_cspline_periodic, n+1);
+    gsl_interp_accel *acc=gsl_interp_accel_alloc ();
+    gsl_fft_real_wavetable *real=gsl_fft_real_wavetable_alloc (n);
+    gsl_fft_real_workspace *work=gsl_fft_real_workspace_alloc (n);
+
+    for (int i=0;i<n;i++)
+      {
+	for (int k=0;k<=n;k++)
+	  y[k]=0;
+	y[i]=1;
+	y[n]=y[0];
+	gsl_spline_init (spline,x,y,n+1);
+
+	for (int k=0;k<n;k++)
+	  {
+	    double xx=2*M_PI/n*k+shift;
+	    if (xx<x[0])
+	      xx+=2*M_PI;
+	    if (xx>=x[n])
+	      xx-=2*M_PI;
+	    coef[k]=gsl_spline_eval (spline,xx,acc);
+	  }
+	gsl_fft_real_transform (coef,1,n,real,work);
+
+	for (int m=0;m<n;m++)
+	  kernel[m*n+i]=coef[m];
+      }
+
+    gsl_fft_real_workspace_free (work);
+    gsl_fft_real_wavetable_free (real);
+    gsl_interp_accel_free (acc);
+    gsl_spline_free (spline);
+    delete [] x;
+    delete [] y;
+    delete [] coef;
+  }
+
+  ~harmonics() { delete [] kernel; }
+
+  //coef[0..n-1] in the halfcomplex order of gsl_fft_real_transform
+  void apply(const double *spec,double *coef) const
+  {
+    for (int m=0;m<n;m++)
+      {
+	const double *row=kernel+m*n;
+	double sum=0;
+	for (int k=0;k<n;k++)
+	  sum+=row[k]*spec[k];
+	coef[m]=sum;
+      }
+  }
+
+ private:
+  int n;
+  double *kernel;   //kernel[m*n+i]: coefficient m of the unit spectrum at phi_i
+
+  harmonics(const harmonics&);
+  harmonics& operator=(const harmonics&);
+};
+
+#endif
@@ -4,6 +4,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
+#include <string.h>
 #include <gsl/gsl_errno.h>
 #include <gsl/gsl_spline.h>
 #include <gsl/gsl_roots.h>
@@ -92,6 +93,8 @@ double *eoT4,*cs2i,*poT4,*Ti;
 double ***u,**e,**pixy,**pixx,**piyy,**pi;
 
 double **cyminp;
+//cyminp averaged over the four quadrants, see prepareCYM
+double **cymsym;
 
 double atuomas=Rnuc/125;
 double g2mua=0.43328;
@@ -118,6 +121,10 @@ double mypixt,mypiyt,mypitt,mypiee;
 // output files
 fstream cym,inited,initux,inituy,initpixx,initpixy,initpiyy,itime,initpi;
 
+//directory of the current event, with trailing /, empty for the
+//current directory (see main)
+char RUNDIR[255];
+
 //splines -- for fancy freeze-out
 gsl_interp_accel *wac;
 gsl_spline *workspline;
@@ -128,9 +135,21 @@ gsl_spline *pspline,*Tspline,*cs2spline;
 //to know where to stop interpolation
 double lowestE;
 
+//lattice size of the arrays allocated by allocateMemory, 0 if none
+int allocNUMT=0;
+
+void freeMemory();
+
 // initialize global arrays
+// (a batch of events keeps them as long as NUMT does not change)
 void allocateMemory() {
 
+ if (allocNUMT==NUMT)
+   return;
+ if (allocNUMT>0)
+   freeMemory();
+ allocNUMT=NUMT;
+
 cout << "==> Allocating memory\n";
 
 
@@ -175,16 +194,76 @@ cout << "==> Allocating memory\n";
   for (int i=0;i<500;i++) 
     cyminp[i] = new double[500];
 
+  cymsym = new double*[500];
+  for (int i=0;i<500;i++) 
+    cymsym[i] = new double[500];
+
+
+}
+
+void freeMemory()
+{
+  for (int i=0;i<2;i++)
+    {
+      for (int j=0;j<allocNUMT+2;j++)
+	delete [] u[i][j];
+      delete [] u[i];
+    }
+  delete [] u;
+
+  for (int i=0;i<allocNUMT+2;i++)
+    {
+      delete [] e[i];
+      delete [] pixy[i];
+      delete [] pixx[i];
+      delete [] piyy[i];
+      delete [] pi[i];
+    }
+  delete [] e;
+  delete [] pixy;
+  delete [] pixx;
+  delete [] piyy;
+  delete [] pi;
+
+  for (int i=0;i<500;i++)
+    {
+      delete [] cyminp[i];
+      delete [] cymsym[i];
+    }
+  delete [] cyminp;
+  delete [] cymsym;
 
+  allocNUMT=0;
 }
 
 
+//file of the equation of state in memory, see loadeos
+char loadedeos[512]="";
+
 void loadeos()
 {
   fstream eosf;
-  char eosfile[255];
+  char eosfile[512];
+
+  sprintf(eosfile,"%sinput/%s.dat",RUNDIR,EOSNAME);
 
-  sprintf(eosfile,"input/%s.dat",EOSNAME);
+  //the events of a batch mostly share the equation of state
+  if (strcmp(eosfile,loadedeos)==0)
+    return;
+  if (loadedeos[0]!='\0')
+    {
+      delete [] eoT4;
+      delete [] cs2i;
+      delete [] poT4;
+      delete [] Ti;
+      gsl_spline_free (pspline);
+      gsl_spline_free (Tspline);
+      gsl_spline_free (cs2spline);
+      gsl_interp_accel_free (pacc);
+      gsl_interp_accel_free (Tacc);
+      gsl_interp_accel_free (cs2acc);
+    }
+  strcpy(loadedeos,eosfile);
 
   printf("===> Info: Loading EOS file info from %s\n",eosfile);
   eosf.open(eosfile,ios::in);
@@ -264,13 +343,20 @@ double WS(double x, double y, double z)
   return 1/(1+exp(temp));
 }
 
-//transverse density T_A, in physical units
-//(x, y in fm)
-double TA(double x, double y)
+//transverse density T_A without the normalization TAnorm
+double TAraw(double x, double y)
 {
   double temp=0;
   for (int i=0;i<1200;i++)
     temp+=WS(x,y,(i+0.5)*Rnuc/400.)*Rnuc/400.;
+  return temp;
+}
+
+//transverse density T_A, in physical units
+//(x, y in fm)
+double TA(double x, double y)
+{
+  double temp=TAraw(x,y);
 
   //return result normalized
   return temp*TAnorm;
@@ -283,14 +369,54 @@ double TA(double x, double y)
 }
 
 
-//number density of wounded nucleons
-//from Kolb et. al, hep-ph/0103234
-double getwnuc(double xx,double yy,double b)
+//T_A/TAnorm at the lattice sites (sx-Middle,sy-Middle)*AT/fmtoGeV shifted
+//by 'shift' fm in x. The tables are kept between the events of a batch 
+//and only computed again if the nucleus, the lattice or the shift change.
+struct tatable
 {
-  
-  double mTAp=TA(xx+b/2.,yy);
-  double mTAm=TA(xx-b/2.,yy);
+  double **val;
+  int numt;
+  double shift,R,a,at;
+};
+
+tatable tacenter={NULL},taplus={NULL},taminus={NULL};
+
+double **thickness(tatable &tab,double shift)
+{
+  if ((tab.val!=NULL)&&(tab.numt==NUMT)&&(tab.shift==shift)&&(tab.R==Rnuc)&&(tab.a==anuc)&&(tab.at==AT))
+    return tab.val;
+
+  if ((tab.val!=NULL)&&(tab.numt!=NUMT))
+    {
+      for (int sx=0;sx<tab.numt+2;sx++)
+	delete [] tab.val[sx];
+      delete [] tab.val;
+      tab.val=NULL;
+    }
+  if (tab.val==NULL)
+    {
+      tab.val=new double*[NUMT+2];
+      for (int sx=0;sx<NUMT+2;sx++)
+	tab.val[sx]=new double[NUMT+2];
+    }
+
+#pragma omp parallel for schedule(static)
+  for (int sx=0;sx<=NUMT+1;sx++)
+    for (int sy=0;sy<=NUMT+1;sy++)
+      tab.val[sx][sy]=TAraw((sx-Middle)*AT/fmtoGeV+shift,(sy-Middle)*AT/fmtoGeV);
+
+  tab.numt=NUMT;
+  tab.shift=shift;
+  tab.R=Rnuc;
+  tab.a=anuc;
+  tab.at=AT;
+  return tab.val;
+}
 
+//number density of wounded nucleons for the thickness functions
+//of the two nuclei
+double wnucden(double mTAp,double mTAm)
+{
   //return mTA*2*(1.-pow(1-mTA/197.*4.,197.));
   double temp=0;
   temp+=mTAp*(1.-exp(-mTAm*sigmaNN*0.1));
@@ -298,21 +424,26 @@ double getwnuc(double xx,double yy,double b)
   return temp;
 }
 
+//number density of binary collisions for the thickness functions
+//of the two nuclei
+double binden(double mTAp,double mTAm)
+{
+  return 4*mTAp*mTAm;
+}
 
-//number density of binary collisions
+//number density of wounded nucleons
 //from Kolb et. al, hep-ph/0103234
-double getbin(double xx,double yy,double b)
+double getwnuc(double xx,double yy,double b)
 {
-  
-  double mTAp=TA(xx+b/2.,yy);
-  double mTAm=TA(xx-b/2.,yy);
+  return wnucden(TA(xx+b/2.,yy),TA(xx-b/2.,yy));
+}
 
-  //return mTA*2*(1.-pow(1-mTA/197.*4.,197.));
-  double temp=0;
-  
-  temp=4*mTAp*mTAm;
 
-  return temp;
+//number density of binary collisions
+//from Kolb et. al, hep-ph/0103234
+double getbin(double xx,double yy,double b)
+{
+  return binden(TA(xx+b/2.,yy),TA(xx-b/2.,yy));
 }
 
 double getscal(double ss)
@@ -338,10 +469,11 @@ double Nwounded(double b)
 {
   int DIVIDER=10;
   double temp=0;
-  for (double xx=-2*Rnuc;xx<2*Rnuc;xx+=Rnuc/DIVIDER)
-    for (double yy=-2*Rnuc;yy<2*Rnuc;yy+=Rnuc/DIVIDER)
+#pragma omp parallel for schedule(static) reduction(+:temp)
+  for (int ix=0;ix<4*DIVIDER;ix++)
+    for (int iy=0;iy<4*DIVIDER;iy++)
       {
-	temp+=getwnuc(xx,yy,b);
+	temp+=getwnuc(-2*Rnuc+ix*Rnuc/DIVIDER,-2*Rnuc+iy*Rnuc/DIVIDER,b);
       }
   return temp*Rnuc/DIVIDER*Rnuc/DIVIDER;
 }
@@ -350,10 +482,11 @@ double Ncoll(double b)
 {
   int DIVIDER=10;
   double temp=0;
-  for (double xx=-2*Rnuc;xx<2*Rnuc;xx+=Rnuc/DIVIDER)
-    for (double yy=-2*Rnuc;yy<2*Rnuc;yy+=Rnuc/DIVIDER)
+#pragma omp parallel for schedule(static) reduction(+:temp)
+  for (int ix=0;ix<4*DIVIDER;ix++)
+    for (int iy=0;iy<4*DIVIDER;iy++)
       {
-	temp+=getbin(xx,yy,b);
+	temp+=getbin(-2*Rnuc+ix*Rnuc/DIVIDER,-2*Rnuc+iy*Rnuc/DIVIDER,b);
       }
   return temp*Rnuc/DIVIDER*Rnuc/DIVIDER;
 }
@@ -404,6 +537,7 @@ void eps()
   double rn2snumeps21 = 0.0, rn2snumeps22 = 0.0;
   
   double avgx = 0.0, avgy = 0.0, norm = 0.0;
+#pragma omp parallel for schedule(static) reduction(+:avgx,avgy,norm)
   for (int sx=1;sx<=NUMT;sx++)
     for (int sy=1;sy<=NUMT;sy++)
       {
@@ -419,7 +553,15 @@ void eps()
 	//  entropy density weighting
   norm = 0.0;
   double savgx = 0.0, savgy = 0.0;
+  //the lattice is split among the threads, each with its own accelerators
+  //for the equation of state
   if(!PCE)
+  {
+#pragma omp parallel reduction(+:savgx,savgy,norm)
+  {
+  gsl_interp_accel *tpacc=gsl_interp_accel_alloc ();
+  gsl_interp_accel *tcs2acc=gsl_interp_accel_alloc ();
+#pragma omp for schedule(static)
   for (int sx=1;sx<=NUMT;sx++)
     for (int sy=1;sy<=NUMT;sy++)
       {
@@ -427,12 +569,12 @@ void eps()
 	double p, T;
 	if (e[sx][sy] >= lowestE)
 	{
-		p = AT*AT*AT*AT*gsl_spline_eval(pspline,e[sx][sy],pacc);
-		T = AT*gsl_spline_eval(Tspline,e[sx][sy],pacc);
+		p = AT*AT*AT*AT*gsl_spline_eval(pspline,e[sx][sy],tpacc);
+		T = AT*gsl_spline_eval(Tspline,e[sx][sy],tpacc);
 	}
 	else
 	{
-		p = AT*AT*AT*AT*e[sx][sy]*gsl_spline_eval(cs2spline,lowestE,cs2acc);
+		p = AT*AT*AT*AT*e[sx][sy]*gsl_spline_eval(cs2spline,lowestE,tcs2acc);
 		T = sqrtl(sqrtl(e[sx][sy]/eoT4[0]));
 	}
 	s = (e[sx][sy] + p)/T;
@@ -442,10 +584,31 @@ void eps()
 	savgy += y*s;
 	norm += s;
       }
+  gsl_interp_accel_free (tpacc);
+  gsl_interp_accel_free (tcs2acc);
+  }
+  }
   
   savgx /= norm;
   savgy /= norm;
   
+#pragma omp parallel reduction(+:num2,numeps21,numeps22,den,den3,den4,den5,den6,den7,den8,numeps31,\
+	numeps32,numeps41,numeps42,numeps51,numeps52,numeps61,numeps62,\
+	numeps71,numeps72,numeps11,numeps12,r2numeps31,r2numeps32,r2numeps41,\
+	r2numeps42,r2numeps51,r2numeps52,r2numeps61,r2numeps62,r2numeps71,\
+	r2numeps72,rn2numeps31,rn2numeps32,rn2numeps41,rn2numeps42,rn2numeps51,\
+	rn2numeps52,rn2numeps61,rn2numeps62,rn2numeps21,rn2numeps22,etot,snum2,\
+	snumeps21,snumeps22,sden,stot,sden3,sden4,sden5,sden6,sden7,sden8,\
+	snumeps31,snumeps32,snumeps41,snumeps42,snumeps51,snumeps52,snumeps61,\
+	snumeps62,snumeps71,snumeps72,snumeps11,snumeps12,r2snumeps31,\
+	r2snumeps32,r2snumeps41,r2snumeps42,r2snumeps51,r2snumeps52,\
+	r2snumeps61,r2snumeps62,r2snumeps71,r2snumeps72,rn2snumeps31,\
+	rn2snumeps32,rn2snumeps41,rn2snumeps42,rn2snumeps51,rn2snumeps52,\
+	rn2snumeps61,rn2snumeps62,rn2snumeps21,rn2snumeps22)
+  {
+  gsl_interp_accel *tpacc=gsl_interp_accel_alloc ();
+  gsl_interp_accel *tcs2acc=gsl_interp_accel_alloc ();
+#pragma omp for schedule(static)
   for (int sx=1;sx<=NUMT;sx++)
     for (int sy=1;sy<=NUMT;sy++)
       {
@@ -527,12 +690,12 @@ void eps()
 	if(!PCE)
 	if (e[sx][sy] >= lowestE)
 	{
-		p = AT*AT*AT*AT*gsl_spline_eval(pspline,e[sx][sy],pacc);
-		T = AT*gsl_spline_eval(Tspline,e[sx][sy],pacc);
+		p = AT*AT*AT*AT*gsl_spline_eval(pspline,e[sx][sy],tpacc);
+		T = AT*gsl_spline_eval(Tspline,e[sx][sy],tpacc);
 	}
 	else
 	{
-		p = AT*AT*AT*AT*e[sx][sy]*gsl_spline_eval(cs2spline,lowestE,cs2acc);
+		p = AT*AT*AT*AT*e[sx][sy]*gsl_spline_eval(cs2spline,lowestE,tcs2acc);
 		T = sqrtl(sqrtl(e[sx][sy]/eoT4[0]));
 	}
 	s = (e[sx][sy] + p)/T;
@@ -584,6 +747,9 @@ void eps()
 	rn2snumeps61 += r8*cos(6*phi)*s;
 	rn2snumeps62 += r8*sin(6*phi)*s;
       }
+  gsl_interp_accel_free (tpacc);
+  gsl_interp_accel_free (tcs2acc);
+  }
     cout << "Energy Density Weighting + r^n weighting:\n";
     cout << "average x = " << avgx << endl;
     cout << "average y = " << avgy << endl;
@@ -723,6 +889,8 @@ double overlapS()
 }
 
 
+double smoothcym1(int sx,int sy);
+
 //get Tuomas' results and smooth them
 void prepareCYM(double bb)
 {
@@ -778,7 +946,7 @@ void prepareCYM(double bb)
 
   sprintf(regu,"05");
 
-  char filenam[128];
+  char filenam[512];
 
   printf("Rnuc=%f\n",Rnuc);
 
@@ -787,63 +955,63 @@ void prepareCYM(double bb)
     case 0: 
       {
 	printf("Loading data for B=0*Rnuc\n");
-	sprintf(filenam,"CYM/b00L%s/%s",regu,buffer);
+	sprintf(filenam,"%sCYM/b00L%s/%s",RUNDIR,regu,buffer);
 	cym.open(filenam, ios::in);
 	break;
       }
     case 20: 
       {
 	printf("Loading data for B=2*Rnuc\n");
-	sprintf(filenam,"CYM/b02L%s/%s",regu,buffer);
+	sprintf(filenam,"%sCYM/b02L%s/%s",RUNDIR,regu,buffer);
 	cym.open(filenam, ios::in);
 	break;
       }
     case 40: 
       {
 	printf("Loading data for B=4*Rnuc\n");
-	sprintf(filenam,"CYM/b04L%s/%s",regu,buffer);
+	sprintf(filenam,"%sCYM/b04L%s/%s",RUNDIR,regu,buffer);
 	cym.open(filenam, ios::in);
 	break;
       }
     case 60: 
       {
 	printf("Loading data for B=6*Rnuc\n");
-	sprintf(filenam,"CYM/b06L%s/%s",regu,buffer);
+	sprintf(filenam,"%sCYM/b06L%s/%s",RUNDIR,regu,buffer);
 	cym.open(filenam, ios::in);
 	break;
       } 
     case 80: 
       {
 	printf("Loading data for B=8*Rnuc\n");
-	sprintf(filenam,"CYM/b08L%s/%s",regu,buffer);
+	sprintf(filenam,"%sCYM/b08L%s/%s",RUNDIR,regu,buffer);
 	cym.open(filenam, ios::in);	
 	break;
       }
     case 100: 
       {
 	printf("Loading data for B=10*Rnuc\n");
-	sprintf(filenam,"CYM/b10L%s/%s",regu,buffer);
+	sprintf(filenam,"%sCYM/b10L%s/%s",RUNDIR,regu,buffer);
 	cym.open(filenam, ios::in);	
 	break;
       }
     case 120: 
       {
 	printf("Loading data for B=12*Rnuc\n");
-	sprintf(filenam,"CYM/b12L%s/%s",regu,buffer);
+	sprintf(filenam,"%sCYM/b12L%s/%s",RUNDIR,regu,buffer);
 	cym.open(filenam, ios::in);	
 	break;
       }
     case 140: 
       {
 	printf("Loading data for B=14*Rnuc\n");
-	sprintf(filenam,"CYM/b14L%s/%s",regu,buffer);
+	sprintf(filenam,"%sCYM/b14L%s/%s",RUNDIR,regu,buffer);
 	cym.open(filenam, ios::in);	
 	break;
       }
     case 160: 
       {
 	printf("Loading data for B=16*Rnuc\n");
-	sprintf(filenam,"CYM/b16L%s/%s",regu,buffer);
+	sprintf(filenam,"%sCYM/b16L%s/%s",RUNDIR,regu,buffer);
 	cym.open(filenam, ios::in);	
 	break;
       }
@@ -866,6 +1034,13 @@ void prepareCYM(double bb)
 
   cym.close();
 
+  //smoothcym2 averages this over (2*SMOOTHNESS+1)^2 points for every
+  //corner of every lattice cell, so it is computed once here
+#pragma omp parallel for schedule(static)
+  for (int i=0;i<500;i++)
+    for (int j=0;j<500;j++)
+      cymsym[i][j]=smoothcym1(i,j);
+
 }
 
 double smoothcym1(int sx,int sy)
@@ -889,7 +1064,7 @@ double smoothcym2(int sx,int sy)
     for (int j=-SMOOTHNESS;j<=SMOOTHNESS;j++)
       {
 	if ((sx+i>=0)&&(sx+i<500)&&(sy+j>=0)&&(sy+j<500))
-	  temp+=smoothcym1(sx+i,sy+j);
+	  temp+=cymsym[sx+i][sy+j];
 	else
 	  {
 	    printf("Error in smoothing: out of bounds\n");
@@ -1015,6 +1190,7 @@ void cycleb()
       normcym/=4*atuomas*atuomas*atuomas*ttuomas;
 
 
+#pragma omp parallel for schedule(static)
       for (int sx=1;sx<=NUMT;sx++)
 	for (int sy=1;sy<=NUMT;sy++)
 	  {
@@ -1161,6 +1337,17 @@ void setInitialConditions()
   double b=B;
   double diluter=dilution()*2./3.;
   double ednormalizer=getbin(0,0,0);
+
+  //thickness functions of the two nuclei at the lattice sites
+  double **tap=NULL,**tam=NULL;
+  if ((IC==-1)||(IC==-21)||(IC==-2)||(IC==-22)||(IC>=0))
+    {
+      tap=thickness(taplus,b/2.);
+      tam=thickness(taminus,-b/2.);
+    }
+
+  //every cell is independent of the others
+#pragma omp parallel for schedule(static)
   for (int sx=0;sx<=NUMT+1;sx++)
     for (int sy=0;sy<=NUMT+1;sy++)
       {
@@ -1168,10 +1355,10 @@ void setInitialConditions()
 	  {
 	    //wounded nucleon scaling
 	    if (IC==-1 || IC==-21)
-	      e[sx][sy]=e0*getwnuc((sx-Middle)*AT/fmtoGeV,(sy-Middle)*AT/fmtoGeV,b)/4.29048;
+	      e[sx][sy]=e0*wnucden(tap[sx][sy]*TAnorm,tam[sx][sy]*TAnorm)/4.29048;
 	    //participant scaling
 	    if (IC==-2 || IC==-22)
-	      e[sx][sy]=e0*getbin((sx-Middle)*AT/fmtoGeV,(sy-Middle)*AT/fmtoGeV,b)/ednormalizer;
+	      e[sx][sy]=e0*binden(tap[sx][sy]*TAnorm,tam[sx][sy]*TAnorm)/ednormalizer;
 	    if (IC==-3)
 	      e[sx][sy]=normcym*getcym((sx-Middle)*AT/fmtoGeV,(sy-Middle)*AT/fmtoGeV);
 	    if (IC==-5)
@@ -1263,7 +1450,9 @@ void setInitialConditions()
 	  }
 	else
 	  {
-	    e[sx][sy]=getscal((getwnuc((sx-Middle)*AT/fmtoGeV,(sy-Middle)*AT/fmtoGeV,b)/4.29048*(1-IC)+getbin((sx-Middle)*AT/fmtoGeV,(sy-Middle)*AT/fmtoGeV,b)/18.4151*IC)*s0);
+	    double mTAp=tap[sx][sy]*TAnorm;
+	    double mTAm=tam[sx][sy]*TAnorm;
+	    e[sx][sy]=getscal((wnucden(mTAp,mTAm)/4.29048*(1-IC)+binden(mTAp,mTAm)/18.4151*IC)*s0);
 	  }
 	
 	
@@ -1283,7 +1472,10 @@ void setInitialConditions()
   cout << "ecc" << aniso() << endl;
   cout << "dilution" << dilution() << endl;
 
-  wac=gsl_interp_accel_alloc (); 
+  if (wac==NULL)
+    wac=gsl_interp_accel_alloc (); 
+  if (workspline!=NULL)
+    gsl_spline_free (workspline);
   workspline=gsl_spline_alloc (gsl_interp_cspline, Middle);
   
  
@@ -1357,12 +1549,16 @@ void outputed()
 }
 
 
-int main() 
+//generates the initial conditions of the event in RUNDIR: the energy
+//density e and the flow u on the lattice
+void makeevent() 
 {
   
   extern void readParameters(const char*);
   
-  readParameters("data/params.txt");  
+  char filename[512];
+  sprintf(filename,"%sdata/params.txt",RUNDIR);
+  readParameters(filename);  
 
   //set parameters
   Rnuc=RNUC;
@@ -1373,15 +1569,16 @@ int main()
   Middle=(NUMT-1)/2+1;
 
   double mytest=0;
+  double **ta=thickness(tacenter,0);
 
   for (int sx=1;sx<=NUMT;sx++)
     for (int sy=1;sy<=NUMT;sy++)
-      mytest+=TA((sx-Middle)*AT/fmtoGeV,(sy-Middle)*AT/fmtoGeV);
+      mytest+=ta[sx][sy];
 
   for (int sy=1;sy<=NUMT;sy++)
     {
-      mytest-=TA((1-Middle)*AT/fmtoGeV,(sy-Middle)*AT/fmtoGeV);
-      mytest-=TA((NUMT-Middle)*AT/fmtoGeV,(sy-Middle)*AT/fmtoGeV);
+      mytest-=ta[1][sy];
+      mytest-=ta[NUMT][sy];
     }
 
   TAnorm=TANORM/(mytest*(AT/fmtoGeV)*(AT/fmtoGeV));
@@ -1410,19 +1607,32 @@ int main()
   eps();
   }
   
-  itime.open("input/time.dat",ios::out);
-  inited.open("input/inited.dat", ios::out);
-  initux.open("input/initux.dat", ios::out);
-  inituy.open("input/inituy.dat", ios::out);
-  initpixx.open("input/initpixx.dat", ios::out);
-  initpixy.open("input/initpixy.dat", ios::out);
-  initpiyy.open("input/initpiyy.dat", ios::out);
-  initpi.open("input/initpi.dat", ios::out);
-  
   //regulateed();
 
   getvs();
+}
 
+//writes the event generated by makeevent to RUNDIR/input/, as read by vh2
+void writeevent() 
+{
+  char filename[512];
+  sprintf(filename,"%sinput/time.dat",RUNDIR);
+  itime.open(filename,ios::out);
+  sprintf(filename,"%sinput/inited.dat",RUNDIR);
+  inited.open(filename,ios::out);
+  sprintf(filename,"%sinput/initux.dat",RUNDIR);
+  initux.open(filename,ios::out);
+  sprintf(filename,"%sinput/inituy.dat",RUNDIR);
+  inituy.open(filename,ios::out);
+  sprintf(filename,"%sinput/initpixx.dat",RUNDIR);
+  initpixx.open(filename,ios::out);
+  sprintf(filename,"%sinput/initpixy.dat",RUNDIR);
+  initpixy.open(filename,ios::out);
+  sprintf(filename,"%sinput/initpiyy.dat",RUNDIR);
+  initpiyy.open(filename,ios::out);
+  sprintf(filename,"%sinput/initpi.dat",RUNDIR);
+  initpi.open(filename,ios::out);
+  
   outputed();
 
   itime << TINIT << endl;
@@ -1441,6 +1651,34 @@ int main()
 
   //if necessary, show system vh2 is done
   //int stat=system("cp data/params.txt logdir/initE-is-done.log");
+}
+
+void initevent() 
+{
+  makeevent();
+  writeevent();
+}
+
+//without arguments the event of the current directory is generated;
+//'initE run1 run2 ...' generates the events of the given run directories
+//one after the other (each with its own data/params.txt and input/),
+//reusing the lattices and, where the parameters allow, the thickness functions
+int main(int argc, char *argv[]) 
+{
+  RUNDIR[0]='\0';
+  if (argc<2)
+    {
+      initevent();
+      return 0;
+    }
+
+  printf("===> Info: generating %i events\n",argc-1);
+  for (int i=1;i<argc;i++)
+    {
+      snprintf(RUNDIR,sizeof(RUNDIR),"%s/",argv[i]);
+      printf("===> Info: event in %s\n",argv[i]);
+      initevent();
+    }
 
   return 0;
 }
@@ -0,0 +1,50 @@
+#ifndef PARAMFILE_H
+#define PARAMFILE_H
+
+#include <fstream>
+#include <cstring>
+#include <string>
+
+//
+// Reads the next key/value pair from a parameter file.
+// Paramters are in a text file with each parameter on a new line
+// in the format 
+//
+// PARAMKEY	PARAMVALUE
+//
+// The PARAMKEY must begin the line and only tabs and spaces
+// can appear between the PARAMKEY and PARAMVALUE.
+// 
+// Lines which begin with 'commentmarker' defined below are ignored.
+// key and value must hold 32 chars; returns false at the end of the file.
+//
+inline bool nextParameter(std::ifstream &paramFile, char *key, char *value) {
+		
+	std::string commentmarker = "//"; 
+	char space = ' '; 
+	char tab = '\t';
+
+	const int maxline = 128; // maximum line length used in the buffer for reading
+	char buffer[maxline];
+	
+	while(!paramFile.eof()) {
+		paramFile.getline(buffer,maxline,'\n');
+		std::string line = buffer; int length = strlen(buffer);
+		if (line.substr(0,commentmarker.length())!=commentmarker && line.length()>0) {
+			memset(key,0,32); memset(value,0,32); int founddelim=0;
+			for (int i=0;i<length;i++) {
+				if (buffer[i]==space || buffer[i]==tab) founddelim=1;
+				else {
+					if (founddelim==0) key[strlen(key)] = buffer[i];
+					else value[strlen(value)] = buffer[i];
+				}
+			}
+			if (strlen(key)>0 && strlen(value)>0) 
+				return true;
+		}
+	}
+	
+	return false;	
+}
+
+#endif
@@ -2,11 +2,12 @@
 #include <iostream>
 #include <cstring>
 #include <stdlib.h>
+#include "paramfile.h"
 
 
 // external vars defined in UVH2+1.cpp which are loaded here
-extern int    NUMT,UPDATE,SNAPUPDATE;
-extern long int STEPS;
+extern int    NUMT;
+extern long int STEPS,UPDATE,SNAPUPDATE;
 extern double AT,EPS,TINIT,ETAOS,TF,TSTART,COEFF;
 extern double B,L1COEF,L2COEF;
 extern double IC;
@@ -93,44 +94,17 @@ void setParameter(char *key, char *value) {
 
 //
 // This routine assumes that paramters are in text file with
-// each parameter on a new line in the format 
-//
-// PARAMKEY	PARAMVALUE
-//
-// The PARAMKEY must begin the line and only tabs and spaces
-// can appear between the PARAMKEY and PARAMVALUE.
-// 
-// Lines which begin with 'commentmarker' defined below are ignored
+// each parameter on a new line, see nextParameter in paramfile.h
 //
 void readParameters(const char *filename) {
 		
-	string commentmarker = "//"; 
-	char space = ' '; 
-	char tab = '\t';
-
-	int maxline = 128; // maximum line length used in the buffer for reading
-	char buffer[maxline];
 	ifstream paramFile(filename);
+	char key[32],value[32];
 	
-	while(!paramFile.eof()) {
-		paramFile.getline(buffer,maxline,'\n');
-		string line = buffer; int length = strlen(buffer);
-		if (line.substr(0,commentmarker.length())!=commentmarker && line.length()>0) {
-			char key[32]="",value[32]=""; int founddelim=0;
-			for (int i=0;i<length;i++) {
-				if (buffer[i]==space || buffer[i]==tab) founddelim=1;
-				else {
-					if (founddelim==0) key[strlen(key)] = buffer[i];
-					else value[strlen(value)] = buffer[i];
-				}
-			}
-			if (strlen(key)>0 && strlen(value)>0) {
-				setParameter(key,value);
-				cout << key << " = " << value << endl;
-			}
-		}
+	while(nextParameter(paramFile,key,value)) {
+		setParameter(key,value);
+		cout << key << " = " << value << endl;
 	}
 	
 	return;	
 }
-
@@ -13,6 +13,7 @@
 #include <gsl/gsl_integration.h>
 #include <gsl/gsl_sf_bessel.h>
 #include <gsl/gsl_multifit.h>
+#include "harmonics.h"
 
 // #include	"reso.h"
 // #include	"functions.h"
@@ -63,15 +64,8 @@ int main()
   double weightbuff[PHIPASIZE];
   double CHbuff[PTASIZE][4*PHIPASIZE];
 
-  double workhorsearr[4*PHIPASIZE+1];
-  double workhorse[4*PHIPASIZE+1];
-
-  gsl_fft_real_wavetable * real;
-  gsl_fft_halfcomplex_wavetable * hc;
-  gsl_fft_real_workspace * work;
-
-  gsl_spline * workspline1=gsl_spline_alloc (gsl_interp_cspline_periodic, 4*PHIPASIZE+1);
-  gsl_interp_accel * workacc1=gsl_interp_accel_alloc ();
+  double phinodes[4*PHIPASIZE];
+  double harmbuff[PTASIZE][4*PHIPASIZE];
   
   switch (PHIPASIZE) {
   case 2:
@@ -146,6 +140,17 @@ int main()
   
   cout << "phipbuff[0] = " << phipbuff[0] << endl;
   cout << "phipbuff[PHIPASIZE-1] = " << phipbuff[PHIPASIZE-1] << endl;
+
+  //angles of the spectra mirrored into the full period (see below)
+  for (int k=0;k<PHIPASIZE;k++)
+    {
+      phinodes[k]=phipbuff[k];
+      phinodes[2*PHIPASIZE-k-1]=M_PI-phipbuff[k];
+      phinodes[2*PHIPASIZE+k]=M_PI+phipbuff[k];
+      phinodes[4*PHIPASIZE-k-1]=-phipbuff[k]+2*M_PI;
+    }
+  //spline+FFT of the spectra, tabulated once for all species
+  harmonics phikernel(phinodes,4*PHIPASIZE);
   
   
   massfile.open("pasim.dat", ios::in);
@@ -171,12 +176,12 @@ int main()
 	      for (int j=0;j<PTASIZE;j++)
 		{
 		  pttab >> resbuff[j][k];
-		  workhorsearr[k]=phipbuff[k];
 		  CHbuff[j][k]=resbuff[j][k];
 		}
 // 	      pttab << "\n";
 	    }
 	      int j=0;
+	      int output=1;
 // 	      cout << "i = " << particle << endl;
 	      switch (particle) 
 	      {
@@ -199,6 +204,7 @@ int main()
 		  v4file.open("data/results/preresopsv4.dat", ios::out);
 		  break;
 		default:
+		  output=0;
 		  v0file.open("/dev/null", ios::out);
 		  v2file.open("/dev/null", ios::out);
 		  v4file.open("/dev/null", ios::out);
@@ -209,7 +215,6 @@ int main()
 		for(int k=0;k<PHIPASIZE;k++)
 		  {
 		    ptbuff[j]=pt;
-		    workhorsearr[4*PHIPASIZE-k-1]=-phipbuff[k]+2*M_PI;
 		    resbuff[j][4*PHIPASIZE-k-1]=resbuff[j][k];
 		  }
 		j++;
@@ -217,50 +222,19 @@ int main()
 	    for (int j=0;j<PTASIZE;j++)
 	      for (int k=0;k<PHIPASIZE;k++)
 	      {
-		workhorsearr[2*PHIPASIZE-k-1]=M_PI-phipbuff[k];
 		resbuff[j][2*PHIPASIZE-k-1]=resbuff[j][k];
 		resbuff[j][2*PHIPASIZE+k]=resbuff[j][4*PHIPASIZE-k-1];
-		workhorsearr[2*PHIPASIZE+k]=M_PI+phipbuff[k];
 	      }
-	    work = gsl_fft_real_workspace_alloc (4*PHIPASIZE);
-	    real = gsl_fft_real_wavetable_alloc (4*PHIPASIZE);
-	    hc = gsl_fft_halfcomplex_wavetable_alloc (4*PHIPASIZE);   
+
+	    //species without output file are not transformed
+	    int nrows=output ? PTASIZE : 0;
+#pragma omp parallel for
+	    for (int j=0;j<nrows;j++)
+	      phikernel.apply(resbuff[j],harmbuff[j]);
 	    
-	    for (int j=0;j<PTASIZE;j++)
+	    for (int j=0;j<nrows;j++)
 	    {
-	      for (int k=0;k<4*PHIPASIZE;k++)
-		{
-		  //workhorse[k]=10*cos(2*(2*M_PI/4/PHIPASIZE*k-M_PI));
-		  //workhorse[k]=10;
-		  //workhorsearr[k]=2*M_PI/4/PHIPASIZE*k-M_PI;
-		  workhorse[k]=resbuff[j][k];
-		}
-
-      
-	      workhorsearr[4*PHIPASIZE]=phipbuff[0]+2*M_PI;
-	      workhorse[4*PHIPASIZE]=workhorse[0];
-      
-      
-	      gsl_spline_init (workspline1, workhorsearr, workhorse, 4*PHIPASIZE+1);
-
-	      if (j==0)
-	      for (int k=0;k<4*PHIPASIZE;k++)
-		{
-		  //printf("{%f,%f},",workhorsearr[k],workhorse[k]);
-		  //printf("{%f,%f},",workhorsearr[k],gsl_spline_eval(workspline1,workhorsearr[k],workacc1));
-		}
-
-	      for (int k=0;k<4*PHIPASIZE;k++)
-		{
-		  workhorse[k]=gsl_spline_eval(workspline1,2*M_PI/4/PHIPASIZE*k,workacc1);
-		  if (j==0)
-		  {
-		    //printf("%f wh %f\n",2*M_PI/4/PHIPASIZE*k-M_PI,workhorse[k]);
-		    //printf("{%f,%f},",2*M_PI/4/PHIPASIZE*k,workhorse[k]);
-		  }
-		}
-	      //printf("pt %f wh %f\n",ptbuff[j],workhorse[0]);
-	      gsl_fft_real_transform (workhorse,1 ,4*PHIPASIZE, real, work);
+	      const double *workhorse=harmbuff[j];
 	    
 	      v0file << ptbuff[j] << "\t";
 	      v0file << workhorse[0]/4/PHIPASIZE;
@@ -13,6 +13,7 @@
 #include <gsl/gsl_integration.h>
 #include <gsl/gsl_sf_bessel.h>
 #include <gsl/gsl_multifit.h>
+#include "harmonics.h"
 
 // #include	"reso.h"
 // #include	"functions.h"
@@ -73,19 +74,13 @@ int main()
   double weightbuff[PHIPASIZE];
   double CHbuff[PTASIZE][4*PHIPASIZE];
 
-  double workhorsearr[4*PHIPASIZE+1];
-  double workhorse[4*PHIPASIZE+1];
+  double harmbuff[PTASIZE][4*PHIPASIZE];
 //   double workhorseangle[4*PHIPASIZE+1];
 //   double workhorsequadangle[4*PHIPASIZE+1];
 
-  gsl_fft_real_wavetable * real;
-  gsl_fft_halfcomplex_wavetable * hc;
-  gsl_fft_real_workspace * work;
-
-  gsl_spline * workspline1=gsl_spline_alloc (gsl_interp_cspline_periodic, 4*PHIPASIZE+1);
-  gsl_interp_accel * workacc1=gsl_interp_accel_alloc ();
-
   for (int k=0;k<4*PHIPASIZE;k++) phipbuff[k] = k*M_PI/2/PHIPASIZE;
+  //spline+FFT of the spectra, tabulated once for all species
+  harmonics phikernel(phipbuff,4*PHIPASIZE);
   
   cout << "phipbuff[0] = " << phipbuff[0] << endl;
   cout << "phipbuff[PHIPASIZE-1] = " << phipbuff[PHIPASIZE-1] << endl;
@@ -118,12 +113,12 @@ int main()
 		    pttab >> resbuff[j][k];
 		  }
 // 		  if (k<PHIPASIZE) workhorsearr[k]=phipbuff[k];
-		  workhorsearr[k]=phipbuff[k];
 //		  CHbuff[j][k]=resbuff[j][k];
 		}
 // 	      pttab << "\n";
 	    }
 	      int j=0;
+	      int output=1;
 // 	      cout << "i = " << particle << endl;
 	      switch (particle) 
 	      {
@@ -152,6 +147,7 @@ int main()
 // 		  vsinfile.open("data/results/preresopsvsin.dat", ios::out);
 		  break;
 		default:
+		  output=0;
 		  v0file.open("/dev/null", ios::out);
 		  v2file.open("/dev/null", ios::out);
 		  v4file.open("/dev/null", ios::out);
@@ -184,57 +180,15 @@ int main()
 // 		    workhorsearr[2*PHIPASIZE+k]=M_PI+phipbuff[k];
 		  }
 	      }
-	    work = gsl_fft_real_workspace_alloc (4*PHIPASIZE);
-	    real = gsl_fft_real_wavetable_alloc (4*PHIPASIZE);
-	    hc = gsl_fft_halfcomplex_wavetable_alloc (4*PHIPASIZE);   
+	    //species without output file are not transformed
+	    int nrows=output ? PTASIZE : 0;
+#pragma omp parallel for
+	    for (int j=0;j<nrows;j++)
+	      phikernel.apply(resbuff[j],harmbuff[j]);
 	    
-	    for (int j=0;j<PTASIZE;j++)
+	    for (int j=0;j<nrows;j++)
 	    {
-	      for (int k=0;k<4*PHIPASIZE;k++)
-		{
-		  //workhorse[k]=10*cos(2*(2*M_PI/4/PHIPASIZE*k-M_PI));
-		  //workhorse[k]=10;
-		  //workhorsearr[k]=2*M_PI/4/PHIPASIZE*k-M_PI;
-		  workhorse[k]=resbuff[j][k];
-		}
-
-      
-	      workhorsearr[4*PHIPASIZE]=phipbuff[0]+2*M_PI;
-	      workhorse[4*PHIPASIZE]=workhorse[0];
-      
-      
-	      gsl_spline_init (workspline1, workhorsearr, workhorse, 4*PHIPASIZE+1);
-
-	      if (j==0)
-	      for (int k=0;k<4*PHIPASIZE;k++)
-		{
-		  //printf("{%f,%f},",workhorsearr[k],workhorse[k]);
-		  //printf("{%f,%f},",workhorsearr[k],gsl_spline_eval(workspline1,workhorsearr[k],workacc1));
-		}
-
-	      for (int k=0;k<4*PHIPASIZE;k++)
-		{
-// 		  double angle = 2*M_PI/4/PHIPASIZE*k + TRIANGLE;
-// 		  double ang;
-// 		  if (angle < 2*M_PI) ang = angle;
-// 		  else ang = angle - 2*M_PI;
-// 		  double angle4 = 2*M_PI/4/PHIPASIZE*k + QUADANGLE;
-// 		  double ang4;
-// 		  if (angle4 < 2*M_PI) ang4 = angle4;
-// 		  else ang4 = angle4 - 2*M_PI;
-		  workhorse[k]=gsl_spline_eval(workspline1,2*M_PI/4/PHIPASIZE*k,workacc1);
-// 		  workhorseangle[k]=gsl_spline_eval(workspline1,ang,workacc1);
-// 		  workhorsequadangle[k]=gsl_spline_eval(workspline1,ang4,workacc1);
-		  if (j==0)
-		  {
-		    //printf("%f wh %f\n",2*M_PI/4/PHIPASIZE*k-M_PI,workhorse[k]);
-		    //printf("{%f,%f},",2*M_PI/4/PHIPASIZE*k,workhorse[k]);
-		  }
-		}
-	      //printf("pt %f wh %f\n",ptbuff[j],workhorse[0]);
-	      gsl_fft_real_transform (workhorse,1 ,4*PHIPASIZE, real, work);
-// 	      gsl_fft_real_transform (workhorseangle,1 ,4*PHIPASIZE, real, work);
-// 	      gsl_fft_real_transform (workhorsequadangle,1 ,4*PHIPASIZE, real, work);
+	      const double *workhorse=harmbuff[j];
 	    
 	      v0file << ptbuff[j] << "\t";
 	      v0file << workhorse[0]/4/PHIPASIZE;
@@ -0,0 +1,153 @@
+//
+// In-process SONIC chain: initial conditions (initE), hydro (vh2) and
+// Cooper-Frye (convert) for one event after the other, without the
+// intermediate files under input/ and data/.
+//
+// usage: sonic [rundir1 rundir2 ...]
+// without arguments the event of the current directory is run.
+// Every run directory is set up as for the single programs (data/params.txt,
+// input/ with the tables, pasim.dat etc.); data/phipspectra.dat and
+// data/ptarr.dat are written as by convert. The initial conditions are
+// handed to vh2 at full precision and the freeze-out surface (FREEZE 0
+// or 2) goes to convert as binary records in memory. With KEEPFILES 1
+// the input/*.dat and data/freezeout_bulk.* files are written as well,
+// KEEPFILES 0 also turns off the vh2 snapshots.
+//
+// The programs are compiled into this file, each in its own namespace,
+// so their global variables do not clash; the headers they share are
+// included here first.
+//
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <omp.h>
+#include <gsl/gsl_errno.h>
+#include <gsl/gsl_fft_real.h>
+#include <gsl/gsl_fft_halfcomplex.h>
+#include <gsl/gsl_spline.h>
+#include <gsl/gsl_roots.h>
+#include <gsl/gsl_integration.h>
+#include <gsl/gsl_sf_bessel.h>
+#include <gsl/gsl_multifit.h>
+#include "paramfile.h"
+#include "freezeout.h"
+
+namespace icstage
+{
+#include "paramreader.cpp"
+#include "initE.cpp"
+}
+
+namespace hydrostage
+{
+#include "UVH2+1.cpp"
+}
+
+namespace cfstage
+{
+#include "paramreader.cpp"
+#include "convert.cpp"
+}
+
+//runs the event of the current directory; returns 0 on success and
+//the status of vh2 otherwise
+int sonicevent()
+{
+  icstage::RUNDIR[0]='\0';
+  icstage::makeevent();
+
+  //lattice of initE without the boundary cells, as in input/inited.dat
+  hydrostage::hydroinit init;
+  int numt=icstage::NUMT;
+  init.numt=numt;
+  init.tinit=icstage::TINIT;
+  init.e.resize(numt*numt);
+  init.ux.resize(numt*numt);
+  init.uy.resize(numt*numt);
+  for (int sx=1;sx<=numt;sx++)
+    for (int sy=1;sy<=numt;sy++)
+      {
+	int pos=(sx-1)*numt+sy-1;
+	init.e[pos]=icstage::e[sx][sy];
+	init.ux[pos]=icstage::u[0][sx][sy];
+	init.uy[pos]=icstage::u[1][sx][sy];
+      }
+
+  std::vector<double> surface;
+  int status,keepfiles,freeze,binaryfo;
+  {
+    hydrostage::vh2solver hydro;
+    hydro.initial=&init;
+    hydro.fosink=&surface;
+    status=hydro.run();
+    keepfiles=hydro.KEEPFILES;
+    freeze=hydro.FREEZE;
+    binaryfo=hydro.BINARYFO;
+  }
+
+  if (keepfiles)
+    icstage::writeevent();
+
+  if (status!=0)
+    return status;
+
+  if (writesBlockFO(freeze)!=readsBlockFO(freeze))
+    {
+      //convert reads the surface as data/freezeout.bin or data/freezeout.dat
+      const char *written=binaryfo ? "data/freezeout_bulk.bin" : "data/freezeout_bulk.dat";
+      printf("===> Info: no Cooper-Frye for FREEZE %i, run convert on %s\n",freeze,written);
+      return 0;
+    }
+  if (surface.empty())
+    {
+      printf("===> Info: the event did not freeze out, no Cooper-Frye\n");
+      return 0;
+    }
+
+  cfstage::fosurf.attach(&surface[0],surface.size()/FO_FIELDS,writesBlockFO(freeze));
+  cfstage::main();
+  return 0;
+}
+
+int main(int argc, char *argv[])
+{
+  if (argc<2)
+    return sonicevent();
+
+  char home[1024];
+  if (getcwd(home,sizeof(home))==NULL)
+    {
+      printf("Error: cannot determine the current directory\n");
+      return 1;
+    }
+
+  int status=0;
+  printf("===> Info: running %i events\n",argc-1);
+  for (int i=1;i<argc;i++)
+    {
+      printf("===> Info: event in %s\n",argv[i]);
+      //all stages open their files relative to the run directory
+      if ((chdir(home)!=0)||(chdir(argv[i])!=0))
+	{
+	  printf("Error: cannot change to %s\n",argv[i]);
+	  status=1;
+	  continue;
+	}
+      int result=sonicevent();
+      if (result!=0)
+	{
+	  printf("SONIC chain failed for %s\n",argv[i]);
+	  status=result;
+	}
+    }
+
+  return status;
+}